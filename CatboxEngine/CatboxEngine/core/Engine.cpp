@@ -16,6 +16,10 @@
 #include "Time.h"
 #include "../graphics/MeshManager.h"
 #include "../graphics/LightManager.h"
+#include "../graphics/GraphicsSettings.h"
+#include "../graphics/TextureCooker.h"
+#include "../graphics/TextureManager.h"
+#include "../graphics/TerrainManager.h"
 #include "../resources/SceneManager.h"
 
 static constexpr const char* k_autosaveDir  = "F:\\EngineSpecialization\\CatBoxEngine\\CatboxEngine\\CatboxEngine\\Scenes";
@@ -113,16 +117,66 @@ void Engine::app()
     while (!glfwWindowShouldClose(m_window))
     {
         Time::Update();
+        float deltaTime = Time::DeltaTime();
 
-        Update(Time::DeltaTime());
-        Render();
+        // Switching modes: the thread hands the context back when it stops
+        bool threaded = GraphicsSettings::Instance().ThreadedRendering;
+        if (threaded && !m_renderThread.IsRunning())
+            m_renderThread.Start(m_window, [this]() { RenderSnapshot(m_snapshots[m_snapshotIndex]); });
+        else if (!threaded && m_renderThread.IsRunning())
+            m_renderThread.Stop();
+
+        if (!threaded)
+        {
+            Update(deltaTime);
+            Render();
+            continue;
+        }
+
+        // Simulate while the previous frame is drawn
+        UpdateSimulation(deltaTime);
+
+        // UI, uploads and picking need the context: wait for it
+        m_renderThread.WaitIdle();
+        UpdateEditor(deltaTime);
+
+        // Copy out what the renderer reads into the snapshot it is not using.
+        // Overwriting it destroys last frame's copies, whose GL objects must
+        // be deleted on the thread holding the context, so this waits too.
+        FrameSnapshot& next = m_snapshots[m_snapshotIndex ^ 1];
+        next.Entities = m_entityManager;
+        glfwGetFramebufferSize(m_window, &next.DisplayWidth, &next.DisplayHeight);
+        if (next.DisplayHeight > 0)
+            m_camera.Aspect = (float)next.DisplayWidth / (float)next.DisplayHeight;
+        next.View = m_camera;  // After the aspect, or a resize draws one stretched frame
+        next.PlayMode = m_isPlayMode;
+        ImGui::Render();
+        next.CaptureUI(ImGui::GetDrawData());
+
+        m_snapshotIndex ^= 1;
+        m_renderThread.Submit();
     }
+
+    // Cleanup and the GL objects' destructors run here, with the context
+    m_renderThread.Stop();
+    // Not Clear(): snapshot copies hold no mesh references to release
+    for (FrameSnapshot& frame : m_snapshots)
+        frame.Entities = EntityManager();
+
+    // Textures still waiting to be cooked are cooked on their next load
+    TextureCooker::Instance().Shutdown();
     
     std::cout << "Final memory state:" << std::endl;
     MemoryTracker::Instance().PrintMemoryReport();
 }
 
 void Engine::Update(float deltaTime)
+{
+    UpdateSimulation(deltaTime);
+    UpdateEditor(deltaTime);
+}
+
+void Engine::UpdateSimulation(float deltaTime)
 {
     GLFWwindow* window = GetWindow();
 
@@ -177,16 +231,22 @@ void Engine::Update(float deltaTime)
     {
         m_camera.Update(window, deltaTime);
     }
+}
+
+void Engine::UpdateEditor(float deltaTime)
+{
+    GLFWwindow* window = GetWindow();
 
     glfwPollEvents();
 
-    // UI frame and draw
+    // UI frame and draw. The render thread is idle here, so its stats are
+    // safe to read.
     bool prevPlayMode = m_isPlayMode;
     m_uiManager.NewFrame();
     m_uiManager.Draw(m_entityManager, m_spawnPosition, m_spawnScale, deltaTime,
                      m_selectedEntityIndex, m_camera, m_useSharedCube,
                      &m_playerController, m_isPlayMode, m_goalSystem.IsGoalReached(),
-                     &m_recordSystem);
+                     &m_recordSystem, &m_renderPipeline.GetStats());
 
     // React to play mode toggle from the Stop/Play toolbar button
     if (!prevPlayMode && m_isPlayMode)
@@ -220,29 +280,39 @@ void Engine::Update(float deltaTime)
 
 void Engine::Render()
 {
-    GLFWwindow* window = GetWindow();
     int display_w, display_h;
-    glfwGetFramebufferSize(window, &display_w, &display_h);
-    
+    glfwGetFramebufferSize(GetWindow(), &display_w, &display_h);
+
+    // Render ImGui first (so it's on top)
+    ImGui::Render();
+
+    DrawFrame(m_entityManager, m_camera, display_w, display_h, m_isPlayMode, ImGui::GetDrawData());
+}
+
+void Engine::RenderSnapshot(FrameSnapshot& frame)
+{
+    DrawFrame(frame.Entities, frame.View, frame.DisplayWidth, frame.DisplayHeight, frame.PlayMode, &frame.UI);
+}
+
+void Engine::DrawFrame(EntityManager& entities, Camera& camera, int displayWidth, int displayHeight,
+                       bool playMode, ImDrawData* ui)
+{
     // Clear screen
-    glViewport(0, 0, display_w, display_h);
+    glViewport(0, 0, displayWidth, displayHeight);
     glClearColor(0.4f, 0.3f, 0.2f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Render ImGui first (so it's on top)
-    ImGui::Render();
-    
-    // Render scene using RenderPipeline
-    m_renderPipeline.Render(m_entityManager, m_camera, display_w, display_h);
+    // Patrol waypoint overlay only while in the editor
+    if (!playMode)
+        m_renderPipeline.QueueWaypointOverlay(entities);
 
-    // Draw patrol waypoint overlay only while in the editor
-    if (!m_isPlayMode)
-        m_renderPipeline.RenderWaypointOverlay(m_entityManager, m_camera, display_w, display_h);
+    // Render scene using RenderPipeline
+    m_renderPipeline.Render(entities, camera, displayWidth, displayHeight);
 
     // Render UI
-    m_uiManager.Render();
+    m_uiManager.Render(ui);
 
-    glfwSwapBuffers(window);
+    glfwSwapBuffers(GetWindow());
 }
 
 int Engine::Initialize()
@@ -423,6 +493,11 @@ int Engine::InitImGui()
 
 void Engine::Cleanup()
 {
+    // Entities and scenes outlive the window; their textures and terrains go
+    // while the context is still current
+    TextureManager::Instance().Shutdown();
+    TerrainManager::Instance().Shutdown();
+
     if (m_imguiInitialized)
     {
         ImGui_ImplOpenGL3_Shutdown();
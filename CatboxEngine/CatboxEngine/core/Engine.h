@@ -12,6 +12,7 @@
 #include "../gameplay/EnemySystem.h"
 #include "UIManager.h"
 #include "InputHandler.h"
+#include "RenderThread.h"
 #include <vector>
 #include <string>
 #include "../resources/Math/Vec3.h"
@@ -40,6 +41,16 @@ private:
     void Update(float deltaTime);
     void Render();
 
+    // Update() in two halves: gameplay / free camera (no GL, runs while the
+    // render thread draws), then events, UI and uploads (needs the context)
+    void UpdateSimulation(float deltaTime);
+    void UpdateEditor(float deltaTime);
+
+    // Clear, scene, overlays, UI and swap; shared by both threading modes
+    void DrawFrame(EntityManager& entities, Camera& camera, int displayWidth, int displayHeight,
+                   bool playMode, ImDrawData* ui);
+    void RenderSnapshot(FrameSnapshot& frame);
+
     int Initialize();
     int InitImGui();
     void SetupMessageSubscriptions();
@@ -62,6 +73,12 @@ private:
     
     // Rendering system
     RenderPipeline m_renderPipeline;
+
+    // Render thread mode (GraphicsSettings::ThreadedRendering): the thread draws
+    // m_snapshots[m_snapshotIndex] while the main thread fills the other one
+    RenderThread m_renderThread;
+    FrameSnapshot m_snapshots[2];
+    int m_snapshotIndex = 0;
     
     // Game systems
     EntityManager m_entityManager;
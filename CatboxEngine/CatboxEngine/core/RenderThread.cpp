@@ -0,0 +1,124 @@
+#include "RenderThread.h"
+#include "imgui_impl_opengl3.h"
+#include <glfw3.h>
+
+void FrameSnapshot::CaptureUI(const ImDrawData* source)
+{
+    ReleaseUI();
+    if (!source || !source->Valid)
+        return;
+
+    // Font atlas changes go up now; the render thread then only draws
+    if (source->Textures)
+    {
+        for (ImTextureData* tex : *source->Textures)
+            if (tex->Status != ImTextureStatus_OK)
+                ImGui_ImplOpenGL3_UpdateTexture(tex);
+    }
+
+    UI.Valid = true;
+    UI.DisplayPos = source->DisplayPos;
+    UI.DisplaySize = source->DisplaySize;
+    UI.FramebufferScale = source->FramebufferScale;
+    UI.OwnerViewport = source->OwnerViewport;
+    UI.Textures = nullptr;
+
+    // Not AddDrawList(): its sanity checks look at write cursors clones do not have
+    for (const ImDrawList* list : source->CmdLists)
+    {
+        UI.CmdLists.push_back(list->CloneOutput());
+        UI.CmdListsCount++;
+        UI.TotalVtxCount += list->VtxBuffer.Size;
+        UI.TotalIdxCount += list->IdxBuffer.Size;
+    }
+}
+
+void FrameSnapshot::ReleaseUI()
+{
+    for (ImDrawList* list : UI.CmdLists)
+        IM_DELETE(list);
+    UI.Clear();
+}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void RenderThread::Start(GLFWwindow* window, std::function<void()> frame)
+{
+    if (IsRunning())
+        return;
+
+    m_window = window;
+    m_frame = std::move(frame);
+    m_pending = false;
+    m_quit = false;
+    m_thread = std::thread(&RenderThread::ThreadLoop, this);
+}
+
+void RenderThread::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    WaitIdle();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void RenderThread::Submit()
+{
+    if (!IsRunning())
+        return;
+
+    // A context is current on one thread at a time
+    glfwMakeContextCurrent(nullptr);
+    m_contextReleased = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = true;
+    }
+    m_wake.notify_one();
+}
+
+void RenderThread::WaitIdle()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return !m_pending; });
+    }
+
+    if (m_contextReleased)
+    {
+        glfwMakeContextCurrent(m_window);
+        m_contextReleased = false;
+    }
+}
+
+void RenderThread::ThreadLoop()
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_pending || m_quit; });
+            if (m_quit)
+                return;
+        }
+
+        glfwMakeContextCurrent(m_window);
+        m_frame();
+        glfwMakeContextCurrent(nullptr);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending = false;
+        }
+        m_done.notify_one();
+    }
+}
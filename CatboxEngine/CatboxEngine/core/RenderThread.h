@@ -0,0 +1,81 @@
+#pragma once
+#include "../resources/Camera.h"
+#include "../resources/EntityManager.h"
+#include "imgui.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct GLFWwindow;
+
+// Everything the render thread reads for one frame, copied by the main thread
+// once simulation and UI are done so the next frame can be simulated while
+// this one is drawn. The UI draw lists are clones owned by the snapshot.
+// Lights are not copied: LightManager is only touched by the renderer and by
+// the editor half of the frame, which runs after WaitIdle(), and the renderer
+// keeps each light's shadow atlas tiles in it from frame to frame.
+struct FrameSnapshot
+{
+    EntityManager Entities;
+    Camera View;
+    int DisplayWidth = 0;
+    int DisplayHeight = 0;
+    bool PlayMode = false;
+    ImDrawData UI;
+
+    FrameSnapshot() = default;
+    ~FrameSnapshot() { ReleaseUI(); }
+
+    FrameSnapshot(const FrameSnapshot&) = delete;
+    FrameSnapshot& operator=(const FrameSnapshot&) = delete;
+
+    // Clones source's draw lists. Pending font atlas uploads are applied here,
+    // so this must run on the thread that currently holds the GL context.
+    void CaptureUI(const ImDrawData* source);
+    void ReleaseUI();
+};
+
+// Dedicated thread that draws and presents frames. The GL context is handed
+// back and forth: the render thread holds it from Submit() until the frame
+// is swapped, the main thread from WaitIdle() on (uploads, UI, picking).
+// At most one frame is in flight, so the picture trails simulation by one
+// frame at most.
+class RenderThread
+{
+public:
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // frame runs on the render thread, with window's context current, once per Submit()
+    void Start(GLFWwindow* window, std::function<void()> frame);
+
+    // Finishes the frame in flight, joins the thread and makes the context current on the caller
+    void Stop();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Releases the context on the caller and starts one frame. The caller must
+    // not touch GL (or the snapshot being drawn) until WaitIdle().
+    void Submit();
+
+    // Blocks until the submitted frame is done and takes the context back
+    void WaitIdle();
+
+private:
+    void ThreadLoop();
+
+    GLFWwindow* m_window = nullptr;
+    std::function<void()> m_frame;
+    std::thread m_thread;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_pending = false;         // A frame was submitted and is not done yet
+    bool m_quit = false;
+    bool m_contextReleased = false; // The main thread gave up the context in Submit()
+};
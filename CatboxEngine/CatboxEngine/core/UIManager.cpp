@@ -82,7 +82,8 @@ void UIManager::NewFrame()
 void UIManager::Draw(EntityManager& entityManager, Vec3& spawnPosition, Vec3& spawnScale, 
                     float deltaTime, int& selectedIndex, Camera& camera, bool& useSharedCube,
                     PlayerController* playerController, bool& isPlayMode,
-                    bool goalReached, RecordTimeSystem* recordSystem)
+                    bool goalReached, RecordTimeSystem* recordSystem,
+                    const RenderStats* renderStats)
 {
     bool playerReady = playerController && playerController->HasPlayerEntity();
     DrawPlayModeToolbar(isPlayMode, playerReady);
@@ -103,7 +104,7 @@ void UIManager::Draw(EntityManager& entityManager, Vec3& spawnPosition, Vec3& sp
         DrawSceneManager(entityManager, recordSystem);
     }
 
-    m_statsInspector->Draw(deltaTime, entityManager);
+    m_statsInspector->Draw(deltaTime, entityManager, renderStats);
 
     if (playerController && !isPlayMode)
         m_playerInspector->Draw(*playerController, entityManager, camera);
@@ -223,10 +224,9 @@ void UIManager::DrawTimerHUD(float elapsed)
     ImGui::End();
 }
 
-void UIManager::Render()
+void UIManager::Render(ImDrawData* drawData)
 {
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    ImGui_ImplOpenGL3_RenderDrawData(drawData);
 }
 
 void UIManager::DrawPlayModeToolbar(bool& isPlayMode, bool playerReady)
@@ -13,6 +13,8 @@ class LightInspector;
 class GraphicsSettingsInspector;
 class PlayerInspector;
 class LevelSelectMenu;
+struct ImDrawData;
+struct RenderStats;
 
 class UIManager
 {
@@ -29,17 +31,18 @@ public:
     // Start new ImGui frame
     void NewFrame();
 
-    // Build UI (manages all inspectors)
+    // Build UI (manages all inspectors). renderStats are the last drawn frame's.
     void Draw(EntityManager& entityManager, Vec3& spawnPosition, Vec3& spawnScale, 
              float deltaTime, int& selectedIndex, Camera& camera, bool& useSharedCube,
              PlayerController* playerController, bool& isPlayMode,
-             bool goalReached = false, RecordTimeSystem* recordSystem = nullptr);
+             bool goalReached = false, RecordTimeSystem* recordSystem = nullptr,
+             const RenderStats* renderStats = nullptr);
 
     // Called by Engine the frame a goal is first reached
     void NotifyGoalResult(float completionTime, bool isNewBest);
 
-    // Render ImGui draw data
-    void Render();
+    // Render ImGui draw data (this frame's, or a render thread snapshot's)
+    void Render(ImDrawData* drawData);
 
 private:
     // Draw scene manager window (includes level select section)
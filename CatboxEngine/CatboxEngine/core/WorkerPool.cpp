@@ -0,0 +1,93 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool& WorkerPool::Instance()
+{
+    static WorkerPool inst;
+    return inst;
+}
+
+WorkerPool::WorkerPool()
+{
+    unsigned int hardware = std::thread::hardware_concurrency();
+    unsigned int workers = hardware > 1 ? std::min(hardware - 1, MAX_WORKERS) : 0;
+    for (unsigned int i = 0; i < workers; ++i)
+        m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads)
+        t.join();
+}
+
+void WorkerPool::ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& fn)
+{
+    if (count == 0)
+        return;
+    if (batchSize == 0)
+        batchSize = 1;
+
+    // Not worth waking anyone
+    if (m_threads.empty() || count <= batchSize)
+    {
+        for (size_t begin = 0; begin < count; begin += batchSize)
+            fn(begin, std::min(begin + batchSize, count));
+        return;
+    }
+
+    std::lock_guard<std::mutex> call(m_callMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_count = count;
+        m_batchSize = batchSize;
+        m_next = 0;
+        m_busy = (int)m_threads.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    RunBatches();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_busy == 0; });
+    m_job = nullptr;
+}
+
+void WorkerPool::WorkerLoop()
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, seen]() { return m_quit || m_generation != seen; });
+            if (m_quit)
+                return;
+            seen = m_generation;
+        }
+
+        RunBatches();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0)
+            m_done.notify_one();
+    }
+}
+
+void WorkerPool::RunBatches()
+{
+    for (;;)
+    {
+        size_t begin = m_next.fetch_add(m_batchSize);
+        if (begin >= m_count)
+            return;
+        (*m_job)(begin, std::min(begin + m_batchSize, m_count));
+    }
+}
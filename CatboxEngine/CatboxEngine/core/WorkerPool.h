@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker threads for data-parallel frame work (culling, setup).
+// ParallelFor hands out [0, count) in fixed-size batches from a shared
+// counter; the calling thread works too and it returns once every batch has
+// run. Batches start at multiples of batchSize, so a batch size of 64 lets a
+// task own whole words of a bitset. Calls must not nest.
+class WorkerPool
+{
+public:
+    static WorkerPool& Instance();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // fn(begin, end) runs for consecutive ranges of at most batchSize items
+    void ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& fn);
+
+    // Workers plus the calling thread
+    int GetThreadCount() const { return (int)m_threads.size() + 1; }
+
+private:
+    WorkerPool();
+    ~WorkerPool();
+
+    void WorkerLoop();
+    void RunBatches();
+
+    static constexpr unsigned int MAX_WORKERS = 7;
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_callMutex;  // One ParallelFor at a time
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    // Current job, written under m_mutex before the workers are woken
+    const std::function<void(size_t, size_t)>* m_job = nullptr;
+    size_t m_count = 0;
+    size_t m_batchSize = 1;
+    std::atomic<size_t> m_next{ 0 };
+    int m_busy = 0;             // Workers still inside the current job
+    uint64_t m_generation = 0;  // Bumped per job so workers never run one twice
+    bool m_quit = false;
+};
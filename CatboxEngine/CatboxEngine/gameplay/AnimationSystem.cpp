@@ -3,6 +3,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 // ---------------------------------------------------------------------------
 // Helper: convert ufbx_matrix (column-major 4x3) to glm::mat4
@@ -224,3 +225,39 @@ void AnimationPlayer::ComputeBoneMatrices(const Skeleton& skeleton,
                         * skeleton.Bones[bi].InverseBindPose;
     }
 }
+
+bool AnimationPlayer::ComputeBoneDualQuats(const Skeleton& skeleton,
+                                           std::vector<DualQuat>& outDualQuats) const
+{
+    std::vector<glm::mat4> matrices;
+    ComputeBoneMatrices(skeleton, matrices);
+
+    // Scale that survives the bind pose (e.g. an unapplied unit scale)
+    // needs matrix skinning
+    constexpr float RIGID_TOLERANCE = 1e-3f;
+    outDualQuats.resize(matrices.size());
+    for (size_t bi = 0; bi < matrices.size(); ++bi)
+    {
+        glm::mat3 rotation(matrices[bi]);
+        for (int c = 0; c < 3; ++c)
+        {
+            if (std::abs(glm::length(rotation[c]) - 1.0f) > RIGID_TOLERANCE ||
+                std::abs(glm::dot(rotation[c], rotation[(c + 1) % 3])) > RIGID_TOLERANCE)
+            {
+                outDualQuats.clear();
+                return false;
+            }
+        }
+        if (glm::determinant(rotation) < 0.0f)
+        {
+            outDualQuats.clear();
+            return false;
+        }
+
+        glm::vec3 t(matrices[bi][3]);
+        DualQuat& dq = outDualQuats[bi];
+        dq.Real = glm::normalize(glm::quat_cast(rotation));
+        dq.Dual = (glm::quat(0.0f, t.x, t.y, t.z) * dq.Real) * 0.5f;
+    }
+    return true;
+}
@@ -41,6 +41,16 @@ struct BoneSample
     glm::vec3 Scale    { 1.0f };
 };
 
+// Rigid bone transform as a unit dual quaternion: rotate by Real, then
+// translate by 2 * Dual * conjugate(Real). Half the size of a mat4 and
+// blends without the volume loss of linear matrix skinning.
+struct DualQuat
+{
+    glm::quat Real { 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::quat Dual { 0.0f, 0.0f, 0.0f, 0.0f };
+};
+static_assert(sizeof(DualQuat) == 32, "DualQuat is uploaded as two vec4s");
+
 // All bone poses at one point in time
 struct AnimationFrame
 {
@@ -69,6 +79,11 @@ public:
     void Update(float deltaTime);
     void ComputeBoneMatrices(const Skeleton& skeleton, std::vector<glm::mat4>& outMatrices) const;
 
+    // The same pose as dual quaternions. Returns false (and leaves
+    // outDualQuats empty) when a skinning matrix scales or shears, which a
+    // dual quaternion cannot represent; use ComputeBoneMatrices then.
+    bool ComputeBoneDualQuats(const Skeleton& skeleton, std::vector<DualQuat>& outDualQuats) const;
+
     AnimationClip* GetCurrentClip() const { return m_currentClip; }
     float GetTime() const { return m_currentTime; }
     bool IsPlaying() const { return m_playing; }
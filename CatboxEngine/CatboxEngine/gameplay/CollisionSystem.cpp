@@ -328,7 +328,7 @@ bool CollisionSystem::ResolveTerrainCollisions(Entity& player, glm::vec3& veloci
 
     for (const auto& entity : entityManager.GetAll())
     {
-        if (!entity.IsTerrain || entity.TerrainHeightData.empty())
+        if (!entity.IsTerrain || entity.TerrainChunks == 0)
             continue;
 
         const float terrainY = TerrainSystem::SampleHeight(
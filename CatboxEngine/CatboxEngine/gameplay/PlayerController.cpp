@@ -382,6 +382,7 @@ void PlayerController::UpdateAnimation(float deltaTime)
     if (!mesh || !mesh->HasSkeleton)
     {
         m_playerEntity->BoneMatrices.clear();
+        m_playerEntity->BoneDualQuats.clear();
         return;
     }
 
@@ -400,5 +401,15 @@ void PlayerController::UpdateAnimation(float deltaTime)
     }
 
     m_animPlayer.Update(deltaTime);
-    m_animPlayer.ComputeBoneMatrices(mesh->MeshSkeleton, m_playerEntity->BoneMatrices);
+    // Dual quaternions fall back to matrices when a bone is scaled
+    if (mesh->DualQuaternionSkinning &&
+        m_animPlayer.ComputeBoneDualQuats(mesh->MeshSkeleton, m_playerEntity->BoneDualQuats))
+    {
+        m_playerEntity->BoneMatrices.clear();
+    }
+    else
+    {
+        m_animPlayer.ComputeBoneMatrices(mesh->MeshSkeleton, m_playerEntity->BoneMatrices);
+        m_playerEntity->BoneDualQuats.clear();
+    }
 }
@@ -2,12 +2,15 @@
 #include "../resources/Entity.h"
 #include "../graphics/MeshManager.h"
 #include "../graphics/Mesh.h"
+#include "../graphics/TerrainManager.h"
+#include "../graphics/TerrainQuadtree.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <cmath>
 #include <cfloat>
 #include <algorithm>
 #include <iostream>
+#include <memory>
 
 // stb_image declarations only — STB_IMAGE_IMPLEMENTATION is in Mesh.cpp via tiny_gltf.h
 #include "../Dependencies/stb_image.h"
@@ -99,86 +102,49 @@ void TerrainSystem::GenerateTerrainMesh(Entity& entity)
         }
     }
 
-    // --- 2. Build vertex and index buffers ---
-    Mesh mesh;
-    mesh.Vertices.reserve(static_cast<size_t>(vw * vd));
-    mesh.Indices.reserve(static_cast<size_t>(gw * gd * 6));
-
+    // --- 2. Resample onto the grid: the chunks' height texture ---
+    std::vector<float> gridHeights(static_cast<size_t>(vw * vd));
     for (int iz = 0; iz < vd; ++iz)
     {
         for (int ix = 0; ix < vw; ++ix)
         {
             float u = static_cast<float>(ix) / gw;
             float v = static_cast<float>(iz) / gd;
-            float h = SampleHeightBilinear(entity.TerrainHeightData,
-                                           entity.TerrainHeightDataWidth,
-                                           entity.TerrainHeightDataDepth, u, v);
-            Vertex vert;
-            vert.Position = { u - 0.5f, h, v - 0.5f };
-            vert.UV       = { u * 8.0f, v * 8.0f, 0.0f };  // tiled UVs
-            vert.Normal   = { 0.0f, 1.0f, 0.0f };           // recalculated below
-            vert.Tangent  = { 1.0f, 0.0f, 0.0f };
-            mesh.Vertices.push_back(vert);
+            gridHeights[iz * vw + ix] = SampleHeightBilinear(entity.TerrainHeightData,
+                                                             entity.TerrainHeightDataWidth,
+                                                             entity.TerrainHeightDataDepth, u, v);
         }
     }
 
-    for (int iz = 0; iz < gd; ++iz)
-    {
-        for (int ix = 0; ix < gw; ++ix)
-        {
-            uint32_t a = static_cast<uint32_t>( iz      * vw + ix    );
-            uint32_t b = static_cast<uint32_t>( iz      * vw + ix + 1);
-            uint32_t c = static_cast<uint32_t>((iz + 1) * vw + ix    );
-            uint32_t d = static_cast<uint32_t>((iz + 1) * vw + ix + 1);
-            mesh.Indices.push_back(a);
-            mesh.Indices.push_back(c);
-            mesh.Indices.push_back(b);
-            mesh.Indices.push_back(b);
-            mesh.Indices.push_back(c);
-            mesh.Indices.push_back(d);
-        }
-    }
+    auto chunks = std::make_unique<TerrainQuadtree>();
+    chunks->Build(gridHeights, gw, gd);
 
-    // --- 3. Smooth normals (average of adjacent triangle face normals) ---
-    std::vector<glm::vec3> normals(mesh.Vertices.size(), glm::vec3(0.0f));
-    for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
-    {
-        uint32_t i0 = mesh.Indices[i], i1 = mesh.Indices[i + 1], i2 = mesh.Indices[i + 2];
-        auto toGlm = [&](const Vec3& p) { return glm::vec3(p.x, p.y, p.z); };
-        glm::vec3 n = glm::cross(toGlm(mesh.Vertices[i1].Position) - toGlm(mesh.Vertices[i0].Position),
-                                 toGlm(mesh.Vertices[i2].Position) - toGlm(mesh.Vertices[i0].Position));
-        normals[i0] += n;
-        normals[i1] += n;
-        normals[i2] += n;
-    }
-    for (size_t i = 0; i < mesh.Vertices.size(); ++i)
-    {
-        glm::vec3 n = glm::normalize(normals[i]);
-        mesh.Vertices[i].Normal = { n.x, n.y, n.z };
-    }
+    // Rendering and collision read the grid from now on
+    entity.TerrainHeightData.clear();
+    entity.TerrainHeightData.shrink_to_fit();
 
-    // --- 4. Finalise and upload ---
+    // --- 3. Coarse proxy mesh for bounds, picking and occlusion ---
+    Mesh mesh;
+    chunks->BuildProxyMesh(mesh);
     mesh.DiffuseColor = { 0.35f, 0.55f, 0.25f };  // grassy green
-    mesh.CalculateBounds();
     mesh.Upload();
 
-    // --- 5. Free old GPU resources and register in MeshManager ---
+    // --- 4. Free old GPU resources and register in MeshManager ---
     if (entity.MeshHandle != 0)
     {
         Mesh* old = MeshManager::Instance().GetMesh(entity.MeshHandle);
         if (old)
-        {
-            if (old->VAO) { glDeleteVertexArrays(1, &old->VAO); old->VAO = 0; }
-            if (old->VBO) { glDeleteBuffers(1, &old->VBO);      old->VBO = 0; }
-            if (old->EBO) { glDeleteBuffers(1, &old->EBO);      old->EBO = 0; }
-        }
+            old->ReleaseGPU();
         MeshManager::Instance().Release(entity.MeshHandle);
         entity.MeshHandle = 0;
     }
 
+    TerrainManager::Instance().Release(entity.TerrainChunks);
+
     const std::string meshKey = "[terrain]" + entity.name;
     entity.MeshHandle = MeshManager::Instance().RegisterMesh(meshKey, std::move(mesh));
     entity.MeshPath   = "[terrain]";
+    entity.TerrainChunks = TerrainManager::Instance().Create(std::move(chunks));
 }
 
 // ---------------------------------------------------------------------------
@@ -187,7 +153,8 @@ void TerrainSystem::GenerateTerrainMesh(Entity& entity)
 
 float TerrainSystem::SampleHeight(const Entity& terrain, float worldX, float worldZ)
 {
-    if (!terrain.IsTerrain || terrain.TerrainHeightData.empty())
+    const TerrainQuadtree* chunks = terrain.IsTerrain ? TerrainManager::Instance().Get(terrain.TerrainChunks) : nullptr;
+    if (!chunks)
         return -FLT_MAX;
 
     const float halfX = terrain.Transform.Scale.x * 0.5f;
@@ -203,9 +170,59 @@ float TerrainSystem::SampleHeight(const Entity& terrain, float worldX, float wor
     const float u = (worldX - minX) / terrain.Transform.Scale.x;
     const float v = (worldZ - minZ) / terrain.Transform.Scale.z;
 
-    const float h = SampleHeightBilinear(terrain.TerrainHeightData,
-                                          terrain.TerrainHeightDataWidth,
-                                          terrain.TerrainHeightDataDepth, u, v);
+    const float h = chunks->SampleHeight(u, v);
 
     return terrain.Transform.Position.y + h * terrain.Transform.Scale.y;
 }
+
+// ---------------------------------------------------------------------------
+// TerrainSystem::SetGridHeights
+// ---------------------------------------------------------------------------
+
+void TerrainSystem::SetGridHeights(Entity& terrain, int x, int z, int width, int depth, const float* heights)
+{
+    TerrainQuadtree* chunks = terrain.IsTerrain ? TerrainManager::Instance().Get(terrain.TerrainChunks) : nullptr;
+    if (!chunks || width <= 0 || depth <= 0)
+        return;
+
+    chunks->UpdateHeights(x, z, width, depth, heights);
+
+    // Keep the proxy's bounds and occlusion surface in step
+    Mesh* proxy = terrain.MeshHandle ? MeshManager::Instance().GetMesh(terrain.MeshHandle) : nullptr;
+    if (proxy)
+    {
+        size_t firstVertex = 0, vertexCount = 0;
+        chunks->UpdateProxyMesh(*proxy, x, z, x + width - 1, z + depth - 1, firstVertex, vertexCount);
+        if (vertexCount > 0)
+            proxy->UpdateVertexStreams(firstVertex, vertexCount);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// TerrainSystem::SculptHeights
+// ---------------------------------------------------------------------------
+
+void TerrainSystem::SculptHeights(Entity& terrain, float u, float v, int radius, float amount)
+{
+    const TerrainQuadtree* chunks = terrain.IsTerrain ? TerrainManager::Instance().Get(terrain.TerrainChunks) : nullptr;
+    if (!chunks || radius <= 0)
+        return;
+
+    const int cx   = static_cast<int>(std::lround(u * chunks->GetCellsX()));
+    const int cz   = static_cast<int>(std::lround(v * chunks->GetCellsZ()));
+    const int size = radius * 2 + 1;
+
+    // Smooth falloff: full strength at the centre, none at the radius
+    std::vector<float> heights(static_cast<size_t>(size * size));
+    for (int dz = -radius; dz <= radius; ++dz)
+    {
+        for (int dx = -radius; dx <= radius; ++dx)
+        {
+            float d = static_cast<float>(dx * dx + dz * dz) / static_cast<float>(radius * radius);
+            float weight = d < 1.0f ? (1.0f - d) * (1.0f - d) : 0.0f;
+            heights[(dz + radius) * size + (dx + radius)] = chunks->Height(cx + dx, cz + dz) + amount * weight;
+        }
+    }
+
+    SetGridHeights(terrain, cx - radius, cz - radius, size, size, heights.data());
+}
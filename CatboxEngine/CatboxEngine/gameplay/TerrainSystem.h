@@ -9,11 +9,23 @@ class TerrainSystem
 {
 public:
     // Generates and uploads a terrain mesh for the given entity.
-    // Populates entity.TerrainHeightData and entity.MeshHandle.
+    // Populates entity.TerrainHeightData, entity.TerrainChunks (the drawn LOD
+    // chunks, replacing and releasing any previous ones) and entity.MeshHandle
+    // (a coarse proxy for bounds and occlusion).
     // If TerrainHeightmapPath is empty, procedural rolling hills are used.
     static void GenerateTerrainMesh(Entity& entity);
 
     // Returns the world-space Y height at (worldX, worldZ) on a terrain entity.
     // Returns -FLT_MAX if the point is outside terrain bounds or the entity is not terrain.
     static float SampleHeight(const Entity& terrain, float worldX, float worldZ);
+
+    // Overwrites a width x depth block of grid heights ([0,1], row-major)
+    // starting at grid vertex (x, z). Only the edited texels of the height
+    // texture and the proxy rows over the block are re-uploaded.
+    static void SetGridHeights(Entity& terrain, int x, int z, int width, int depth, const float* heights);
+
+    // Raises (amount > 0) or lowers the grid heights around normalised grid
+    // position (u, v), fading out over radius grid cells. Edits are lost on
+    // GenerateTerrainMesh.
+    static void SculptHeights(Entity& terrain, float u, float v, int radius, float amount);
 };
@@ -0,0 +1,365 @@
+#include "BlockCompression.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+// S3TC is an extension; glad only carries the core formats
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace
+{
+    // One 4x4 block, channels 0-255
+    struct Block
+    {
+        float Texels[16][4];
+    };
+
+    void FetchBlock(const uint8_t* rgba, int width, int height, int blockX, int blockY, Block& block)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                int sx = std::min(blockX * 4 + x, width - 1);
+                int sy = std::min(blockY * 4 + y, height - 1);
+                const uint8_t* texel = rgba + ((size_t)sy * width + sx) * 4;
+                for (int c = 0; c < 4; ++c)
+                    block.Texels[y * 4 + x][c] = texel[c];
+            }
+        }
+    }
+
+    float Distance(const float* a, const float* b, int channels)
+    {
+        float d = 0.0f;
+        for (int c = 0; c < channels; ++c)
+            d += (a[c] - b[c]) * (a[c] - b[c]);
+        return d;
+    }
+
+    // Extent of the block along its principal axis (power iteration on the
+    // covariance of the first `channels` channels)
+    void FitLine(const Block& block, int channels, float lo[4], float hi[4])
+    {
+        float mean[4] = {};
+        for (const auto& t : block.Texels)
+            for (int c = 0; c < channels; ++c)
+                mean[c] += t[c] / 16.0f;
+
+        float cov[4][4] = {};
+        for (const auto& t : block.Texels)
+            for (int i = 0; i < channels; ++i)
+                for (int j = 0; j < channels; ++j)
+                    cov[i][j] += (t[i] - mean[i]) * (t[j] - mean[j]);
+
+        float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[4] = {};
+            float largest = 0.0f;
+            for (int i = 0; i < channels; ++i)
+            {
+                for (int j = 0; j < channels; ++j)
+                    next[i] += cov[i][j] * axis[j];
+                largest = std::max(largest, std::abs(next[i]));
+            }
+            if (largest < 1e-6f)
+                break;
+            for (int i = 0; i < channels; ++i)
+                axis[i] = next[i] / largest;
+        }
+
+        float length = 0.0f;
+        for (int c = 0; c < channels; ++c)
+            length += axis[c] * axis[c];
+        length = std::sqrt(length);
+
+        float minProj = 0.0f, maxProj = 0.0f;
+        if (length > 1e-6f)
+        {
+            for (int c = 0; c < channels; ++c)
+                axis[c] /= length;
+            minProj = FLT_MAX;
+            maxProj = -FLT_MAX;
+            for (const auto& t : block.Texels)
+            {
+                float p = 0.0f;
+                for (int c = 0; c < channels; ++c)
+                    p += (t[c] - mean[c]) * axis[c];
+                minProj = std::min(minProj, p);
+                maxProj = std::max(maxProj, p);
+            }
+        }
+
+        for (int c = 0; c < 4; ++c)
+        {
+            float a = c < channels ? axis[c] : 0.0f;
+            lo[c] = std::clamp(mean[c] + a * minProj, 0.0f, 255.0f);
+            hi[c] = std::clamp(mean[c] + a * maxProj, 0.0f, 255.0f);
+        }
+    }
+
+    uint16_t To565(const float color[3])
+    {
+        int r = std::clamp((int)std::lround(color[0] * 31.0f / 255.0f), 0, 31);
+        int g = std::clamp((int)std::lround(color[1] * 63.0f / 255.0f), 0, 63);
+        int b = std::clamp((int)std::lround(color[2] * 31.0f / 255.0f), 0, 31);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void From565(uint16_t value, float color[3])
+    {
+        int r = (value >> 11) & 31, g = (value >> 5) & 63, b = value & 31;
+        color[0] = (float)((r << 3) | (r >> 2));
+        color[1] = (float)((g << 2) | (g >> 4));
+        color[2] = (float)((b << 3) | (b >> 2));
+    }
+
+    // BC1 colour block; also the colour half of BC3, which always decodes
+    // in four-colour mode, so color0 > color1 suits both
+    void EncodeColorBlock(const Block& block, uint8_t* out)
+    {
+        float lo[4], hi[4];
+        FitLine(block, 3, lo, hi);
+        uint16_t color0 = To565(hi);
+        uint16_t color1 = To565(lo);
+        if (color0 < color1)
+            std::swap(color0, color1);
+
+        // Equal endpoints: every index 0 is exact in either mode
+        uint32_t indices = 0;
+        if (color0 != color1)
+        {
+            float palette[4][3];
+            From565(color0, palette[0]);
+            From565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                uint32_t best = 0;
+                float bestDistance = FLT_MAX;
+                for (uint32_t p = 0; p < 4; ++p)
+                {
+                    float d = Distance(block.Texels[i], palette[p], 3);
+                    if (d < bestDistance) { bestDistance = d; best = p; }
+                }
+                indices |= best << (2 * i);
+            }
+        }
+
+        out[0] = (uint8_t)(color0 & 0xFF);
+        out[1] = (uint8_t)(color0 >> 8);
+        out[2] = (uint8_t)(color1 & 0xFF);
+        out[3] = (uint8_t)(color1 >> 8);
+        for (int b = 0; b < 4; ++b)
+            out[4 + b] = (uint8_t)(indices >> (8 * b));
+    }
+
+    // BC4 block of one channel; also BC3 alpha and each half of BC5
+    void EncodeChannelBlock(const Block& block, int channel, uint8_t* out)
+    {
+        float lo = 255.0f, hi = 0.0f;
+        for (const auto& t : block.Texels)
+        {
+            lo = std::min(lo, t[channel]);
+            hi = std::max(hi, t[channel]);
+        }
+        uint8_t value0 = (uint8_t)std::lround(hi);
+        uint8_t value1 = (uint8_t)std::lround(lo);
+
+        // value0 > value1 selects the eight-value ramp
+        uint64_t indices = 0;
+        if (value0 > value1)
+        {
+            float palette[8] = { (float)value0, (float)value1 };
+            for (int i = 1; i < 7; ++i)
+                palette[i + 1] = ((7 - i) * (float)value0 + i * (float)value1) / 7.0f;
+            for (int i = 0; i < 16; ++i)
+            {
+                uint64_t best = 0;
+                float bestDistance = FLT_MAX;
+                for (uint64_t p = 0; p < 8; ++p)
+                {
+                    float d = std::abs(block.Texels[i][channel] - palette[p]);
+                    if (d < bestDistance) { bestDistance = d; best = p; }
+                }
+                indices |= best << (3 * i);
+            }
+        }
+
+        out[0] = value0;
+        out[1] = value1;
+        for (int b = 0; b < 6; ++b)
+            out[2 + b] = (uint8_t)(indices >> (8 * b));
+    }
+
+    // Little-endian bit stream over one 16-byte BC7 block
+    struct BitWriter
+    {
+        uint8_t* Out;
+        int Bit = 0;
+
+        void Write(uint32_t value, int bits)
+        {
+            for (int i = 0; i < bits; ++i, ++Bit)
+            {
+                if ((value >> i) & 1u)
+                    Out[Bit >> 3] |= (uint8_t)(1u << (Bit & 7));
+            }
+        }
+    };
+
+    // Endpoint as 7 bits per channel plus a shared low bit (p-bit)
+    void QuantizeBC7Endpoint(const float endpoint[4], uint32_t quantized[4], uint32_t& pbit)
+    {
+        float bestError = FLT_MAX;
+        for (uint32_t p = 0; p < 2; ++p)
+        {
+            uint32_t candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; ++c)
+            {
+                candidate[c] = (uint32_t)std::clamp((int)std::lround((endpoint[c] - (float)p) / 2.0f), 0, 127);
+                float decoded = (float)((candidate[c] << 1) | p);
+                error += (decoded - endpoint[c]) * (decoded - endpoint[c]);
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                pbit = p;
+                std::copy(candidate, candidate + 4, quantized);
+            }
+        }
+    }
+
+    // BC7 mode 6: one subset, RGBA endpoints, 4-bit indices
+    void EncodeBC7Block(const Block& block, uint8_t* out)
+    {
+        static const int WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        float lo[4], hi[4];
+        FitLine(block, 4, lo, hi);
+        uint32_t q0[4], q1[4], p0 = 0, p1 = 0;
+        QuantizeBC7Endpoint(lo, q0, p0);
+        QuantizeBC7Endpoint(hi, q1, p1);
+
+        float palette[16][4];
+        for (int w = 0; w < 16; ++w)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                int e0 = (int)((q0[c] << 1) | p0);
+                int e1 = (int)((q1[c] << 1) | p1);
+                palette[w][c] = (float)(((64 - WEIGHTS[w]) * e0 + WEIGHTS[w] * e1 + 32) >> 6);
+            }
+        }
+
+        uint32_t indices[16];
+        for (int i = 0; i < 16; ++i)
+        {
+            indices[i] = 0;
+            float bestDistance = FLT_MAX;
+            for (uint32_t w = 0; w < 16; ++w)
+            {
+                float d = Distance(block.Texels[i], palette[w], 4);
+                if (d < bestDistance) { bestDistance = d; indices[i] = w; }
+            }
+        }
+
+        // The first index is stored without its top bit: swap the endpoints
+        // (the weights are symmetric) when it would be set
+        if (indices[0] >= 8)
+        {
+            std::swap(q0, q1);
+            std::swap(p0, p1);
+            for (uint32_t& index : indices)
+                index = 15 - index;
+        }
+
+        std::fill(out, out + 16, (uint8_t)0);
+        BitWriter bits{ out };
+        bits.Write(1u << 6, 7);  // Mode 6
+        for (int c = 0; c < 4; ++c)
+        {
+            bits.Write(q0[c], 7);
+            bits.Write(q1[c], 7);
+        }
+        bits.Write(p0, 1);
+        bits.Write(p1, 1);
+        bits.Write(indices[0], 3);
+        for (int i = 1; i < 16; ++i)
+            bits.Write(indices[i], 4);
+    }
+}
+
+size_t BlockCompression::GetBlockBytes(Format format)
+{
+    return (format == Format::BC1 || format == Format::BC4) ? 8 : 16;
+}
+
+size_t BlockCompression::GetImageBytes(Format format, int width, int height)
+{
+    return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * GetBlockBytes(format);
+}
+
+uint32_t BlockCompression::GetGLFormat(Format format)
+{
+    switch (format)
+    {
+        case Format::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case Format::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case Format::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case Format::BC5: return GL_COMPRESSED_RG_RGTC2;
+        case Format::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+    return 0;
+}
+
+void BlockCompression::EncodeImage(Format format, const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out)
+{
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    const size_t blockBytes = GetBlockBytes(format);
+    out.resize((size_t)blocksX * blocksY * blockBytes);
+
+    Block block;
+    uint8_t* dst = out.data();
+    for (int by = 0; by < blocksY; ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx, dst += blockBytes)
+        {
+            FetchBlock(rgba, width, height, bx, by, block);
+            switch (format)
+            {
+                case Format::BC1:
+                    EncodeColorBlock(block, dst);
+                    break;
+                case Format::BC3:
+                    EncodeChannelBlock(block, 3, dst);
+                    EncodeColorBlock(block, dst + 8);
+                    break;
+                case Format::BC4:
+                    EncodeChannelBlock(block, 0, dst);
+                    break;
+                case Format::BC5:
+                    EncodeChannelBlock(block, 0, dst);
+                    EncodeChannelBlock(block, 1, dst + 8);
+                    break;
+                case Format::BC7:
+                    EncodeBC7Block(block, dst);
+                    break;
+            }
+        }
+    }
+}
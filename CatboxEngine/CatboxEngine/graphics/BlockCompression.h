@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU encoders for the BCn block-compressed texture formats, used by
+// TextureCooker. Every format stores 4x4 texel blocks; images whose size is
+// not a multiple of 4 are padded by repeating their last row/column.
+//
+//   BC1  RGB                   8 bytes / block  (4 bpp)   opaque colour
+//   BC3  RGBA (BC1 + BC4 a)   16 bytes / block  (8 bpp)   colour with alpha
+//   BC4  R                     8 bytes / block  (4 bpp)   masks, specular
+//   BC5  RG (two BC4)         16 bytes / block  (8 bpp)   tangent-space normals
+//   BC7  RGBA, mode 6 only    16 bytes / block  (8 bpp)   high quality colour
+//
+// The encoders fit endpoints along each block's principal axis and pick the
+// nearest palette entry per texel: quick enough for a background thread,
+// not the last decibel of quality.
+namespace BlockCompression
+{
+    enum class Format : uint32_t
+    {
+        BC1 = 1,
+        BC3 = 3,
+        BC4 = 4,
+        BC5 = 5,
+        BC7 = 7
+    };
+
+    size_t GetBlockBytes(Format format);
+    size_t GetImageBytes(Format format, int width, int height);
+
+    // GL internal format for glCompressedTexImage2D
+    uint32_t GetGLFormat(Format format);
+
+    // rgba: width * height texels, 4 bytes each, rows top to bottom
+    void EncodeImage(Format format, const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out);
+}
@@ -0,0 +1,93 @@
+#include "BonePalette.h"
+#include "Mesh.h"
+#include "MeshManager.h"
+#include "../resources/Entity.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+BonePalette::~BonePalette()
+{
+    Release();
+}
+
+void BonePalette::Release()
+{
+    if (m_buffer != 0) { glDeleteBuffers(1, &m_buffer); m_buffer = 0; }
+    m_range = StreamRange();
+    m_data.clear();
+    m_offsets.clear();
+    m_morphOffsets.clear();
+    m_dualQuat.clear();
+}
+
+void BonePalette::Update(const EntityManager& entityManager, size_t count)
+{
+    const auto& entities = entityManager.GetAll();
+    count = std::min(count, entities.size());
+
+    m_data.clear();
+    m_offsets.assign(count, -1);
+    m_morphOffsets.assign(count, -1);
+    m_dualQuat.assign(count, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Entity& e = entities[i];
+        Mesh* mesh = e.MeshHandle ? MeshManager::Instance().GetMesh(e.MeshHandle) : nullptr;
+        if (!mesh)
+            continue;
+
+        if (mesh->MorphBuffer != 0)
+            PackMorphWeights(e, *mesh, i);
+
+        if ((e.BoneMatrices.empty() && e.BoneDualQuats.empty()) || !mesh->HasSkeleton)
+            continue;
+
+        // Matrices are column-major (four columns), dual quaternions real then dual (x, y, z, w)
+        m_offsets[i] = (int)m_data.size();
+        if (!e.BoneDualQuats.empty())
+        {
+            m_dualQuat[i] = 1;
+            for (const DualQuat& dq : e.BoneDualQuats)
+            {
+                m_data.emplace_back(dq.Real.x, dq.Real.y, dq.Real.z, dq.Real.w);
+                m_data.emplace_back(dq.Dual.x, dq.Dual.y, dq.Dual.z, dq.Dual.w);
+            }
+        }
+        else
+        {
+            for (const glm::mat4& m : e.BoneMatrices)
+                m_data.insert(m_data.end(), { m[0], m[1], m[2], m[3] });
+        }
+    }
+
+    m_range = StreamBuffer::Instance().UploadStorage(m_buffer, m_data.data(), m_data.size() * sizeof(glm::vec4));
+}
+
+void BonePalette::PackMorphWeights(const Entity& e, const Mesh& mesh, size_t entityIndex)
+{
+    // Entity weights first, the mesh's defaults for the rest
+    size_t targetCount = mesh.MorphTargets.size();
+    size_t first = m_data.size();
+    bool any = false;
+    m_data.resize(first + (targetCount + 3) / 4, glm::vec4(0.0f));
+    for (size_t t = 0; t < targetCount; ++t)
+    {
+        float weight = t < e.MorphWeights.size() ? e.MorphWeights[t] : mesh.MorphTargets[t].Weight;
+        weight = glm::clamp(weight, 0.0f, 1.0f);
+        m_data[first + t / 4][(int)(t % 4)] = weight;
+        any = any || weight > 0.0f;
+    }
+
+    // Nothing to blend: drawn from the mesh's own streams
+    if (!any)
+    {
+        m_data.resize(first);
+        return;
+    }
+    m_morphOffsets[entityIndex] = (int)first;
+}
+
+void BonePalette::Bind() const
+{
+    StreamBuffer::BindStorage(BINDING, m_range);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "StreamBuffer.h"
+#include "../resources/EntityManager.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct Mesh;
+
+// Skinning poses of every skinned entity, packed once per frame into one
+// shader storage buffer of vec4s. SkinningPass selects each entity's palette
+// by offset instead of uploading a uniform array, so the number of animated
+// characters and their bone counts are unbounded. A bone takes four vec4s
+// as a matrix (Entity::BoneMatrices) or two as a dual quaternion
+// (Entity::BoneDualQuats). Morph target weights of entities whose mesh has
+// targets follow in the same buffer, four per vec4.
+class BonePalette
+{
+public:
+    BonePalette() = default;
+    ~BonePalette();
+
+    BonePalette(const BonePalette&) = delete;
+    BonePalette& operator=(const BonePalette&) = delete;
+
+    // Packs the pose of the first count entities whose mesh is skinned and
+    // the morph weights of those whose mesh has targets, then uploads
+    void Update(const EntityManager& entityManager, size_t count);
+    void Release();
+
+    // Binds the storage buffer at BINDING
+    void Bind() const;
+
+    // First vec4 of an entity's palette, -1 when it is not skinned this frame
+    int GetOffset(size_t entityIndex) const
+    {
+        return entityIndex < m_offsets.size() ? m_offsets[entityIndex] : -1;
+    }
+
+    // First vec4 of an entity's morph weights, -1 when all are zero
+    int GetMorphOffset(size_t entityIndex) const
+    {
+        return entityIndex < m_morphOffsets.size() ? m_morphOffsets[entityIndex] : -1;
+    }
+
+    // The entity's palette holds dual quaternions rather than matrices
+    bool IsDualQuat(size_t entityIndex) const
+    {
+        return entityIndex < m_dualQuat.size() && m_dualQuat[entityIndex] != 0;
+    }
+
+    // Last Update(): bytes uploaded
+    size_t GetByteSize() const { return m_data.size() * sizeof(glm::vec4); }
+
+    // Must match BonePalette in Skinning.comp
+    static constexpr unsigned int BINDING = 5;
+
+private:
+    void PackMorphWeights(const Entity& e, const Mesh& mesh, size_t entityIndex);
+
+    std::vector<glm::vec4> m_data;
+    std::vector<int> m_offsets;
+    std::vector<int> m_morphOffsets;
+    std::vector<uint8_t> m_dualQuat;
+    StreamRange m_range;
+    unsigned int m_buffer = 0;  // Used when the stream buffer is full
+};
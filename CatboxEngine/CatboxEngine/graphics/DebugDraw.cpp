@@ -0,0 +1,267 @@
+#include "DebugDraw.h"
+#include "StreamBuffer.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    // Attribute locations in DebugDraw.vert
+    constexpr GLuint ATTRIB_POSITION = 0;
+    constexpr GLuint ATTRIB_COLOR = 1;
+    constexpr GLuint ATTRIB_TRANSFORM = 2;  // 2..5, one column each
+    constexpr GLuint ATTRIB_INSTANCE_COLOR = 6;
+
+    // Puts data where the GPU can read it this frame: the stream buffer, or
+    // fallback re-specified when it is full. Binds the buffer to GL_ARRAY_BUFFER.
+    size_t StreamVertices(const void* data, size_t bytes, unsigned int fallback)
+    {
+        StreamRange range = StreamBuffer::Instance().Allocate(bytes, 16);
+        if (range.Data)
+        {
+            std::memcpy(range.Data, data, bytes);
+            glBindBuffer(GL_ARRAY_BUFFER, range.Buffer);
+            return range.Offset;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, fallback);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)bytes, data, GL_STREAM_DRAW);
+        return 0;
+    }
+}
+
+DebugDraw& DebugDraw::Instance()
+{
+    static DebugDraw inst;
+    return inst;
+}
+
+uint32_t DebugDraw::PackColor(const glm::vec3& color)
+{
+    glm::vec3 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | (255u << 24);
+}
+
+void DebugDraw::Line(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color, Layer layer)
+{
+    uint32_t packed = PackColor(color);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<LineVertex>& lines = m_pending[(int)layer].Lines;
+    lines.push_back({ a, packed });
+    lines.push_back({ b, packed });
+}
+
+void DebugDraw::Box(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::vec3& color, Layer layer)
+{
+    glm::mat4 transform = glm::translate(glm::mat4(1.0f), (boundsMin + boundsMax) * 0.5f);
+    AddShape(ShapeWireBox, glm::scale(transform, (boundsMax - boundsMin) * 0.5f), color, layer);
+}
+
+void DebugDraw::Box(const glm::mat4& transform, const glm::vec3& color, Layer layer)
+{
+    AddShape(ShapeWireBox, transform, color, layer);
+}
+
+void DebugDraw::SolidBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& color, Layer layer)
+{
+    AddShape(ShapeSolidBox, glm::scale(glm::translate(glm::mat4(1.0f), center), halfExtents), color, layer);
+}
+
+void DebugDraw::Sphere(const glm::vec3& center, float radius, const glm::vec3& color, Layer layer)
+{
+    AddShape(ShapeWireSphere, glm::scale(glm::translate(glm::mat4(1.0f), center), glm::vec3(radius)), color, layer);
+}
+
+void DebugDraw::Frustum(const glm::mat4& viewProj, const glm::vec3& color, Layer layer)
+{
+    // The NDC cube taken back to world space; the shader divides by w
+    AddShape(ShapeWireBox, glm::inverse(viewProj), color, layer);
+}
+
+void DebugDraw::AddShape(Shape shape, const glm::mat4& transform, const glm::vec3& color, Layer layer)
+{
+    uint32_t packed = PackColor(color);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending[(int)layer].Shapes[shape].push_back({ transform, packed });
+}
+
+bool DebugDraw::Initialize()
+{
+    m_shader.Initialize("./shaders/DebugDraw.vert", "./shaders/DebugDraw.frag");
+    if (m_shader.GetProgram() == 0)
+    {
+        std::cerr << "DebugDraw: failed to compile shaders.\n";
+        return false;
+    }
+
+    // Unit shapes in [-1,1]: box edges, three circles, box triangles
+    std::vector<glm::vec3> vertices;
+    m_shapeFirst[ShapeWireBox] = (int)vertices.size();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            glm::vec3 a(0.0f);
+            a[(axis + 1) % 3] = (corner & 1) ? 1.0f : -1.0f;
+            a[(axis + 2) % 3] = (corner & 2) ? 1.0f : -1.0f;
+            glm::vec3 b = a;
+            a[axis] = -1.0f;
+            b[axis] = 1.0f;
+            vertices.push_back(a);
+            vertices.push_back(b);
+        }
+    }
+    m_shapeCount[ShapeWireBox] = (int)vertices.size() - m_shapeFirst[ShapeWireBox];
+
+    m_shapeFirst[ShapeWireSphere] = (int)vertices.size();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        for (int s = 0; s < SPHERE_SEGMENTS; ++s)
+        {
+            for (int k = 0; k < 2; ++k)
+            {
+                float angle = (float)(s + k) / SPHERE_SEGMENTS * 6.28318530718f;
+                glm::vec3 p(0.0f);
+                p[(axis + 1) % 3] = std::cos(angle);
+                p[(axis + 2) % 3] = std::sin(angle);
+                vertices.push_back(p);
+            }
+        }
+    }
+    m_shapeCount[ShapeWireSphere] = (int)vertices.size() - m_shapeFirst[ShapeWireSphere];
+
+    m_shapeFirst[ShapeSolidBox] = (int)vertices.size();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        for (float side : { -1.0f, 1.0f })
+        {
+            // Two counter-clockwise triangles seen from outside (culling may be on)
+            const float quad[6][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, -1 }, { 1, 1 }, { -1, 1 } };
+            int u = side > 0.0f ? 1 : 0;
+            for (const auto& uv : quad)
+            {
+                glm::vec3 p;
+                p[axis] = side;
+                p[(axis + 1) % 3] = uv[1 - u];
+                p[(axis + 2) % 3] = uv[u];
+                vertices.push_back(p);
+            }
+        }
+    }
+    m_shapeCount[ShapeSolidBox] = (int)vertices.size() - m_shapeFirst[ShapeSolidBox];
+
+    glGenBuffers(1, &m_shapeVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_shapeVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &m_fallbackVBO);
+
+    // Lines: position + colour per vertex, pointed at the stream every draw
+    glGenVertexArrays(1, &m_lineVAO);
+    glBindVertexArray(m_lineVAO);
+    glEnableVertexAttribArray(ATTRIB_POSITION);
+    glEnableVertexAttribArray(ATTRIB_COLOR);
+
+    // Shapes: unit mesh per vertex, transform + colour per instance
+    glGenVertexArrays(1, &m_shapeVAO);
+    glBindVertexArray(m_shapeVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_shapeVBO);
+    glVertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(ATTRIB_POSITION);
+    for (GLuint c = 0; c < 4; ++c)
+    {
+        glEnableVertexAttribArray(ATTRIB_TRANSFORM + c);
+        glVertexAttribDivisor(ATTRIB_TRANSFORM + c, 1);
+    }
+    glEnableVertexAttribArray(ATTRIB_INSTANCE_COLOR);
+    glVertexAttribDivisor(ATTRIB_INSTANCE_COLOR, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void DebugDraw::Release()
+{
+    if (m_lineVAO != 0) { glDeleteVertexArrays(1, &m_lineVAO); m_lineVAO = 0; }
+    if (m_shapeVAO != 0) { glDeleteVertexArrays(1, &m_shapeVAO); m_shapeVAO = 0; }
+    if (m_shapeVBO != 0) { glDeleteBuffers(1, &m_shapeVBO); m_shapeVBO = 0; }
+    if (m_fallbackVBO != 0) { glDeleteBuffers(1, &m_fallbackVBO); m_fallbackVBO = 0; }
+}
+
+int DebugDraw::Flush(const glm::mat4& viewProj)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int l = 0; l < LAYER_COUNT; ++l)
+        {
+            std::swap(m_pending[l], m_drawing[l]);
+            m_pending[l].Lines.clear();
+            for (auto& shapes : m_pending[l].Shapes)
+                shapes.clear();
+        }
+    }
+
+    int primitives = 0;
+    for (const Queue& queue : m_drawing)
+    {
+        primitives += (int)queue.Lines.size() / 2;
+        for (const auto& shapes : queue.Shapes)
+            primitives += (int)shapes.size();
+    }
+    if (primitives == 0 || m_shader.GetProgram() == 0)
+        return primitives;
+
+    m_shader.Use();
+    m_shader.SetMat4("u_ViewProj", viewProj);
+    glLineWidth(2.0f);
+
+    glEnable(GL_DEPTH_TEST);
+    DrawQueue(m_drawing[(int)Layer::Depth]);
+    glDisable(GL_DEPTH_TEST);
+    DrawQueue(m_drawing[(int)Layer::Overlay]);
+    glEnable(GL_DEPTH_TEST);
+
+    glLineWidth(1.0f);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return primitives;
+}
+
+void DebugDraw::DrawQueue(const Queue& queue)
+{
+    if (!queue.Lines.empty())
+    {
+        m_shader.SetBool("u_Instanced", false);
+        glBindVertexArray(m_lineVAO);
+        size_t offset = StreamVertices(queue.Lines.data(), queue.Lines.size() * sizeof(LineVertex), m_fallbackVBO);
+        glVertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex),
+                              (void*)(offset + offsetof(LineVertex, Position)));
+        glVertexAttribPointer(ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LineVertex),
+                              (void*)(offset + offsetof(LineVertex, Color)));
+        glDrawArrays(GL_LINES, 0, (GLsizei)queue.Lines.size());
+    }
+
+    m_shader.SetBool("u_Instanced", true);
+    glBindVertexArray(m_shapeVAO);
+    for (int shape = 0; shape < SHAPE_COUNT; ++shape)
+    {
+        const std::vector<ShapeInstance>& instances = queue.Shapes[shape];
+        if (instances.empty())
+            continue;
+
+        size_t offset = StreamVertices(instances.data(), instances.size() * sizeof(ShapeInstance), m_fallbackVBO);
+        for (GLuint c = 0; c < 4; ++c)
+        {
+            glVertexAttribPointer(ATTRIB_TRANSFORM + c, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance),
+                                  (void*)(offset + offsetof(ShapeInstance, Transform) + c * sizeof(glm::vec4)));
+        }
+        glVertexAttribPointer(ATTRIB_INSTANCE_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ShapeInstance),
+                              (void*)(offset + offsetof(ShapeInstance, Color)));
+
+        GLenum mode = shape == ShapeSolidBox ? GL_TRIANGLES : GL_LINES;
+        glDrawArraysInstanced(mode, m_shapeFirst[shape], m_shapeCount[shape], (GLsizei)instances.size());
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Shader.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Immediate-mode debug shapes. Anything in the engine may queue lines,
+// boxes, spheres and frusta during the frame (thread-safe); RenderPipeline
+// draws everything queued so far at the end of its frame and clears it.
+// Each primitive type is one draw per layer: lines as a line list, the
+// shapes as instances of a unit mesh. Vertex and instance data go through
+// the stream buffer, so thousands of primitives cost a copy, not draw calls.
+class DebugDraw
+{
+public:
+    enum class Layer
+    {
+        Depth = 0,      // Hidden behind scene geometry
+        Overlay = 1     // Always on top
+    };
+
+    static DebugDraw& Instance();
+
+    DebugDraw(const DebugDraw&) = delete;
+    DebugDraw& operator=(const DebugDraw&) = delete;
+
+    void Line(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color, Layer layer = Layer::Depth);
+    // Wireframe axis-aligned box
+    void Box(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::vec3& color, Layer layer = Layer::Depth);
+    // Wireframe box spanning [-1,1] in transform's space
+    void Box(const glm::mat4& transform, const glm::vec3& color, Layer layer = Layer::Depth);
+    // Filled box with half size halfExtents (markers, gizmos)
+    void SolidBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& color, Layer layer = Layer::Depth);
+    // Three great circles
+    void Sphere(const glm::vec3& center, float radius, const glm::vec3& color, Layer layer = Layer::Depth);
+    // Edges of the frustum of viewProj (camera, light or cascade)
+    void Frustum(const glm::mat4& viewProj, const glm::vec3& color, Layer layer = Layer::Depth);
+
+    // GL side; must run on the thread that holds the context
+    bool Initialize();
+    void Release();
+    // Draws and clears everything queued. Returns the primitive count.
+    int Flush(const glm::mat4& viewProj);
+
+private:
+    DebugDraw() = default;
+    ~DebugDraw() = default;
+
+    // Interleaved in the stream buffer; attribute layout in DebugDraw.vert
+    struct LineVertex
+    {
+        glm::vec3 Position;
+        uint32_t Color;     // RGBA8
+    };
+    struct ShapeInstance
+    {
+        glm::mat4 Transform;    // Unit shape -> world; w is divided out (frusta)
+        uint32_t Color;
+    };
+
+    enum Shape
+    {
+        ShapeWireBox = 0,
+        ShapeWireSphere,
+        ShapeSolidBox,
+        SHAPE_COUNT
+    };
+    static constexpr int LAYER_COUNT = 2;
+
+    struct Queue
+    {
+        std::vector<LineVertex> Lines;
+        std::vector<ShapeInstance> Shapes[SHAPE_COUNT];
+    };
+
+    static uint32_t PackColor(const glm::vec3& color);
+    void AddShape(Shape shape, const glm::mat4& transform, const glm::vec3& color, Layer layer);
+    void DrawQueue(const Queue& queue);
+
+    // Filled by any thread; swapped with m_drawing under the lock by Flush()
+    std::mutex m_mutex;
+    Queue m_pending[LAYER_COUNT];
+    Queue m_drawing[LAYER_COUNT];
+
+    Shader m_shader;
+    unsigned int m_lineVAO = 0;
+    unsigned int m_shapeVAO = 0;
+    unsigned int m_shapeVBO = 0;      // Unit shapes back to back
+    unsigned int m_fallbackVBO = 0;   // Used when the stream buffer is full
+    int m_shapeFirst[SHAPE_COUNT] = {};
+    int m_shapeCount[SHAPE_COUNT] = {};
+
+    static constexpr int SPHERE_SEGMENTS = 32;
+};
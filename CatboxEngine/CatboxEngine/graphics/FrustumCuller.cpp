@@ -0,0 +1,216 @@
+#include "FrustumCuller.h"
+#include "Mesh.h"
+#include "MeshManager.h"
+#include "TerrainManager.h"
+#include "../resources/EntityManager.h"
+#include "../resources/Transform.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define CATBOX_CULL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    // Boxes that must never be culled (missing or still-loading mesh bounds)
+    constexpr float ALWAYS_VISIBLE_EXTENT = FrustumCuller::ALWAYS_VISIBLE_EXTENT;
+    // Padding lanes: negative extent keeps them outside every plane
+    constexpr float NEVER_VISIBLE_EXTENT = -1e30f;
+
+    int PopCount64(uint64_t v)
+    {
+        int c = 0;
+        while (v) { v &= v - 1; ++c; }
+        return c;
+    }
+}
+
+size_t VisibilitySet::CountVisible() const
+{
+    size_t total = 0;
+    for (uint64_t word : Bits)
+        total += PopCount64(word);
+    return total;
+}
+
+glm::mat4 FrustumCuller::BuildWorldMatrix(const Transform& transform)
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, glm::vec3(transform.Position.x, transform.Position.y, transform.Position.z));
+    model = glm::rotate(model, glm::radians(transform.Rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    model = glm::rotate(model, glm::radians(transform.Rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    model = glm::rotate(model, glm::radians(transform.Rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    model = glm::scale(model, glm::vec3(transform.Scale.x, transform.Scale.y, transform.Scale.z));
+    return model;
+}
+
+void FrustumCuller::Gather(const EntityManager& entityManager)
+{
+    const auto& entities = entityManager.GetAll();
+    bool countChanged = entities.size() != m_count || m_versions.size() != entities.size();
+    m_count = entities.size();
+    size_t padded = (m_count + 3) & ~size_t(3);
+    ++m_frame;
+
+    m_prevWorldMatrices.swap(m_worldMatrices);
+    m_prevCenterX.swap(m_centerX);
+    m_prevCenterY.swap(m_centerY);
+    m_prevCenterZ.swap(m_centerZ);
+    m_prevExtentX.swap(m_extentX);
+    m_prevExtentY.swap(m_extentY);
+    m_prevExtentZ.swap(m_extentZ);
+
+    m_worldMatrices.resize(m_count);
+    m_meshes.resize(m_count);
+    m_terrains.resize(m_count);
+    m_centerX.assign(padded, 0.0f);
+    m_centerY.assign(padded, 0.0f);
+    m_centerZ.assign(padded, 0.0f);
+    m_extentX.assign(padded, NEVER_VISIBLE_EXTENT);
+    m_extentY.assign(padded, NEVER_VISIBLE_EXTENT);
+    m_extentZ.assign(padded, NEVER_VISIBLE_EXTENT);
+
+    auto& meshManager = MeshManager::Instance();
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        const Entity& e = entities[i];
+        const glm::mat4& model = m_worldMatrices[i] = BuildWorldMatrix(e.Transform);
+
+        Mesh* mesh = m_meshes[i] = e.MeshHandle ? meshManager.GetMesh(e.MeshHandle) : nullptr;
+        m_terrains[i] = TerrainManager::Instance().Get(e.TerrainChunks);
+        bool validBounds = mesh && (mesh->BoundsMin.x != FLT_MAX) && (mesh->BoundsMax.x != -FLT_MAX);
+        if (!validBounds)
+        {
+            m_extentX[i] = m_extentY[i] = m_extentZ[i] = ALWAYS_VISIBLE_EXTENT;
+            continue;
+        }
+
+        // Transform the local box as centre/extent: the world extent is the
+        // local extent projected through |M|, which stays tight under rotation.
+        glm::vec3 bmin(mesh->BoundsMin.x, mesh->BoundsMin.y, mesh->BoundsMin.z);
+        glm::vec3 bmax(mesh->BoundsMax.x, mesh->BoundsMax.y, mesh->BoundsMax.z);
+        glm::vec3 c = (bmin + bmax) * 0.5f;
+        glm::vec3 ext = (bmax - bmin) * 0.5f;
+
+        glm::vec3 wc = glm::vec3(model * glm::vec4(c, 1.0f));
+        glm::vec3 we;
+        we.x = std::abs(model[0][0]) * ext.x + std::abs(model[1][0]) * ext.y + std::abs(model[2][0]) * ext.z;
+        we.y = std::abs(model[0][1]) * ext.x + std::abs(model[1][1]) * ext.y + std::abs(model[2][1]) * ext.z;
+        we.z = std::abs(model[0][2]) * ext.x + std::abs(model[1][2]) * ext.y + std::abs(model[2][2]) * ext.z;
+
+        m_centerX[i] = wc.x; m_centerY[i] = wc.y; m_centerZ[i] = wc.z;
+        m_extentX[i] = we.x; m_extentY[i] = we.y; m_extentZ[i] = we.z;
+    }
+
+    if (countChanged)
+    {
+        // Indices no longer line up with last frame: give everyone a fresh
+        // version, but don't treat the whole scene as moving
+        m_versions.resize(m_count);
+        m_movedFrame.resize(m_count, m_frame);
+        for (size_t i = 0; i < m_count; ++i)
+            m_versions[i] = m_nextVersion++;
+        return;
+    }
+
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        if (m_worldMatrices[i] != m_prevWorldMatrices[i] ||
+            m_centerX[i] != m_prevCenterX[i] || m_centerY[i] != m_prevCenterY[i] || m_centerZ[i] != m_prevCenterZ[i] ||
+            m_extentX[i] != m_prevExtentX[i] || m_extentY[i] != m_prevExtentY[i] || m_extentZ[i] != m_prevExtentZ[i])
+        {
+            m_versions[i] = m_nextVersion++;
+            m_movedFrame[i] = m_frame;
+        }
+    }
+}
+
+void FrustumCuller::Cull(const Frustum* frusta, int viewCount, MultiViewVisibility& out) const
+{
+    if (viewCount > MultiViewVisibility::MAX_VIEWS) viewCount = MultiViewVisibility::MAX_VIEWS;
+    out.Resize(m_count, viewCount);
+    if (m_count == 0 || viewCount == 0) return;
+
+#ifdef CATBOX_CULL_SSE
+    // Splat every view's planes once
+    struct SplatPlane { __m128 nx, ny, nz, nw, ax, ay, az; };
+    SplatPlane planes[MultiViewVisibility::MAX_VIEWS][6];
+    for (int v = 0; v < viewCount; ++v)
+    {
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4& pl = frusta[v].planes[p];
+            SplatPlane& s = planes[v][p];
+            s.nx = _mm_set1_ps(pl.x);
+            s.ny = _mm_set1_ps(pl.y);
+            s.nz = _mm_set1_ps(pl.z);
+            s.nw = _mm_set1_ps(pl.w);
+            s.ax = _mm_set1_ps(std::abs(pl.x));
+            s.ay = _mm_set1_ps(std::abs(pl.y));
+            s.az = _mm_set1_ps(std::abs(pl.z));
+        }
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t padded = m_centerX.size();
+    for (size_t i = 0; i < padded; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(&m_centerX[i]);
+        __m128 cy = _mm_loadu_ps(&m_centerY[i]);
+        __m128 cz = _mm_loadu_ps(&m_centerZ[i]);
+        __m128 ex = _mm_loadu_ps(&m_extentX[i]);
+        __m128 ey = _mm_loadu_ps(&m_extentY[i]);
+        __m128 ez = _mm_loadu_ps(&m_extentZ[i]);
+
+        for (int v = 0; v < viewCount; ++v)
+        {
+            __m128 inside = _mm_cmpeq_ps(zero, zero);  // all lanes true
+            for (int p = 0; p < 6; ++p)
+            {
+                // signed distance of the centre + projected radius of the box
+                const SplatPlane& s = planes[v][p];
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(s.nx, cx), _mm_mul_ps(s.ny, cy)),
+                                      _mm_add_ps(_mm_mul_ps(s.nz, cz), s.nw));
+                __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(s.ax, ex), _mm_mul_ps(s.ay, ey)),
+                                      _mm_mul_ps(s.az, ez));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), zero));
+            }
+
+            // i is a multiple of 4, so the four bits never straddle a word
+            uint64_t mask = (uint64_t)_mm_movemask_ps(inside);
+            out.Views[v].Bits[i >> 6] |= mask << (i & 63);
+        }
+    }
+
+    // Clear padding lanes so Bits only describes real entities
+    if (m_count & 63)
+    {
+        for (int v = 0; v < viewCount; ++v)
+            out.Views[v].Bits.back() &= (1ull << (m_count & 63)) - 1;
+    }
+#else
+    CullScalar(frusta, viewCount, out);
+#endif
+}
+
+void FrustumCuller::CullScalar(const Frustum* frusta, int viewCount, MultiViewVisibility& out) const
+{
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        for (int v = 0; v < viewCount; ++v)
+        {
+            bool inside = true;
+            for (int p = 0; p < 6 && inside; ++p)
+            {
+                const glm::vec4& pl = frusta[v].planes[p];
+                float d = pl.x * m_centerX[i] + pl.y * m_centerY[i] + pl.z * m_centerZ[i] + pl.w;
+                float r = std::abs(pl.x) * m_extentX[i] + std::abs(pl.y) * m_extentY[i] + std::abs(pl.z) * m_extentZ[i];
+                inside = (d + r) >= 0.0f;
+            }
+            if (inside) out.Views[v].Set(i);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "../resources/Camera.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class EntityManager;
+struct Mesh;
+class TerrainQuadtree;
+
+// One bit per entity, indexed like EntityManager::GetAll()
+struct VisibilitySet
+{
+    std::vector<uint64_t> Bits;
+    size_t Count = 0;
+
+    void Resize(size_t count)
+    {
+        Count = count;
+        Bits.assign((count + 63) / 64, 0);
+    }
+    void Set(size_t i) { Bits[i >> 6] |= (1ull << (i & 63)); }
+    void Clear(size_t i) { Bits[i >> 6] &= ~(1ull << (i & 63)); }
+    bool Test(size_t i) const { return i < Count && ((Bits[i >> 6] >> (i & 63)) & 1ull) != 0; }
+    size_t CountVisible() const;
+};
+
+// Per-view visibility from a single culling pass.
+// View 0 is the camera; views 1.. are shadow maps (one per cascade).
+struct MultiViewVisibility
+{
+    static constexpr int MAX_VIEWS = 32;
+
+    VisibilitySet Views[MAX_VIEWS];
+    int ViewCount = 0;
+
+    void Resize(size_t count, int viewCount)
+    {
+        ViewCount = viewCount;
+        for (int v = 0; v < viewCount; ++v)
+            Views[v].Resize(count);
+    }
+    bool Test(size_t i, int view) const { return view < ViewCount && Views[view].Test(i); }
+};
+
+// Batch frustum culler.
+// Gather() builds every entity's world matrix and world-space AABB once per
+// frame and stores the boxes as centre/extent in SoA arrays. Cull() then
+// loads four boxes at a time and tests them against every view's planes
+// (SSE when available), so each box is read once however many views exist.
+class FrustumCuller
+{
+public:
+    // Rebuild world matrices and bounds from the current entity transforms,
+    // and resolve each entity's mesh and terrain chunks
+    void Gather(const EntityManager& entityManager);
+
+    // Test every gathered box against viewCount frusta in one pass
+    void Cull(const Frustum* frusta, int viewCount, MultiViewVisibility& out) const;
+
+    size_t GetCount() const { return m_count; }
+    const glm::mat4& GetWorldMatrix(size_t index) const { return m_worldMatrices[index]; }
+    // Mesh and terrain chunks of a gathered entity, or nullptr. Looked up once
+    // in Gather() so worker threads can read them without the managers' locks.
+    Mesh* GetMesh(size_t index) const { return m_meshes[index]; }
+    TerrainQuadtree* GetTerrain(size_t index) const { return m_terrains[index]; }
+
+    // World AABB of a gathered entity
+    glm::vec3 GetBoundsMin(size_t index) const
+    {
+        return { m_centerX[index] - m_extentX[index], m_centerY[index] - m_extentY[index], m_centerZ[index] - m_extentZ[index] };
+    }
+    glm::vec3 GetBoundsMax(size_t index) const
+    {
+        return { m_centerX[index] + m_extentX[index], m_centerY[index] + m_extentY[index], m_centerZ[index] + m_extentZ[index] };
+    }
+    // True for entities without usable bounds; they are never culled
+    bool IsUnbounded(size_t index) const { return m_extentX[index] >= ALWAYS_VISIBLE_EXTENT; }
+
+    // Transform versioning: an entity's version changes whenever its world
+    // matrix or bounds do, and every version changes when entities are added
+    // or removed (indices shift). Caches compare versions instead of matrices.
+    uint64_t GetTransformVersion(size_t index) const { return m_versions[index]; }
+    uint64_t GetFramesSinceMoved(size_t index) const { return m_frame - m_movedFrame[index]; }
+
+    static constexpr float ALWAYS_VISIBLE_EXTENT = 1e30f;
+
+    // Model matrix used by every pass: T * Rx * Ry * Rz * S
+    static glm::mat4 BuildWorldMatrix(const struct Transform& transform);
+
+private:
+    size_t m_count = 0;
+
+    // Padded to a multiple of 4; padding boxes can never be visible
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_extentX, m_extentY, m_extentZ;
+
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<Mesh*> m_meshes;
+    std::vector<TerrainQuadtree*> m_terrains;
+
+    // Last frame's matrices and boxes, compared against to detect movement
+    std::vector<glm::mat4> m_prevWorldMatrices;
+    std::vector<float> m_prevCenterX, m_prevCenterY, m_prevCenterZ;
+    std::vector<float> m_prevExtentX, m_prevExtentY, m_prevExtentZ;
+    std::vector<uint64_t> m_versions;
+    std::vector<uint64_t> m_movedFrame;
+    uint64_t m_nextVersion = 1;
+    uint64_t m_frame = 0;
+
+    void CullScalar(const Frustum* frusta, int viewCount, MultiViewVisibility& out) const;
+};
@@ -0,0 +1,65 @@
+#include "GpuTimer.h"
+#include <glad/glad.h>
+
+GpuTimer::~GpuTimer()
+{
+    Release();
+}
+
+void GpuTimer::Release()
+{
+    if (m_queries[0] != 0)
+    {
+        glDeleteQueries(QUERY_COUNT, m_queries);
+        for (int i = 0; i < QUERY_COUNT; ++i)
+        {
+            m_queries[i] = 0;
+            m_pending[i] = false;
+        }
+    }
+    m_active = false;
+}
+
+void GpuTimer::Collect()
+{
+    // Oldest first, stopping at the first one the GPU has not finished
+    for (int n = 1; n <= QUERY_COUNT; ++n)
+    {
+        int i = (m_current + n) % QUERY_COUNT;
+        if (!m_pending[i])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(m_queries[i], GL_QUERY_RESULT, &nanoseconds);
+        m_milliseconds = (float)(nanoseconds / 1.0e6);
+        m_pending[i] = false;
+    }
+}
+
+void GpuTimer::Begin()
+{
+    if (m_queries[0] == 0)
+        glGenQueries(QUERY_COUNT, m_queries);
+
+    Collect();
+
+    // A query still in flight after a full ring is simply overwritten
+    m_current = (m_current + 1) % QUERY_COUNT;
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current]);
+    m_active = true;
+}
+
+void GpuTimer::End()
+{
+    if (!m_active)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_current] = true;
+    m_active = false;
+}
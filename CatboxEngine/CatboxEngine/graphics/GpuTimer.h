@@ -0,0 +1,32 @@
+#pragma once
+
+// Measures GPU time between Begin() and End() with GL_TIME_ELAPSED queries.
+// Results are collected from a small ring of queries a few frames later, so
+// reading them never stalls the CPU on the GPU. Timers must not overlap.
+class GpuTimer
+{
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void Begin();
+    void End();
+    void Release();
+
+    // Latest completed measurement in milliseconds (0 until one is available)
+    float GetMilliseconds() const { return m_milliseconds; }
+
+private:
+    static constexpr int QUERY_COUNT = 4;
+
+    unsigned int m_queries[QUERY_COUNT] = {};
+    bool m_pending[QUERY_COUNT] = {};
+    int m_current = 0;
+    bool m_active = false;
+    float m_milliseconds = 0.0f;
+
+    void Collect();
+};
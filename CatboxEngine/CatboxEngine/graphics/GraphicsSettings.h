@@ -9,6 +9,12 @@ enum class TextureFilterMode
     Trilinear = 3       // GL_LINEAR_MIPMAP_LINEAR (best quality)
 };
 
+enum class RenderPath
+{
+    Forward = 0,        // Shade while drawing, lights culled per 3D cluster
+    Deferred = 1        // G-buffer, then one tiled lighting pass
+};
+
 class GraphicsSettings
 {
 public:
@@ -21,6 +27,11 @@ public:
     float AnisotropicFiltering = 16.0f;  // 0 = disabled, 1-16 = level
     int MaxMipmapLevel = 1000;  // -1 = all levels
 
+    // Cook textures to BCn with precomputed mips (see TextureCooker). High
+    // quality encodes colour as BC7 instead of BC1/BC3: twice the memory of BC1.
+    bool CompressTextures = true;
+    bool HighQualityCompression = false;
+
     // Apply settings to a texture
     void ApplyToTexture(unsigned int textureID);
 
@@ -28,6 +39,30 @@ public:
     int GetGLMinFilter(TextureFilterMode mode, bool useMipmaps);
     int GetGLMagFilter(TextureFilterMode mode);
 
+    // Lighting path, switchable at runtime
+    RenderPath Path = RenderPath::Forward;
+
+    // Forward path: lay down depth with a position-only program first, then
+    // shade with GL_LEQUAL and depth writes off so each pixel is shaded once.
+    // Pays off where overdraw dominates; costs an extra geometry pass elsewhere.
+    bool DepthPrepass = false;
+
+    // Hide entities behind large occluders (CPU depth buffer, see OcclusionCuller)
+    bool OcclusionCulling = true;
+
+    // Mesh levels of detail (generated at import). Bias scales the on-screen
+    // size used for selection: above 1 keeps full detail further away.
+    bool MeshLOD = true;
+    float LODBias = 1.0f;
+
+    // Draw on a render thread from a per-frame snapshot while the main thread
+    // simulates the next frame (see core/RenderThread.h). Off = update and
+    // render one after the other on the main thread, easier to debug.
+    bool ThreadedRendering = true;
+
+    // Debug draw every entity's bounds: green if the camera sees it, red if culled
+    bool DebugDrawBounds = false;
+
     // Skybox settings
     bool  SkyboxEnabled      = true;
     bool  SkyboxProcedural   = true;   // false = use mesh file below
@@ -38,6 +73,10 @@ public:
     std::string SkyboxFilePath;
     bool  SkyboxFileDirty = false;  // set to true to trigger a reload in RenderPipeline
 
+    // Shadow settings
+    bool ShadowCaching      = true;  // Reuse shadow tiles whose light and casters did not change
+    int  ShadowUpdateBudget = 2;     // Tile updates per frame for distant lights / far cascades
+
 private:
     GraphicsSettings() = default;
     ~GraphicsSettings() = default;
@@ -1,8 +1,12 @@
 #pragma once
 #include "../resources/Math/Vec3.h"
+#include "ShadowAtlas.h"
 #include <string>
 #include <glm/glm.hpp>
 
+// Cascades per directional light (FragmentShader.frag packs splits in a vec4)
+constexpr int MAX_SHADOW_CASCADES = 4;
+
 enum class LightType
 {
     Directional,
@@ -32,9 +36,7 @@ struct Light
     
     // Shadow properties
     bool CastsShadows = true;
-    int ShadowMapSize = 1024;
-    unsigned int ShadowMapFBO = 0;
-    unsigned int ShadowMapTexture = 0;
+    int ShadowMapSize = 1024;        // Largest atlas tile this light may get
     float ShadowBias = 0.005f;
     glm::mat4 LightSpaceMatrix;      // Light's view-projection matrix
     
@@ -43,6 +45,26 @@ struct Light
     float ShadowNearPlane = 1.0f;
     float ShadowFarPlane = 50.0f;
     
+    // Cascaded shadows for directional lights: the camera frustum up to
+    // ShadowDistance is split into CascadeCount slices, each with its own
+    // ortho map. 0 cascades falls back to the fixed ShadowOrthoSize box.
+    int CascadeCount = 3;
+    float ShadowDistance = 80.0f;
+    float CascadeSplitLambda = 0.75f;  // 0 = uniform splits, 1 = logarithmic
+    float CascadeCasterRange = 50.0f;  // How far towards the light casters are kept
+    
+    // Filled in each frame by LightManager / RenderPipeline
+    glm::mat4 CascadeMatrices[MAX_SHADOW_CASCADES];
+    float CascadeSplits[MAX_SHADOW_CASCADES] = {};  // Far view depth of each cascade
+    
+    // Shadow atlas tiles (one per cascade), assigned each frame by LightManager
+    int ShadowTileCount = 0;
+    ShadowAtlasTile ShadowTiles[MAX_SHADOW_CASCADES];
+    ShadowTileCache ShadowCache[MAX_SHADOW_CASCADES];  // Maintained by RenderPipeline::ShadowPass
+    float ShadowImportance = 0.0f;   // Screen coverage estimate used to size tiles
+    
+    bool UsesCascades() const { return Type == LightType::Directional && CascadeCount > 0; }
+    
     // For point/spot lights (perspective projection)
     float ShadowFOV = 120.0f;  // Wider FOV for better coverage (was 90)
     
@@ -0,0 +1,87 @@
+#include "LightBuffer.h"
+#include "LightManager.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+LightBuffer::~LightBuffer()
+{
+    Release();
+}
+
+void LightBuffer::Release()
+{
+    if (m_buffer != 0) { glDeleteBuffers(1, &m_buffer); m_buffer = 0; }
+    m_range = StreamRange();
+    m_lights.clear();
+}
+
+void LightBuffer::Update(const std::vector<Light>& lights, const ShadowTileTable& shadows)
+{
+    m_lights.clear();
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        const Light& light = lights[i];
+        if (!light.Enabled)
+            continue;
+
+        float range = LightManager::ComputeLightRange(light);
+        if (range <= 0.0f)
+            continue;
+
+        GPULight gpu;
+        gpu.PositionRange = glm::vec4(light.Position.x, light.Position.y, light.Position.z, range == FLT_MAX ? 0.0f : range);
+        gpu.DirectionType = glm::vec4(light.Direction.x, light.Direction.y, light.Direction.z, (float)light.Type);
+        gpu.ColorIntensity = glm::vec4(light.Color.x, light.Color.y, light.Color.z, light.Intensity);
+        gpu.Attenuation = glm::vec4(light.Constant, light.Linear, light.Quadratic, light.ShadowBias);
+        gpu.Spot = glm::vec4(std::cos(glm::radians(light.InnerCutoff)), std::cos(glm::radians(light.OuterCutoff)),
+                             (float)shadows.GetFirstTile(i), (float)shadows.GetCascadeCount(i));
+        gpu.CascadeSplits = glm::vec4(light.CascadeSplits[0], light.CascadeSplits[1],
+                                      light.CascadeSplits[2], light.CascadeSplits[3]);
+        m_lights.push_back(gpu);
+    }
+
+    m_range = StreamBuffer::Instance().UploadStorage(m_buffer, m_lights.data(), m_lights.size() * sizeof(GPULight));
+}
+
+void LightBuffer::Bind() const
+{
+    StreamBuffer::BindStorage(BINDING, m_range);
+}
+
+bool LightBuffer::ProjectSphere(const glm::vec3& viewCenter, float radius, const glm::mat4& proj,
+                                float nearPlane, float farPlane, glm::vec2& ndcMin, glm::vec2& ndcMax)
+{
+    // Entirely behind the near plane or beyond the far plane
+    if (viewCenter.z - radius > -nearPlane || viewCenter.z + radius < -farPlane)
+        return false;
+
+    if (viewCenter.z + radius > -nearPlane)
+    {
+        // Camera inside or next to the sphere: it can cover any pixel
+        ndcMin = glm::vec2(-1.0f);
+        ndcMax = glm::vec2(1.0f);
+        return true;
+    }
+
+    // Project the corners of the sphere's view-space box (all in front of the camera)
+    ndcMin = glm::vec2(FLT_MAX);
+    ndcMax = glm::vec2(-FLT_MAX);
+    for (int c = 0; c < 8; ++c)
+    {
+        glm::vec3 corner = viewCenter + glm::vec3((c & 1) ? radius : -radius,
+                                                  (c & 2) ? radius : -radius,
+                                                  (c & 4) ? radius : -radius);
+        glm::vec4 clip = proj * glm::vec4(corner, 1.0f);
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+    if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f)
+        return false;
+
+    ndcMin = glm::max(ndcMin, glm::vec2(-1.0f));
+    ndcMax = glm::min(ndcMax, glm::vec2(1.0f));
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Light.h"
+#include "ShadowAtlas.h"
+#include "StreamBuffer.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// std430 layout of GPULight in FragmentShader.frag and lighting.frag
+struct GPULight
+{
+    glm::vec4 PositionRange;   // xyz position, w = range (0 for global lights)
+    glm::vec4 DirectionType;   // xyz direction, w = LightType
+    glm::vec4 ColorIntensity;  // rgb color, w = intensity
+    glm::vec4 Attenuation;     // constant, linear, quadratic, shadow bias
+    glm::vec4 Spot;            // cos inner, cos outer, first shadow tile (-1 = none), cascade count
+    glm::vec4 CascadeSplits;
+};
+
+// Every enabled light of the frame, packed once into a shader storage buffer
+// that the forward (clustered) and deferred (tiled) paths both read. There is
+// no upper bound on the light count; passes only bin the lights into their
+// own screen tiles / clusters.
+class LightBuffer
+{
+public:
+    LightBuffer() = default;
+    ~LightBuffer();
+
+    LightBuffer(const LightBuffer&) = delete;
+    LightBuffer& operator=(const LightBuffer&) = delete;
+
+    // Packs enabled lights with their attenuation range and shadow tiles, then uploads
+    void Update(const std::vector<Light>& lights, const ShadowTileTable& shadows);
+    void Release();
+
+    // Binds the storage buffer at BINDING
+    void Bind() const;
+
+    size_t GetCount() const { return m_lights.size(); }
+    const GPULight& GetLight(size_t i) const { return m_lights[i]; }
+
+    // Reaches every pixel (directional or unattenuated): never binned
+    bool IsGlobal(size_t i) const { return m_lights[i].PositionRange.w <= 0.0f; }
+
+    // Screen bounds of a light's range sphere given its view-space centre.
+    // False when it cannot touch the view; NDC [-1,1] when the camera is inside.
+    static bool ProjectSphere(const glm::vec3& viewCenter, float radius, const glm::mat4& proj,
+                              float nearPlane, float farPlane, glm::vec2& ndcMin, glm::vec2& ndcMax);
+
+    static constexpr unsigned int BINDING = 0;
+
+private:
+    std::vector<GPULight> m_lights;
+    StreamRange m_range;
+    unsigned int m_buffer = 0;  // Used when the stream buffer is full
+};
@@ -1,5 +1,8 @@
 #include "LightManager.h"
 #include <glad/glad.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <iostream>
 
 LightManager::~LightManager()
@@ -12,11 +15,10 @@ size_t LightManager::AddLight(const Light& light)
     m_lights.push_back(light);
     size_t index = m_lights.size() - 1;
     
-    // Create shadow map if needed
-    if (m_lights[index].CastsShadows)
-    {
-        CreateShadowMap(m_lights[index]);
-    }
+    // Atlas tiles are handed out by UpdateShadowResources; never share a copy's
+    m_lights[index].ShadowTileCount = 0;
+    for (auto& cache : m_lights[index].ShadowCache)
+        cache = ShadowTileCache();
     
     return index;
 }
@@ -26,16 +28,16 @@ void LightManager::RemoveLight(size_t index)
     if (index >= m_lights.size())
         return;
     
-    DeleteShadowMap(m_lights[index]);
+    FreeShadowTiles(m_lights[index]);
     m_lights.erase(m_lights.begin() + index);
 }
 
 void LightManager::ClearLights()
 {
-    // Delete all shadow maps first
+    // Return all atlas tiles first
     for (auto& light : m_lights)
     {
-        DeleteShadowMap(light);
+        FreeShadowTiles(light);
     }
     
     m_lights.clear();
@@ -55,66 +57,83 @@ const Light* LightManager::GetLight(size_t index) const
     return &m_lights[index];
 }
 
-void LightManager::CreateShadowMap(Light& light)
+void LightManager::FreeShadowTiles(Light& light)
 {
-    // Create framebuffer
-    glGenFramebuffers(1, &light.ShadowMapFBO);
-    
-    // Create depth texture
-    glGenTextures(1, &light.ShadowMapTexture);
-    glBindTexture(GL_TEXTURE_2D, light.ShadowMapTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, 
-                 light.ShadowMapSize, light.ShadowMapSize, 0, 
-                 GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    
-    // Attach depth texture to framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, light.ShadowMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, 
-                           GL_TEXTURE_2D, light.ShadowMapTexture, 0);
-    
-    // No color buffer needed
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    
-    // Check framebuffer status
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    for (int t = 0; t < light.ShadowTileCount; ++t)
     {
-        std::cerr << "Shadow map framebuffer incomplete!" << std::endl;
+        m_shadowAtlas.Free(light.ShadowTiles[t]);
+        light.ShadowTiles[t] = ShadowAtlasTile();
+        light.ShadowCache[t] = ShadowTileCache();  // Tile may be handed to another light
     }
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    light.ShadowTileCount = 0;
 }
 
-void LightManager::DeleteShadowMap(Light& light)
+bool LightManager::AllocateShadowTiles(Light& light, int count, int size)
 {
-    if (light.ShadowMapFBO != 0)
+    for (int t = 0; t < count; ++t)
     {
-        glDeleteFramebuffers(1, &light.ShadowMapFBO);
-        light.ShadowMapFBO = 0;
+        light.ShadowTiles[t] = m_shadowAtlas.Allocate(size);
+        light.ShadowTileCount = t + 1;
+        if (!light.ShadowTiles[t].IsValid())
+        {
+            FreeShadowTiles(light);
+            return false;
+        }
     }
+    return true;
+}
+
+float LightManager::ComputeLightRange(const Light& light)
+{
+    if (light.Type == LightType::Directional)
+        return FLT_MAX;
+    
+    // Solve constant + linear*d + quadratic*d^2 = 256 * intensity
+    float threshold = 256.0f * light.Intensity;
+    if (light.Quadratic > 0.0f)
+    {
+        float c = light.Constant - threshold;
+        float discriminant = light.Linear * light.Linear - 4.0f * light.Quadratic * c;
+        return discriminant > 0.0f ? std::max((-light.Linear + std::sqrt(discriminant)) / (2.0f * light.Quadratic), 0.0f) : 0.0f;
+    }
+    if (light.Linear > 0.0f)
+        return std::max((threshold - light.Constant) / light.Linear, 0.0f);
+    return FLT_MAX;
+}
+
+float LightManager::ComputeShadowImportance(const Light& light, const Camera& camera, const Frustum& frustum)
+{
+    // Directional shadows cover the whole view
+    if (light.Type == LightType::Directional)
+        return 1.0f;
+    
+    // Shadows only matter where the light still reaches
+    float range = std::min(light.ShadowFarPlane, ComputeLightRange(light));
+    if (range <= 0.0f)
+        return 0.0f;
     
-    if (light.ShadowMapTexture != 0)
+    glm::vec3 position(light.Position.x, light.Position.y, light.Position.z);
+    for (const glm::vec4& plane : frustum.planes)
     {
-        glDeleteTextures(1, &light.ShadowMapTexture);
-        light.ShadowMapTexture = 0;
+        if (glm::dot(glm::vec3(plane), position) + plane.w < -range)
+            return 0.0f;
     }
+    
+    // Projected radius of the lit sphere relative to the screen height
+    glm::vec3 cameraPos(camera.Position.x, camera.Position.y, camera.Position.z);
+    float distance = glm::length(position - cameraPos);
+    if (distance <= range)
+        return 1.0f;
+    
+    float coverage = range / (distance * std::tan(glm::radians(camera.FOV) * 0.5f));
+    return std::clamp(coverage, 0.0f, 1.0f);
 }
 
 void LightManager::InitializeShadowMaps()
 {
-    for (auto& light : m_lights)
+    if (m_shadowAtlas.GetTexture() == 0)
     {
-        if (light.CastsShadows && light.ShadowMapFBO == 0)
-        {
-            CreateShadowMap(light);
-        }
+        m_shadowAtlas.Initialize(SHADOW_ATLAS_SIZE, MIN_SHADOW_TILE_SIZE);
     }
 }
 
@@ -122,7 +141,130 @@ void LightManager::CleanupShadowMaps()
 {
     for (auto& light : m_lights)
     {
-        DeleteShadowMap(light);
+        light.ShadowTileCount = 0;
+        for (auto& cache : light.ShadowCache)
+            cache = ShadowTileCache();
+    }
+    m_shadowAtlas.Release();
+}
+
+void LightManager::SetShadowCaching(bool enabled)
+{
+    // A new copy is empty: no tile may reuse static depth drawn before
+    if (!m_shadowAtlas.SetStaticCopyEnabled(enabled))
+        return;
+    for (auto& light : m_lights)
+    {
+        for (auto& cache : light.ShadowCache)
+            cache.StaticValid = false;
+    }
+}
+
+void LightManager::UpdateShadowResources(const Camera& camera, size_t maxLights)
+{
+    InitializeShadowMaps();
+    
+    Frustum frustum = camera.GetFrustum();
+    
+    struct TileRequest
+    {
+        size_t LightIndex;
+        int Count;
+        int Size;
+    };
+    std::vector<TileRequest> requests;
+    
+    for (size_t i = 0; i < m_lights.size(); ++i)
+    {
+        Light& light = m_lights[i];
+        light.ShadowImportance = 0.0f;
+        
+        int count = 0;
+        if (i < maxLights && light.CastsShadows && light.Enabled)
+        {
+            light.ShadowImportance = ComputeShadowImportance(light, camera, frustum);
+            if (light.ShadowImportance > 0.0f)
+                count = light.UsesCascades() ? std::min(light.CascadeCount, MAX_SHADOW_CASCADES) : 1;
+        }
+        
+        float idealSize = light.ShadowMapSize * light.ShadowImportance;
+        int size = std::min(m_shadowAtlas.RoundTileSize((int)idealSize), m_shadowAtlas.RoundTileSize(light.ShadowMapSize));
+        
+        // Grow straight away but only shrink once clearly too big, so a light
+        // hovering near a size boundary keeps its tile
+        if (count > 0 && count == light.ShadowTileCount)
+        {
+            int current = light.ShadowTiles[0].Size;
+            bool tooSmall = size > current;
+            bool tooBig = current > m_shadowAtlas.RoundTileSize(light.ShadowMapSize) ||
+                          (current > m_shadowAtlas.GetMinTileSize() && idealSize < current * 0.35f);
+            if (!tooSmall && !tooBig)
+                continue;
+        }
+        
+        FreeShadowTiles(light);
+        if (count > 0)
+            requests.push_back({ i, count, size });
+    }
+    
+    if (requests.empty())
+        return;
+    
+    // Most important lights pick first; a request that does not fit falls back
+    // to smaller tiles before giving up
+    auto byImportance = [this](const TileRequest& a, const TileRequest& b)
+    {
+        return m_lights[a.LightIndex].ShadowImportance > m_lights[b.LightIndex].ShadowImportance;
+    };
+    std::stable_sort(requests.begin(), requests.end(), byImportance);
+    
+    float droppedImportance = 0.0f;
+    for (const TileRequest& request : requests)
+    {
+        Light& light = m_lights[request.LightIndex];
+        int size = request.Size;
+        while (!AllocateShadowTiles(light, request.Count, size) && size > m_shadowAtlas.GetMinTileSize())
+            size /= 2;
+        if (light.ShadowTileCount == 0)
+            droppedImportance = std::max(droppedImportance, light.ShadowImportance);
+    }
+    
+    if (droppedImportance <= 0.0f)
+        return;
+    
+    // A light went without shadows: repack from scratch if a less important
+    // light is holding tiles, otherwise the atlas is simply full
+    bool repack = false;
+    for (const Light& light : m_lights)
+    {
+        if (light.ShadowTileCount > 0 && light.ShadowImportance < droppedImportance)
+            repack = true;
+    }
+    if (!repack)
+        return;
+    
+    requests.clear();
+    for (size_t i = 0; i < m_lights.size(); ++i)
+    {
+        Light& light = m_lights[i];
+        light.ShadowTileCount = 0;
+        for (auto& cache : light.ShadowCache)
+            cache = ShadowTileCache();
+        if (light.ShadowImportance <= 0.0f)
+            continue;
+        
+        int count = light.UsesCascades() ? std::min(light.CascadeCount, MAX_SHADOW_CASCADES) : 1;
+        requests.push_back({ i, count, m_shadowAtlas.RoundTileSize((int)(light.ShadowMapSize * light.ShadowImportance)) });
+    }
+    m_shadowAtlas.Clear();
+    std::stable_sort(requests.begin(), requests.end(), byImportance);
+    
+    for (const TileRequest& request : requests)
+    {
+        Light& light = m_lights[request.LightIndex];
+        int size = std::min(request.Size, m_shadowAtlas.RoundTileSize(light.ShadowMapSize));
+        while (!AllocateShadowTiles(light, request.Count, size) && size > m_shadowAtlas.GetMinTileSize())
+            size /= 2;
     }
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 #include "Light.h"
+#include "ShadowAtlas.h"
+#include "../resources/Camera.h"
 #include <vector>
 #include <memory>
 
@@ -27,8 +29,24 @@ public:
     // Shadow map management
     void InitializeShadowMaps();
     void CleanupShadowMaps();
+    // Keeps the atlas's static-caster copy only while shadow caching is on
+    void SetShadowCaching(bool enabled);
     void UpdateShadowMap(size_t lightIndex, class Camera& camera);
     
+    // Per-frame sync: rates the first maxLights shadow casters by screen
+    // coverage and (re)assigns their atlas tiles. Tiles are kept while the
+    // wanted size stays close, so most frames allocate nothing.
+    void UpdateShadowResources(const Camera& camera, size_t maxLights);
+    
+    // Every shadow map is a tile of this atlas
+    static constexpr int SHADOW_ATLAS_SIZE = 4096;
+    static constexpr int MIN_SHADOW_TILE_SIZE = 128;
+    const ShadowAtlas& GetShadowAtlas() const { return m_shadowAtlas; }
+    
+    // Distance at which a light falls to 1/256 of its intensity; FLT_MAX for
+    // directional lights and lights without distance attenuation
+    static float ComputeLightRange(const Light& light);
+    
     // Create default lights
     void CreateDefaultLights();
 
@@ -38,8 +56,11 @@ private:
     LightManager(const LightManager&) = delete;
     LightManager& operator=(const LightManager&) = delete;
     
-    void CreateShadowMap(Light& light);
-    void DeleteShadowMap(Light& light);
+    void FreeShadowTiles(Light& light);
+    bool AllocateShadowTiles(Light& light, int count, int size);
+    static float ComputeShadowImportance(const Light& light, const Camera& camera, const Frustum& frustum);
     
     std::vector<Light> m_lights;
+    
+    ShadowAtlas m_shadowAtlas;
 };
@@ -1,5 +1,9 @@
 #include "Mesh.h"
 #include "GraphicsSettings.h"
+#include "VertexFormat.h"
+#include "MeshSimplifier.h"
+#include "StreamBuffer.h"
+#include "TextureManager.h"
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 #include "glfw3.h"
@@ -46,6 +50,8 @@ bool Mesh::LoadFromOBJ(const std::string& path)
     {
         std::string materialName;
         std::vector<uint32_t> indices;
+        uint32_t firstIndex = 0;  // range in the merged index buffer
+        uint32_t indexCount = 0;
     };
     std::vector<MaterialGroup> materialGroups;
     MaterialGroup* currentGroup = nullptr;
@@ -147,7 +153,7 @@ bool Mesh::LoadFromOBJ(const std::string& path)
         {
             ss >> currentMtl;
             // Start a new material group
-            materialGroups.push_back({currentMtl, {}});
+            materialGroups.push_back({currentMtl, {}, 0, 0});
             currentGroup = &materialGroups.back();
             continue;
         }
@@ -297,6 +303,16 @@ bool Mesh::LoadFromOBJ(const std::string& path)
         return false;
     }
 
+    // Merge every material group into one contiguous index buffer and
+    // remember each group's range for its SubMesh.
+    for (auto& group : materialGroups)
+    {
+        group.firstIndex = (uint32_t)outIndices.size();
+        group.indexCount = (uint32_t)group.indices.size();
+        outIndices.insert(outIndices.end(), group.indices.begin(), group.indices.end());
+        group.indices.clear();
+    }
+
     Vertices = std::move(outVerts);
     Indices = std::move(outIndices);
 
@@ -413,7 +429,7 @@ bool Mesh::LoadFromOBJ(const std::string& path)
     }
     
     // Helper function to try loading texture with fallback patterns
-    auto TryLoadTextureWithFallbacks = [&objDir](const std::string& texPath, int& width, int& height, int& channels) -> unsigned char* {
+    auto TryLoadTextureWithFallbacks = [&objDir](const std::string& texPath, TextureUsage usage) -> unsigned int {
         std::vector<std::string> pathsToTry;
         
         // Build full path
@@ -482,18 +498,18 @@ bool Mesh::LoadFromOBJ(const std::string& path)
             // Don't flip for OBJ files - Blender and most modern exporters 
             // already export with correct UV orientation
             stbi_set_flip_vertically_on_load(false);
-            unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
-            if (data)
+            unsigned int tex = TextureManager::Instance().Load(path, usage);
+            if (tex)
             {
                 if (path != full)
                 {
                     std::cout << "  Found texture using fallback: " << path << std::endl;
                 }
-                return data;
+                return tex;
             }
         }
         
-        return nullptr;
+        return 0;
     };
     
     // Create SubMeshes for multi-material models
@@ -503,11 +519,12 @@ bool Mesh::LoadFromOBJ(const std::string& path)
         
         for (auto& group : materialGroups)
         {
-            if (group.indices.empty()) continue;
+            if (group.indexCount == 0) continue;
             
             SubMesh sub;
             sub.MaterialName = group.materialName;
-            sub.Indices = std::move(group.indices);
+            sub.FirstIndex = group.firstIndex;
+            sub.IndexCount = group.indexCount;
             sub.BaseVertex = 0;
             
             // Apply material properties
@@ -532,21 +549,10 @@ bool Mesh::LoadFromOBJ(const std::string& path)
                 std::cout << "[DEBUG] Loading diffuse texture for material '" << group.materialName << "'" << std::endl;
                 std::cout << "  MTL texture path: " << texPath << std::endl;
                 
-                int width, height, channels;
-                unsigned char* data = TryLoadTextureWithFallbacks(texPath, width, height, channels);
-                if (data)
+                sub.DiffuseTexture = TryLoadTextureWithFallbacks(texPath, TextureUsage::Color);
+                if (sub.DiffuseTexture)
                 {
-                    glGenTextures(1, &sub.DiffuseTexture);
-                    glBindTexture(GL_TEXTURE_2D, sub.DiffuseTexture);
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-                    glGenerateMipmap(GL_TEXTURE_2D);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                    stbi_image_free(data);
-                    
-                    std::cout << "  ? Diffuse texture loaded successfully (" << width << "x" << height << ")" << std::endl;
+                    std::cout << "  ? Diffuse texture loaded successfully" << std::endl;
                     
                     sub.HasDiffuseTexture = true;
                     sub.DiffuseTexturePath = texPath;
@@ -570,20 +576,9 @@ bool Mesh::LoadFromOBJ(const std::string& path)
                 
                 std::cout << "[DEBUG] Loading specular texture for material '" << group.materialName << "'" << std::endl;
                 
-                int width, height, channels;
-                unsigned char* data = TryLoadTextureWithFallbacks(texPath, width, height, channels);
-                if (data)
+                sub.SpecularTexture = TryLoadTextureWithFallbacks(texPath, TextureUsage::Mask);
+                if (sub.SpecularTexture)
                 {
-                    glGenTextures(1, &sub.SpecularTexture);
-                    glBindTexture(GL_TEXTURE_2D, sub.SpecularTexture);
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-                    glGenerateMipmap(GL_TEXTURE_2D);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                    stbi_image_free(data);
-                    
                     std::cout << "  ? Specular texture loaded successfully" << std::endl;
                     
                     sub.HasSpecularTexture = true;
@@ -603,20 +598,9 @@ bool Mesh::LoadFromOBJ(const std::string& path)
                 
                 std::cout << "[DEBUG] Loading normal map for material '" << group.materialName << "'" << std::endl;
                 
-                int width, height, channels;
-                unsigned char* data = TryLoadTextureWithFallbacks(texPath, width, height, channels);
-                if (data)
+                sub.NormalTexture = TryLoadTextureWithFallbacks(texPath, TextureUsage::Normal);
+                if (sub.NormalTexture)
                 {
-                    glGenTextures(1, &sub.NormalTexture);
-                    glBindTexture(GL_TEXTURE_2D, sub.NormalTexture);
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-                    glGenerateMipmap(GL_TEXTURE_2D);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                    stbi_image_free(data);
-                    
                     std::cout << "  ? Normal map loaded successfully" << std::endl;
                     
                     sub.HasNormalTexture = true;
@@ -695,7 +679,7 @@ bool Mesh::LoadFromOBJ(const std::string& path)
     // Summary
     std::cout << "OBJ loaded successfully:" << std::endl;
     std::cout << "  Vertices: " << Vertices.size() << std::endl;
-    std::cout << "  Indices: " << (!SubMeshes.empty() ? 0 : Indices.size()) << std::endl;
+    std::cout << "  Indices: " << Indices.size() << std::endl;
     std::cout << "  SubMeshes: " << SubMeshes.size() << std::endl;
     std::cout << "  Has Normals: " << (haveNormals ? "Yes" : "Computed") << std::endl;
     std::cout << "  Has UVs: " << (haveUV ? "Yes" : "No") << std::endl;
@@ -718,7 +702,7 @@ bool Mesh::LoadFromGLTF(const std::string& path)
     #ifdef TINYGLTF_IMPLEMENTATION
     
     // Helper function to load texture from GLTF image (handles both embedded and external)
-    auto LoadGLTFTexture = [&](const tinygltf::Model& model, int texIndex, const std::string& dir) -> unsigned int {
+    auto LoadGLTFTexture = [&](const tinygltf::Model& model, int texIndex, const std::string& dir, TextureUsage usage) -> unsigned int {
         if (texIndex < 0 || texIndex >= (int)model.textures.size()) return 0;
 
         const tinygltf::Texture& tex = model.textures[texIndex];
@@ -730,19 +714,8 @@ bool Mesh::LoadFromGLTF(const std::string& path)
         // contains raw pixel data (not PNG/JPEG bytes).  Use it directly.
         if (img.width > 0 && img.height > 0 && !img.image.empty())
         {
-            GLenum format = (img.component == 4) ? GL_RGBA : GL_RGB;
-
-            unsigned int texID;
-            glGenTextures(1, &texID);
-            glBindTexture(GL_TEXTURE_2D, texID);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img.width, img.height, 0,
-                         format, GL_UNSIGNED_BYTE, img.image.data());
-            glGenerateMipmap(GL_TEXTURE_2D);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            return texID;
+            return TextureManager::Instance().LoadPixels(img.image.data(), img.width, img.height,
+                                                        (img.component == 4) ? 4 : 3, usage);
         }
 
         // Fallback: load from file if tinygltf didn't decode the image
@@ -764,22 +737,9 @@ bool Mesh::LoadFromGLTF(const std::string& path)
             }
 
             std::string texPath = dir + decoded;
-            int width = 0, height = 0, channels = 0;
-            unsigned char* data = stbi_load(texPath.c_str(), &width, &height, &channels, 4);
-            if (data)
-            {
-                unsigned int texID;
-                glGenTextures(1, &texID);
-                glBindTexture(GL_TEXTURE_2D, texID);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-                glGenerateMipmap(GL_TEXTURE_2D);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                stbi_image_free(data);
+            unsigned int texID = TextureManager::Instance().Load(texPath, usage);
+            if (texID)
                 return texID;
-            }
 
             std::cerr << "  Failed to load texture: " << img.uri << std::endl;
         }
@@ -812,12 +772,14 @@ bool Mesh::LoadFromGLTF(const std::string& path)
     if (pos != std::string::npos) dir = path.substr(0, pos + 1);
     
     std::vector<Vertex> allVertices;
+    std::vector<uint32_t> allIndices;
     std::vector<SubMesh> allSubMeshes;
     
     // Process all meshes in the GLTF file
     for (size_t meshIdx = 0; meshIdx < model.meshes.size(); ++meshIdx)
     {
         const tinygltf::Mesh& gltfMesh = model.meshes[meshIdx];
+        const size_t firstMorphTarget = MorphTargets.size();
         
         // Each primitive in GLTF is like a submesh
         for (size_t primIdx = 0; primIdx < gltfMesh.primitives.size(); ++primIdx)
@@ -826,6 +788,7 @@ bool Mesh::LoadFromGLTF(const std::string& path)
             
             SubMesh sub;
             sub.BaseVertex = (uint32_t)allVertices.size();
+            sub.FirstIndex = (uint32_t)allIndices.size();
             sub.MaterialName = (primitive.material >= 0) ? 
                 model.materials[primitive.material].name : "default";
             
@@ -937,9 +900,11 @@ bool Mesh::LoadFromGLTF(const std::string& path)
                     {
                         index = data[i];
                     }
-                    sub.Indices.push_back(index + sub.BaseVertex);
+                    // Primitive-local index; BaseVertex is applied at draw time
+                    allIndices.push_back(index);
                 }
             }
+            sub.IndexCount = (uint32_t)allIndices.size() - sub.FirstIndex;
             
             // Load morph targets (blend shapes)
             if (!primitive.targets.empty())
@@ -993,39 +958,69 @@ bool Mesh::LoadFromGLTF(const std::string& path)
                     return result;
                 };
 
+                // Target i of every primitive is the same blend shape (one weight
+                // per glTF mesh), so primitives append to a shared MorphTarget
                 for (size_t targetIdx = 0; targetIdx < primitive.targets.size(); ++targetIdx)
                 {
                     const auto& target = primitive.targets[targetIdx];
 
-                    MorphTarget morphTarget;
-
-                    // Get morph target name from mesh extras if available
-                    auto targetNames = gltfMesh.extras.Get("targetNames");
-                    if (targetNames.IsArray() && targetIdx < targetNames.ArrayLen())
+                    if (firstMorphTarget + targetIdx >= MorphTargets.size())
                     {
-                        morphTarget.Name = targetNames.Get(targetIdx).Get<std::string>();
-                    }
+                        MorphTarget morphTarget;
 
-                    // Fallback name
-                    if (morphTarget.Name.empty())
-                    {
-                        morphTarget.Name = "Target_" + std::to_string(targetIdx);
+                        // Get morph target name from mesh extras if available
+                        auto targetNames = gltfMesh.extras.Get("targetNames");
+                        if (targetNames.IsArray() && targetIdx < targetNames.ArrayLen())
+                        {
+                            morphTarget.Name = targetNames.Get(targetIdx).Get<std::string>();
+                        }
+
+                        // Fallback name
+                        if (morphTarget.Name.empty())
+                        {
+                            morphTarget.Name = "Target_" + std::to_string(targetIdx);
+                        }
+
+                        MorphTargets.push_back(morphTarget);
+                        std::cout << "    Loaded morph target: " << morphTarget.Name << std::endl;
                     }
+                    MorphTarget& morphTarget = MorphTargets[firstMorphTarget + targetIdx];
 
-                    // Load position deltas
+                    std::vector<Vec3> positions, normals, tangents;
                     if (target.count("POSITION"))
-                        morphTarget.PositionDeltas = ReadVec3Accessor(model.accessors[target.at("POSITION")]);
-
-                    // Load normal deltas
+                        positions = ReadVec3Accessor(model.accessors[target.at("POSITION")]);
                     if (target.count("NORMAL"))
-                        morphTarget.NormalDeltas = ReadVec3Accessor(model.accessors[target.at("NORMAL")]);
-
-                    // Load tangent deltas
+                        normals = ReadVec3Accessor(model.accessors[target.at("NORMAL")]);
                     if (target.count("TANGENT"))
-                        morphTarget.TangentDeltas = ReadVec3Accessor(model.accessors[target.at("TANGENT")]);
-
-                    MorphTargets.push_back(morphTarget);
-                    std::cout << "    Loaded morph target: " << morphTarget.Name << std::endl;
+                        tangents = ReadVec3Accessor(model.accessors[target.at("TANGENT")]);
+
+                    // Keep only the vertices this target moves. Normal/tangent
+                    // deltas are stored for every kept vertex once any are present.
+                    auto deltaAt = [](const std::vector<Vec3>& deltas, size_t i) {
+                        return i < deltas.size() ? deltas[i] : Vec3{0, 0, 0};
+                    };
+                    auto isZero = [](const Vec3& d) { return d.x == 0.0f && d.y == 0.0f && d.z == 0.0f; };
+                    size_t primitiveVertices = allVertices.size() - sub.BaseVertex;
+                    for (size_t i = 0; i < primitiveVertices; ++i)
+                    {
+                        Vec3 p = deltaAt(positions, i), n = deltaAt(normals, i), t = deltaAt(tangents, i);
+                        if (isZero(p) && isZero(n) && isZero(t))
+                            continue;
+
+                        morphTarget.VertexIndices.push_back(sub.BaseVertex + (uint32_t)i);
+                        morphTarget.PositionDeltas.push_back(p);
+                        size_t kept = morphTarget.VertexIndices.size();
+                        if (!normals.empty() || !morphTarget.NormalDeltas.empty())
+                        {
+                            morphTarget.NormalDeltas.resize(kept - 1, Vec3{0, 0, 0});
+                            morphTarget.NormalDeltas.push_back(n);
+                        }
+                        if (!tangents.empty() || !morphTarget.TangentDeltas.empty())
+                        {
+                            morphTarget.TangentDeltas.resize(kept - 1, Vec3{0, 0, 0});
+                            morphTarget.TangentDeltas.push_back(t);
+                        }
+                    }
                 }
             }
             
@@ -1046,7 +1041,7 @@ bool Mesh::LoadFromGLTF(const std::string& path)
 
                 if (baseColorTexIndex >= 0)
                 {
-                    sub.DiffuseTexture = LoadGLTFTexture(model, baseColorTexIndex, dir);
+                    sub.DiffuseTexture = LoadGLTFTexture(model, baseColorTexIndex, dir, TextureUsage::Color);
                     if (sub.DiffuseTexture != 0)
                     {
                         sub.HasDiffuseTexture = true;
@@ -1064,7 +1059,7 @@ bool Mesh::LoadFromGLTF(const std::string& path)
                     {
                         std::cout << "  Warning: Using emissive texture as diffuse for material '" 
                                   << mat.name << "'" << std::endl;
-                        sub.DiffuseTexture = LoadGLTFTexture(model, emissiveTexIndex, dir);
+                        sub.DiffuseTexture = LoadGLTFTexture(model, emissiveTexIndex, dir, TextureUsage::Color);
                         if (sub.DiffuseTexture != 0)
                         {
                             sub.HasDiffuseTexture = true;
@@ -1086,7 +1081,7 @@ bool Mesh::LoadFromGLTF(const std::string& path)
 
                 if (normalTexIndex >= 0)
                 {
-                    sub.NormalTexture = LoadGLTFTexture(model, normalTexIndex, dir);
+                    sub.NormalTexture = LoadGLTFTexture(model, normalTexIndex, dir, TextureUsage::Normal);
                     if (sub.NormalTexture != 0)
                     {
                         sub.HasNormalTexture = true;
@@ -1108,13 +1103,16 @@ bool Mesh::LoadFromGLTF(const std::string& path)
     }
     
     Vertices = std::move(allVertices);
+    Indices = std::move(allIndices);
     SubMeshes = std::move(allSubMeshes);
     
-    // Store base vertices for morph targets
     if (!MorphTargets.empty())
     {
-        BaseVertices = Vertices;
-        std::cout << "  Stored " << MorphTargets.size() << " morph targets" << std::endl;
+        size_t deltas = 0;
+        for (const auto& target : MorphTargets)
+            deltas += target.VertexIndices.size();
+        std::cout << "  Stored " << MorphTargets.size() << " morph targets, "
+                  << deltas << " non-zero vertex deltas" << std::endl;
     }
     
     std::cout << "GLTF loaded: " << Vertices.size() << " vertices, " 
@@ -1131,127 +1129,162 @@ bool Mesh::LoadFromGLTF(const std::string& path)
     #endif
 }
 
-// Load a 2D texture from disk and create an OpenGL texture object
-static unsigned int LoadTextureFromFile(const std::string& path)
-{
-    int width, height, channels;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
-    if (!data) return 0;
-
-    unsigned int tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    
-    // Generate mipmaps if enabled in settings
-    auto& settings = GraphicsSettings::Instance();
-    if (settings.EnableMipmaps)
-    {
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    // Apply graphics settings
-    settings.ApplyToTexture(tex);
-
-    stbi_image_free(data);
-    return tex;
-}
-
 void Mesh::Upload()
 {
     if (VAO != 0)
         return;
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    IsSkinned = HasSkeleton || VertexFormat::HasSkinning(Vertices);
 
-    glBindVertexArray(VAO);
+    std::vector<float> positions;
+    std::vector<PackedVertex> surface;
+    VertexFormat::PackPositions(Vertices, positions);
+    VertexFormat::PackSurface(Vertices, surface);
+
+    glGenBuffers(1, &PositionVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, PositionVBO);
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW);
 
+    glGenBuffers(1, &VBO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, surface.size() * sizeof(PackedVertex), surface.data(), GL_STATIC_DRAW);
+
+    // Static meshes skip the skin stream entirely. Skinned meshes are skinned
+    // from it by Skinning.comp, which reads these buffers as raw words.
+    if (IsSkinned)
+    {
+        std::vector<PackedSkin> skin;
+        VertexFormat::PackSkin(Vertices, skin);
+        glGenBuffers(1, &SkinVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, SkinVBO);
+        glBufferData(GL_ARRAY_BUFFER, skin.size() * sizeof(PackedSkin), skin.data(), GL_STATIC_DRAW);
+    }
+
+    // Morph deltas never change; only the per-entity weights do, and
+    // Skinning.comp blends them into the skinned vertex output
+    if (!MorphTargets.empty())
+    {
+        std::vector<uint32_t> morphs;
+        MorphPositionScale = VertexFormat::PackMorphTargets(MorphTargets, Vertices.size(), morphs);
+        MorphDeltaCount = morphs[Vertices.size()];
+        glGenBuffers(1, &MorphBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, MorphBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, morphs.size() * sizeof(uint32_t), morphs.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // One EBO for the whole mesh; submeshes draw sub-ranges of it, and LOD
+    // triangle lists follow the full-detail indices.
+    // The element buffer binding is captured by the VAO.
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(
-        GL_ARRAY_BUFFER,
-        Vertices.size() * sizeof(Vertex),
-        Vertices.data(),
+        GL_ELEMENT_ARRAY_BUFFER,
+        (Indices.size() + LODIndices.size()) * sizeof(uint32_t),
+        nullptr,
         GL_STATIC_DRAW
     );
-
-    // Upload SubMesh EBOs if we have multiple materials
-    if (!SubMeshes.empty())
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, Indices.size() * sizeof(uint32_t), Indices.data());
+    if (!LODIndices.empty())
     {
-        for (auto& sub : SubMeshes)
-        {
-            glGenBuffers(1, &sub.EBO);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sub.EBO);
-            glBufferData(
-                GL_ELEMENT_ARRAY_BUFFER,
-                sub.Indices.size() * sizeof(uint32_t),
-                sub.Indices.data(),
-                GL_STATIC_DRAW
-            );
-        }
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(uint32_t),
+                        LODIndices.size() * sizeof(uint32_t), LODIndices.data());
     }
-    else
+
+    // Main VAO: every stream
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, PositionVBO);
+    VertexFormat::BindPositionStream();
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    VertexFormat::BindSurfaceStream();
+
+    if (SkinVBO != 0)
     {
-        // Legacy single EBO
-        glGenBuffers(1, &EBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(
-            GL_ELEMENT_ARRAY_BUFFER,
-            Indices.size() * sizeof(uint32_t),
-            Indices.data(),
-            GL_STATIC_DRAW
-        );
+        glBindBuffer(GL_ARRAY_BUFFER, SkinVBO);
+        VertexFormat::BindSkinStream();
     }
 
-    // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    glEnableVertexAttribArray(0);
+    // Depth VAO: tightly packed positions only
+    glGenVertexArrays(1, &DepthVAO);
+    glBindVertexArray(DepthVAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBindBuffer(GL_ARRAY_BUFFER, PositionVBO);
+    VertexFormat::BindPositionStream();
 
-    // Normal
-    glVertexAttribPointer(
-        1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, Normal)
-    );
-    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+}
 
-    // UV (vec2 stored in Vec3 UV.x, UV.y)
-    glVertexAttribPointer(
-        2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, UV)
-    );
-    glEnableVertexAttribArray(2);
+void Mesh::UpdateVertexStreams()
+{
+    if (VAO == 0)
+        return;
 
-    // Tangent attribute
-    glVertexAttribPointer(
-        3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, Tangent)
-    );
-    glEnableVertexAttribArray(3);
+    std::vector<float> positions;
+    std::vector<PackedVertex> surface;
+    VertexFormat::PackPositions(Vertices, positions);
+    VertexFormat::PackSurface(Vertices, surface);
+
+    // Staged in the stream buffer and copied on the GPU: no stall on a buffer
+    // the previous frame may still be drawing from. The streams keep their
+    // own buffers since the VAOs and the skinning pass bind them.
+    StreamBuffer& stream = StreamBuffer::Instance();
+    stream.Write(PositionVBO, 0, positions.data(), positions.size() * sizeof(float));
+    stream.Write(VBO, 0, surface.data(), surface.size() * sizeof(PackedVertex));
+}
 
-    // Bone indices (ivec4)
-    glVertexAttribIPointer(
-        4, 4, GL_INT, sizeof(Vertex),
-        (void*)offsetof(Vertex, BoneIndices)
-    );
-    glEnableVertexAttribArray(4);
+void Mesh::UpdateVertexStreams(size_t firstVertex, size_t vertexCount)
+{
+    if (VAO == 0 || firstVertex >= Vertices.size())
+        return;
+    vertexCount = std::min(vertexCount, Vertices.size() - firstVertex);
 
-    // Bone weights (vec4)
-    glVertexAttribPointer(
-        5, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, BoneWeights)
-    );
-    glEnableVertexAttribArray(5);
+    std::vector<Vertex> span(Vertices.begin() + firstVertex, Vertices.begin() + firstVertex + vertexCount);
+    std::vector<float> positions;
+    std::vector<PackedVertex> surface;
+    VertexFormat::PackPositions(span, positions);
+    VertexFormat::PackSurface(span, surface);
 
-    glBindVertexArray(0);
+    StreamBuffer& stream = StreamBuffer::Instance();
+    stream.Write(PositionVBO, firstVertex * 3 * sizeof(float), positions.data(), positions.size() * sizeof(float));
+    stream.Write(VBO, firstVertex * sizeof(PackedVertex), surface.data(), surface.size() * sizeof(PackedVertex));
+}
+
+void Mesh::ReleaseGPU()
+{
+    if (VAO != 0)         { glDeleteVertexArrays(1, &VAO);      VAO = 0; }
+    if (DepthVAO != 0)    { glDeleteVertexArrays(1, &DepthVAO); DepthVAO = 0; }
+    if (PositionVBO != 0) { glDeleteBuffers(1, &PositionVBO);   PositionVBO = 0; }
+    if (VBO != 0)         { glDeleteBuffers(1, &VBO);           VBO = 0; }
+    if (SkinVBO != 0)     { glDeleteBuffers(1, &SkinVBO);       SkinVBO = 0; }
+    if (MorphBuffer != 0) { glDeleteBuffers(1, &MorphBuffer);   MorphBuffer = 0; }
+    if (EBO != 0)         { glDeleteBuffers(1, &EBO);           EBO = 0; }
+}
+
+void Mesh::ReleaseTextures()
+{
+    UnloadTexture();
+    UnloadSpecularTexture();
+    UnloadNormalTexture();
+
+    TextureManager& textures = TextureManager::Instance();
+    for (SubMesh& sub : SubMeshes)
+    {
+        if (sub.DiffuseTexture != 0)  { textures.Release(sub.DiffuseTexture);  sub.DiffuseTexture = 0; }
+        if (sub.SpecularTexture != 0) { textures.Release(sub.SpecularTexture); sub.SpecularTexture = 0; }
+        if (sub.NormalTexture != 0)   { textures.Release(sub.NormalTexture);   sub.NormalTexture = 0; }
+        sub.HasDiffuseTexture = sub.HasSpecularTexture = sub.HasNormalTexture = false;
+    }
 }
 
 bool Mesh::LoadTexture(const std::string& path)
 {
-    unsigned int tex = LoadTextureFromFile(path);
+    TextureHandle tex = TextureManager::Instance().Load(path, TextureUsage::Color);
     if (tex == 0) return false;
+    UnloadTexture();
     DiffuseTexture = tex;
     HasDiffuseTexture = true;
     DiffuseTexturePath = path;
@@ -1262,7 +1295,7 @@ void Mesh::UnloadTexture()
 {
     if (DiffuseTexture != 0)
     {
-        glDeleteTextures(1, &DiffuseTexture);
+        TextureManager::Instance().Release(DiffuseTexture);
         DiffuseTexture = 0;
         HasDiffuseTexture = false;
     }
@@ -1270,8 +1303,9 @@ void Mesh::UnloadTexture()
 
 bool Mesh::LoadSpecularTexture(const std::string& path)
 {
-    unsigned int tex = LoadTextureFromFile(path);
+    TextureHandle tex = TextureManager::Instance().Load(path, TextureUsage::Mask);
     if (tex == 0) return false;
+    UnloadSpecularTexture();
     SpecularTexture = tex;
     HasSpecularTexture = true;
     SpecularTexturePath = path;
@@ -1282,7 +1316,7 @@ void Mesh::UnloadSpecularTexture()
 {
     if (SpecularTexture != 0)
     {
-        glDeleteTextures(1, &SpecularTexture);
+        TextureManager::Instance().Release(SpecularTexture);
         SpecularTexture = 0;
         HasSpecularTexture = false;
     }
@@ -1290,8 +1324,9 @@ void Mesh::UnloadSpecularTexture()
 
 bool Mesh::LoadNormalTexture(const std::string& path)
 {
-    unsigned int tex = LoadTextureFromFile(path);
+    TextureHandle tex = TextureManager::Instance().Load(path, TextureUsage::Normal);
     if (tex == 0) return false;
+    UnloadNormalTexture();
     NormalTexture = tex;
     HasNormalTexture = true;
     NormalTexturePath = path;
@@ -1302,31 +1337,211 @@ void Mesh::UnloadNormalTexture()
 {
     if (NormalTexture != 0)
     {
-        glDeleteTextures(1, &NormalTexture);
+        TextureManager::Instance().Release(NormalTexture);
         NormalTexture = 0;
         HasNormalTexture = false;
     }
 }
 
-void Mesh::Draw() const
+void Mesh::Draw(int lod, int instances) const
 {
     glBindVertexArray(VAO);
     
     // Legacy single-material draw
     if (SubMeshes.empty())
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glDrawElements(GL_TRIANGLES, (GLsizei)Indices.size(), GL_UNSIGNED_INT, 0);
+        if (lod > 0 && lod <= (int)LODs.size())
+        {
+            const IndexRange& range = LODs[lod - 1].Ranges[0];
+            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)range.IndexCount, GL_UNSIGNED_INT,
+                                    (void*)(range.FirstIndex * sizeof(uint32_t)), instances);
+        }
+        else
+        {
+            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)Indices.size(), GL_UNSIGNED_INT, 0, instances);
+        }
     }
     else
     {
         // Multi-material draw: render each submesh
         // Note: Caller must set appropriate textures/materials between submesh draws
-        for (const auto& sub : SubMeshes)
+        for (size_t i = 0; i < SubMeshes.size(); ++i)
+        {
+            DrawSubMesh(i, lod, instances);
+        }
+    }
+}
+
+void Mesh::DrawDepth(int lod, int instances) const
+{
+    glBindVertexArray(DepthVAO);
+    
+    if (SubMeshes.empty())
+    {
+        if (lod > 0 && lod <= (int)LODs.size())
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sub.EBO);
-            glDrawElements(GL_TRIANGLES, (GLsizei)sub.Indices.size(), GL_UNSIGNED_INT, 0);
+            const IndexRange& range = LODs[lod - 1].Ranges[0];
+            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)range.IndexCount, GL_UNSIGNED_INT,
+                                    (void*)(range.FirstIndex * sizeof(uint32_t)), instances);
         }
+        else
+        {
+            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)Indices.size(), GL_UNSIGNED_INT, 0, instances);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < SubMeshes.size(); ++i)
+        {
+            DrawSubMesh(i, lod, instances);
+        }
+    }
+}
+
+void Mesh::DrawSubMesh(const SubMesh& sub) const
+{
+    glDrawElementsBaseVertex(
+        GL_TRIANGLES,
+        (GLsizei)sub.IndexCount,
+        GL_UNSIGNED_INT,
+        (void*)(sub.FirstIndex * sizeof(uint32_t)),
+        (GLint)sub.BaseVertex
+    );
+}
+
+void Mesh::DrawSubMesh(size_t subIndex, int lod, int instances) const
+{
+    const SubMesh& sub = SubMeshes[subIndex];
+    IndexRange range;
+    range.FirstIndex = sub.FirstIndex;
+    range.IndexCount = sub.IndexCount;
+
+    // LOD indices are submesh-local too
+    if (lod > 0 && lod <= (int)LODs.size())
+        range = LODs[lod - 1].Ranges[subIndex];
+
+    glDrawElementsInstancedBaseVertex(
+        GL_TRIANGLES,
+        (GLsizei)range.IndexCount,
+        GL_UNSIGNED_INT,
+        (void*)(range.FirstIndex * sizeof(uint32_t)),
+        instances,
+        (GLint)sub.BaseVertex
+    );
+}
+
+uint32_t Mesh::GetTriangleCount(int lod) const
+{
+    if (lod > 0 && lod <= (int)LODs.size())
+        return LODs[lod - 1].TriangleCount;
+    return (uint32_t)(Indices.size() / 3);
+}
+
+namespace
+{
+    // Meshes below this are cheap enough at any distance
+    constexpr size_t MIN_LOD_TRIANGLES = 256;
+
+    // Per level: triangle target (share of the full mesh), largest collapse
+    // error (share of the bounding radius) and the screen size it starts at
+    constexpr float LOD_TRIANGLE_RATIO[Mesh::MAX_LOD_LEVELS] = { 0.5f, 0.25f, 0.125f };
+    constexpr float LOD_MAX_ERROR[Mesh::MAX_LOD_LEVELS] = { 0.01f, 0.03f, 0.08f };
+    constexpr float LOD_SCREEN_SIZE[Mesh::MAX_LOD_LEVELS] = { 0.5f, 0.25f, 0.12f };
+
+    // A level must remove at least this share of the previous one's
+    // triangles; one that does not is skipped, not stored
+    constexpr float MIN_LOD_REDUCTION = 0.3f;
+
+    // Half the reference screen height in pixels (1080p): a level is not used
+    // before its error projects to under a pixel
+    constexpr float LOD_REFERENCE_HALF_HEIGHT = 540.0f;
+}
+
+void Mesh::GenerateLODs()
+{
+    LODs.clear();
+    LODIndices.clear();
+
+    size_t triangleCount = Indices.size() / 3;
+    if (triangleCount < MIN_LOD_TRIANGLES || Vertices.empty())
+        return;
+
+    glm::vec3 extent(BoundsMax.x - BoundsMin.x, BoundsMax.y - BoundsMin.y, BoundsMax.z - BoundsMin.z);
+    float radius = 0.5f * glm::length(extent);
+    if (!(radius > 0.0f) || BoundsMin.x == FLT_MAX)
+        return;
+
+    // Whole-mesh triangle list with one group per submesh
+    std::vector<uint32_t> triangles;
+    std::vector<uint32_t> groups;
+    triangles.reserve(triangleCount * 3);
+    groups.reserve(triangleCount);
+    if (SubMeshes.empty())
+    {
+        triangles.assign(Indices.begin(), Indices.begin() + triangleCount * 3);
+        groups.assign(triangleCount, 0);
+    }
+    else
+    {
+        for (size_t s = 0; s < SubMeshes.size(); ++s)
+        {
+            const SubMesh& sub = SubMeshes[s];
+            uint32_t end = std::min(sub.FirstIndex + sub.IndexCount, (uint32_t)Indices.size());
+            for (uint32_t i = sub.FirstIndex; i + 2 < end; i += 3)
+            {
+                triangles.push_back(Indices[i] + sub.BaseVertex);
+                triangles.push_back(Indices[i + 1] + sub.BaseVertex);
+                triangles.push_back(Indices[i + 2] + sub.BaseVertex);
+                groups.push_back((uint32_t)s);
+            }
+        }
+    }
+
+    MeshSimplifier simplifier(Vertices, triangles, groups);
+    size_t previous = simplifier.GetTriangleCount();
+    size_t groupCount = SubMeshes.empty() ? 1 : SubMeshes.size();
+    std::vector<uint32_t> levelTriangles;
+
+    for (int level = 0; level < MAX_LOD_LEVELS; ++level)
+    {
+        size_t target = (size_t)(triangleCount * LOD_TRIANGLE_RATIO[level]);
+        size_t remaining = simplifier.Simplify(target, radius * LOD_MAX_ERROR[level]);
+        if (remaining == 0)
+            break;
+        if (remaining > previous * (1.0f - MIN_LOD_REDUCTION))
+            continue;  // The next level's looser error may still get there
+
+        MeshLOD lod;
+        lod.TriangleCount = (uint32_t)remaining;
+        for (size_t g = 0; g < groupCount; ++g)
+        {
+            simplifier.GetTriangles((uint32_t)g, levelTriangles);
+            uint32_t baseVertex = SubMeshes.empty() ? 0 : SubMeshes[g].BaseVertex;
+
+            IndexRange range;
+            range.FirstIndex = (uint32_t)(Indices.size() + LODIndices.size());
+            range.IndexCount = (uint32_t)levelTriangles.size();
+            for (uint32_t index : levelTriangles)
+                LODIndices.push_back(index - baseVertex);
+            lod.Ranges.push_back(range);
+        }
+
+        // Switch once the error is sub-pixel, but never earlier than the
+        // table allows, and always later than the previous level
+        float error = std::max(simplifier.GetError(), radius * 1e-4f);
+        lod.ScreenSize = std::min(LOD_SCREEN_SIZE[level], radius / (LOD_REFERENCE_HALF_HEIGHT * error));
+        if (!LODs.empty())
+            lod.ScreenSize = std::min(lod.ScreenSize, LODs.back().ScreenSize * 0.9f);
+        LODs.push_back(lod);
+        previous = remaining;
+    }
+
+    if (!LODs.empty())
+    {
+        std::cout << "Mesh LODs: " << triangleCount;
+        for (const MeshLOD& lod : LODs)
+            std::cout << " -> " << lod.TriangleCount;
+        std::cout << " triangles" << std::endl;
     }
 }
 
@@ -1339,7 +1554,7 @@ bool Mesh::ValidateVertexData() const
         return false;
     }
     
-    if (SubMeshes.empty() && Indices.empty())
+    if (Indices.empty())
     {
         std::cerr << "Validation failed: No indices!" << std::endl;
         return false;
@@ -1373,14 +1588,20 @@ bool Mesh::ValidateVertexData() const
         }
     }
     
-    // Check index bounds
-    auto checkIndices = [&](const std::vector<uint32_t>& indices, const char* name) {
-        for (size_t i = 0; i < indices.size(); ++i)
+    // Check index bounds (baseVertex is added to every index in the range)
+    auto checkIndices = [&](size_t first, size_t count, uint32_t baseVertex, const char* name) {
+        if (first + count > Indices.size())
         {
-            if (indices[i] >= Vertices.size())
+            std::cerr << "Validation failed: " << name << " range [" << first << ", "
+                      << first + count << ") exceeds index buffer (" << Indices.size() << ")" << std::endl;
+            return false;
+        }
+        for (size_t i = first; i < first + count; ++i)
+        {
+            if ((size_t)Indices[i] + baseVertex >= Vertices.size())
             {
                 std::cerr << "Validation failed: " << name << " index " << i 
-                          << " (" << indices[i] << ") out of bounds (max: " 
+                          << " (" << Indices[i] << " + " << baseVertex << ") out of bounds (max: " 
                           << Vertices.size() - 1 << ")" << std::endl;
                 return false;
             }
@@ -1392,14 +1613,15 @@ bool Mesh::ValidateVertexData() const
     {
         for (size_t i = 0; i < SubMeshes.size(); ++i)
         {
+            const SubMesh& sub = SubMeshes[i];
             std::string name = "SubMesh[" + std::to_string(i) + "]";
-            if (!checkIndices(SubMeshes[i].Indices, name.c_str()))
+            if (!checkIndices(sub.FirstIndex, sub.IndexCount, sub.BaseVertex, name.c_str()))
                 return false;
         }
     }
     else
     {
-        if (!checkIndices(Indices, "Mesh"))
+        if (!checkIndices(0, Indices.size(), 0, "Mesh"))
             return false;
     }
     
@@ -1414,7 +1636,8 @@ void Mesh::PrintDebugInfo() const
     std::cout << "Vertices: " << Vertices.size() << std::endl;
     std::cout << "Indices: " << Indices.size() << std::endl;
     std::cout << "SubMeshes: " << SubMeshes.size() << std::endl;
-    std::cout << "VAO: " << VAO << ", VBO: " << VBO << ", EBO: " << EBO << std::endl;
+    std::cout << "VAO: " << VAO << ", DepthVAO: " << DepthVAO << ", PositionVBO: " << PositionVBO
+              << ", VBO: " << VBO << ", SkinVBO: " << SkinVBO << ", EBO: " << EBO << std::endl;
     
     if (!Vertices.empty())
     {
@@ -1456,8 +1679,9 @@ void Mesh::PrintDebugInfo() const
         {
             const auto& sub = SubMeshes[i];
             std::cout << "  [" << i << "] " << sub.MaterialName 
-                      << ": " << sub.Indices.size() << " indices, "
-                      << "BaseVertex=" << sub.BaseVertex
+                      << ": " << sub.IndexCount << " indices, "
+                      << "FirstIndex=" << sub.FirstIndex
+                      << ", BaseVertex=" << sub.BaseVertex
                       << ", Textures=" << (sub.HasDiffuseTexture ? "D" : "-")
                       << (sub.HasSpecularTexture ? "S" : "-")
                       << (sub.HasNormalTexture ? "N" : "-")
@@ -1474,7 +1698,6 @@ void Mesh::SetMorphTargetWeight(size_t index, float weight)
     if (index < MorphTargets.size())
     {
         MorphTargets[index].Weight = glm::clamp(weight, 0.0f, 1.0f);
-        UpdateMorphTargets();
     }
 }
 
@@ -1491,54 +1714,6 @@ void Mesh::SetMorphTargetWeight(const std::string& name, float weight)
     std::cerr << "Morph target not found: " << name << std::endl;
 }
 
-void Mesh::UpdateMorphTargets()
-{
-    if (MorphTargets.empty() || BaseVertices.empty())
-        return;
-    
-    // Start with base vertices
-    Vertices = BaseVertices;
-    
-    // Apply each morph target with its weight
-    for (const auto& target : MorphTargets)
-    {
-        if (target.Weight <= 0.0f)
-            continue;
-        
-        size_t count = std::min(Vertices.size(), target.PositionDeltas.size());
-        for (size_t i = 0; i < count; ++i)
-        {
-            // Apply position delta
-            Vertices[i].Position.x += target.PositionDeltas[i].x * target.Weight;
-            Vertices[i].Position.y += target.PositionDeltas[i].y * target.Weight;
-            Vertices[i].Position.z += target.PositionDeltas[i].z * target.Weight;
-            
-            // Apply normal delta if available
-            if (i < target.NormalDeltas.size())
-            {
-                Vertices[i].Normal.x += target.NormalDeltas[i].x * target.Weight;
-                Vertices[i].Normal.y += target.NormalDeltas[i].y * target.Weight;
-                Vertices[i].Normal.z += target.NormalDeltas[i].z * target.Weight;
-            }
-            
-            // Apply tangent delta if available
-            if (i < target.TangentDeltas.size())
-            {
-                Vertices[i].Tangent.x += target.TangentDeltas[i].x * target.Weight;
-                Vertices[i].Tangent.y += target.TangentDeltas[i].y * target.Weight;
-                Vertices[i].Tangent.z += target.TangentDeltas[i].z * target.Weight;
-            }
-        }
-    }
-    
-    // Re-upload to GPU
-    if (VAO != 0)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, Vertices.size() * sizeof(Vertex), Vertices.data());
-    }
-}
-
 void Mesh::CalculateBounds()
 {
     if (Vertices.empty())
@@ -1561,6 +1736,21 @@ void Mesh::CalculateBounds()
         BoundsMax.y = std::max(BoundsMax.y, v.Position.y);
         BoundsMax.z = std::max(BoundsMax.z, v.Position.z);
     }
+
+    // Weights are 0-1, so each target can push the bounds out by at most its
+    // largest delta per axis; this stays valid whatever the weights are
+    for (const auto& target : MorphTargets)
+    {
+        Vec3 grow{0, 0, 0}, shrink{0, 0, 0};
+        for (const auto& d : target.PositionDeltas)
+        {
+            grow.x = std::max(grow.x, d.x);     shrink.x = std::min(shrink.x, d.x);
+            grow.y = std::max(grow.y, d.y);     shrink.y = std::min(shrink.y, d.y);
+            grow.z = std::max(grow.z, d.z);     shrink.z = std::min(shrink.z, d.z);
+        }
+        BoundsMin.x += shrink.x; BoundsMin.y += shrink.y; BoundsMin.z += shrink.z;
+        BoundsMax.x += grow.x;   BoundsMax.y += grow.y;   BoundsMax.z += grow.z;
+    }
     
     std::cout << "Mesh bounds: Min(" << BoundsMin.x << ", " << BoundsMin.y << ", " << BoundsMin.z << ") "
               << "Max(" << BoundsMax.x << ", " << BoundsMax.y << ", " << BoundsMax.z << ")" << std::endl;
@@ -1574,13 +1764,20 @@ size_t Mesh::GetCPUMemoryUsage() const
     // Vertex data
     total += Vertices.size() * sizeof(Vertex);
     
-    // Index data (legacy)
+    // Index data (shared by all submeshes) and LOD triangle lists
     total += Indices.size() * sizeof(uint32_t);
+    total += LODIndices.size() * sizeof(uint32_t);
+
+    // Sparse morph deltas
+    for (const auto& target : MorphTargets)
+    {
+        total += target.VertexIndices.size() * sizeof(uint32_t);
+        total += (target.PositionDeltas.size() + target.NormalDeltas.size() + target.TangentDeltas.size()) * sizeof(Vec3);
+    }
     
     // SubMesh data
     for (const auto& sub : SubMeshes)
     {
-        total += sub.Indices.size() * sizeof(uint32_t);
         total += sub.MaterialName.capacity();
         total += sub.DiffuseTexturePath.capacity();
         total += sub.SpecularTexturePath.capacity();
@@ -1594,40 +1791,21 @@ size_t Mesh::GetGPUMemoryUsage() const
 {
     size_t total = 0;
     
-    // VBO (vertex buffer)
-    if (VAO != 0)
-    {
-        total += Vertices.size() * sizeof(Vertex);
-    }
+    // Vertex streams
+    if (PositionVBO != 0) total += Vertices.size() * 3 * sizeof(float);
+    if (VBO != 0)         total += Vertices.size() * sizeof(PackedVertex);
+    if (SkinVBO != 0)     total += Vertices.size() * sizeof(PackedSkin);
+    if (MorphBuffer != 0) total += (Vertices.size() + 1) * sizeof(uint32_t) + MorphDeltaCount * sizeof(PackedMorphDelta);
     
-    // EBO (index buffer) - legacy
+    // EBO (index buffer shared by all submeshes)
     if (EBO != 0)
     {
-        total += Indices.size() * sizeof(uint32_t);
-    }
-    
-    // SubMesh EBOs
-    for (const auto& sub : SubMeshes)
-    {
-        if (sub.EBO != 0)
-        {
-            total += sub.Indices.size() * sizeof(uint32_t);
-        }
+        total += (Indices.size() + LODIndices.size()) * sizeof(uint32_t);
     }
     
-    // Textures (approximate - assumes RGBA 8-bit with mipmaps)
-    auto estimateTextureSize = [](unsigned int texID) -> size_t {
-        if (texID == 0) return 0;
-        
-        // Query texture size from OpenGL
-        glBindTexture(GL_TEXTURE_2D, texID);
-        int width = 0, height = 0;
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
-        
-        // RGBA 8-bit + mipmaps (approximately 1.33x base size)
-        size_t baseSize = width * height * 4;
-        return (size_t)(baseSize * 1.33f);
+    // Textures, as measured by TextureManager (shared ones count in every mesh using them)
+    auto estimateTextureSize = [](TextureHandle texID) -> size_t {
+        return TextureManager::Instance().GetMemoryUsage(texID);
     };
     
     // Legacy textures
@@ -1684,6 +1862,7 @@ bool Mesh::LoadFromFBX(const std::string& path)
     };
 
     std::vector<Vertex>    allVertices;
+    std::vector<uint32_t>  allIndices;
     std::vector<SubMesh>   allSubMeshes;
 
     // -----------------------------------------------------------------------
@@ -1834,6 +2013,7 @@ bool Mesh::LoadFromFBX(const std::string& path)
         {
             SubMesh sub;
             sub.BaseVertex = (uint32_t)allVertices.size();
+            sub.FirstIndex = (uint32_t)allIndices.size();
 
             // Gather the face range for this material part
             uint32_t faceBegin = 0, faceEnd = (uint32_t)fbxMesh->faces.count;
@@ -1947,7 +2127,7 @@ bool Mesh::LoadFromFBX(const std::string& path)
                     const uint32_t nTris  = ufbx_triangulate_face(
                         triIndices.data(), maxTriIndices, fbxMesh, face);
                     for (uint32_t t = 0; t < nTris * 3; ++t)
-                        sub.Indices.push_back(AddVertex(triIndices[t]) + sub.BaseVertex);
+                        allIndices.push_back(AddVertex(triIndices[t]));
                 }
             }
             else
@@ -1958,11 +2138,12 @@ bool Mesh::LoadFromFBX(const std::string& path)
                     const uint32_t nTris  = ufbx_triangulate_face(
                         triIndices.data(), maxTriIndices, fbxMesh, face);
                     for (uint32_t t = 0; t < nTris * 3; ++t)
-                        sub.Indices.push_back(AddVertex(triIndices[t]) + sub.BaseVertex);
+                        allIndices.push_back(AddVertex(triIndices[t]));
                 }
             }
 
-            if (sub.Indices.empty()) continue;
+            sub.IndexCount = (uint32_t)allIndices.size() - sub.FirstIndex;
+            if (sub.IndexCount == 0) continue;
 
             // Helper: try every reasonable path to resolve an FBX texture reference,
             // including embedded content blobs (GLB-style FBX) as a last resort.
@@ -2003,7 +2184,7 @@ bool Mesh::LoadFromFBX(const std::string& path)
 
                 for (const auto& p : candidates)
                 {
-                    unsigned int id = LoadTextureFromFile(p);
+                    unsigned int id = TextureManager::Instance().Load(p, TextureUsage::Color);
                     if (id != 0)
                     {
                         std::cout << "FBX: loaded texture from: " << p << "\n";
@@ -2014,23 +2195,11 @@ bool Mesh::LoadFromFBX(const std::string& path)
                 // 4. Embedded content blob (textures packed inside the FBX/GLB)
                 if (tex->content.size > 0)
                 {
-                    int w, h, c;
-                    unsigned char* data = stbi_load_from_memory(
-                        reinterpret_cast<const unsigned char*>(tex->content.data),
-                        static_cast<int>(tex->content.size), &w, &h, &c, 4);
-                    if (data)
+                    unsigned int texID = TextureManager::Instance().LoadEncoded(
+                        reinterpret_cast<const uint8_t*>(tex->content.data), tex->content.size, TextureUsage::Color);
+                    if (texID != 0)
                     {
-                        unsigned int texID;
-                        glGenTextures(1, &texID);
-                        glBindTexture(GL_TEXTURE_2D, texID);
-                        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-                        glGenerateMipmap(GL_TEXTURE_2D);
-                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                        stbi_image_free(data);
-                        std::cout << "FBX: loaded embedded texture (" << w << "x" << h << ")\n";
+                        std::cout << "FBX: loaded embedded texture\n";
                         return texID;
                     }
                 }
@@ -2147,8 +2316,8 @@ bool Mesh::LoadFromFBX(const std::string& path)
     }
 
     Vertices  = std::move(allVertices);
+    Indices   = std::move(allIndices);
     SubMeshes = std::move(allSubMeshes);
-    BaseVertices = Vertices;
 
     if (hasSkin && !loadedSkeleton.Bones.empty())
     {
@@ -3,6 +3,7 @@
 #include <string>
 #include "../resources/Math/Vec3.h"
 #include "../gameplay/AnimationSystem.h"
+#include "TextureManager.h"
 
 struct Vertex 
 {
@@ -14,20 +15,26 @@ struct Vertex
 	float BoneWeights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 };
 
-// Morph target (blend shape) data
+// Morph target (blend shape) data, sparse: only the vertices the target
+// moves. Blended on the GPU by the skinning pre-pass (Skinning.comp) with
+// each entity's weights (Entity::MorphWeights).
 struct MorphTarget
 {
 	std::string Name;
-	std::vector<Vec3> PositionDeltas;  // Position offsets
-	std::vector<Vec3> NormalDeltas;    // Normal offsets
-	std::vector<Vec3> TangentDeltas;   // Tangent offsets (optional)
-	float Weight = 0.0f;               // Current weight (0-1)
+	std::vector<uint32_t> VertexIndices;  // Mesh vertices moved by this target
+	std::vector<Vec3> PositionDeltas;     // Position offsets, one per index
+	std::vector<Vec3> NormalDeltas;       // Normal offsets (optional, one per index)
+	std::vector<Vec3> TangentDeltas;      // Tangent offsets (optional, one per index)
+	float Weight = 0.0f;                  // Default weight (0-1) for entities without their own
 };
 
-// SubMesh represents geometry with a single material
+// SubMesh represents geometry with a single material.
+// Its indices live in the parent mesh's shared index buffer; the range is
+// drawn with glDrawElementsBaseVertex so submesh indices stay local.
 struct SubMesh
 {
-	std::vector<uint32_t> Indices;
+	uint32_t FirstIndex = 0;  // offset (in indices) into parent mesh's index buffer
+	uint32_t IndexCount = 0;  // number of indices in this submesh's range
 	uint32_t BaseVertex = 0;  // offset into parent mesh's vertex buffer
 	
 	// Material properties
@@ -37,57 +44,95 @@ struct SubMesh
 	float Shininess = 16.0f;
 	float Alpha = 1.0f;
 	
-	// Textures
-	unsigned int DiffuseTexture = 0;
+	// Textures (references held in TextureManager, dropped by Mesh::ReleaseTextures)
+	TextureHandle DiffuseTexture = 0;
 	bool HasDiffuseTexture = false;
 	std::string DiffuseTexturePath;
 	
-	unsigned int SpecularTexture = 0;
+	TextureHandle SpecularTexture = 0;
 	bool HasSpecularTexture = false;
 	std::string SpecularTexturePath;
 	
-	unsigned int NormalTexture = 0;
+	TextureHandle NormalTexture = 0;
 	bool HasNormalTexture = false;
 	std::string NormalTexturePath;
-	
-	// OpenGL buffer for this submesh's indices
-	uint32_t EBO = 0;
+};
+
+// Contiguous run of a mesh's element buffer
+struct IndexRange
+{
+	uint32_t FirstIndex = 0;
+	uint32_t IndexCount = 0;
+};
+
+// Simplified version of a whole mesh (see MeshSimplifier). Levels reuse the
+// mesh's vertex streams; only their triangle lists differ, stored after
+// Indices in the same element buffer.
+struct MeshLOD
+{
+	std::vector<IndexRange> Ranges;  // One per submesh, or a single range without submeshes
+	uint32_t TriangleCount = 0;
+	float ScreenSize = 0.0f;         // Used once the bounds span less than this share of the screen height
 };
 
 struct Mesh
 {
 public:
 	std::vector<Vertex> Vertices;
-	std::vector<uint32_t> Indices;  // Legacy: used when there's only 1 material
+	std::vector<uint32_t> Indices;  // All indices; submeshes reference ranges of this
 	std::vector<SubMesh> SubMeshes;  // Multiple materials
 	
 	// Morph targets / Blend shapes
 	std::vector<MorphTarget> MorphTargets;
-	std::vector<Vertex> BaseVertices;  // Original vertices for morph target blending
 
 	// Skeleton data (populated by LoadFromFBX when skinning is present)
 	Skeleton MeshSkeleton;
 	bool HasSkeleton = false;
+	bool DualQuaternionSkinning = false;  // Skin with Entity::BoneDualQuats where the pose allows it
 
-	uint32_t VAO = 0;
-	uint32_t VBO = 0;
-	uint32_t EBO = 0;  // Legacy: used when there's only 1 material
+	// GPU streams (see VertexFormat.h); Vertices is packed into these on Upload
+	uint32_t VAO = 0;          // All streams, used by the main pass
+	uint32_t DepthVAO = 0;     // Position stream only, used by depth-only passes
+	uint32_t PositionVBO = 0;  // float3 positions
+	uint32_t VBO = 0;          // PackedVertex: normal, tangent, uv
+	uint32_t SkinVBO = 0;      // PackedSkin, 0 for static meshes
+	uint32_t MorphBuffer = 0;  // Quantized morph deltas (VertexFormat::PackMorphTargets), 0 without targets
+	uint32_t MorphDeltaCount = 0;
+	float MorphPositionScale = 0.0f;  // Position deltas are stored relative to this
+	uint32_t EBO = 0;  // Single element buffer shared by every submesh (VAO state)
+	bool IsSkinned = false;    // Set by Upload when any vertex has bone weights
 
 	// Bounding box for frustum culling
 	Vec3 BoundsMin{FLT_MAX, FLT_MAX, FLT_MAX};
 	Vec3 BoundsMax{-FLT_MAX, -FLT_MAX, -FLT_MAX};
 
+	// Levels of detail 1..N (level 0 is the full mesh), built by GenerateLODs
+	std::vector<MeshLOD> LODs;
+	std::vector<uint32_t> LODIndices;  // Uploaded after Indices; ranges in LODs point past Indices
+
 	void Upload();
-	void Draw() const;
+	void UpdateVertexStreams();  // Re-pack Vertices into the existing GPU streams
+	void UpdateVertexStreams(size_t firstVertex, size_t vertexCount);  // Same, for a span of Vertices only
+	void ReleaseGPU();           // Delete VAOs and buffers
+	void ReleaseTextures();      // Drop this mesh's and its submeshes' texture references
+	void Draw(int lod = 0, int instances = 1) const;
+	void DrawDepth(int lod = 0, int instances = 1) const;  // Positions only, for shadow/depth passes
+	void DrawSubMesh(const SubMesh& sub) const;  // Assumes VAO is already bound
+	void DrawSubMesh(size_t subIndex, int lod, int instances = 1) const;  // Same, from the given level
+	
+	// Simplifies the mesh into up to MAX_LOD_LEVELS extra levels; call before Upload
+	void GenerateLODs();
+	int GetLODCount() const { return 1 + (int)LODs.size(); }
+	uint32_t GetTriangleCount(int lod) const;
+	static constexpr int MAX_LOD_LEVELS = 3;
 	bool LoadFromOBJ(const std::string& path);
 	bool LoadFromGLTF(const std::string& path);
 	bool LoadFromFBX(const std::string& path);
     
-    // Morph target control
+    // Default morph target weights (entities may override them)
     void SetMorphTargetWeight(size_t index, float weight);
     void SetMorphTargetWeight(const std::string& name, float weight);
-    void UpdateMorphTargets();  // Apply current weights
-    void CalculateBounds();     // Calculate bounding box
+    void CalculateBounds();     // Calculate bounding box, including every morph target fully applied
     
     // Validation and debugging
     bool ValidateVertexData() const;
@@ -100,20 +145,20 @@ public:
     
     // Legacy single-material properties (used when SubMeshes.empty())
     Vec3 DiffuseColor{0.8f, 0.8f, 0.9f};
-    unsigned int DiffuseTexture = 0;
+    TextureHandle DiffuseTexture = 0;
     bool HasDiffuseTexture = false;
     std::string DiffuseTexturePath;
-    unsigned int SpecularTexture = 0;
+    TextureHandle SpecularTexture = 0;
     bool HasSpecularTexture = false;
     std::string SpecularTexturePath;
-    unsigned int NormalTexture = 0;
+    TextureHandle NormalTexture = 0;
     bool HasNormalTexture = false;
     std::string NormalTexturePath;
     Vec3 SpecularColor{0.2f,0.2f,0.2f};
     float Shininess = 16.0f;
     float Alpha = 1.0f;
     
-    // Load a texture from file and assign as diffuse
+    // Load a texture from file (shared through TextureManager) and assign as diffuse
     bool LoadTexture(const std::string& path);
     void UnloadTexture();
     bool LoadSpecularTexture(const std::string& path);
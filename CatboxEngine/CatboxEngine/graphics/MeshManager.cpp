@@ -69,11 +69,14 @@ MeshHandle MeshManager::LoadMeshSync(const std::string& path)
 
         if (!ok)
         {
+            m.ReleaseTextures();
+
             // Post failure message
             auto msg = std::make_shared<MeshLoadFailedMessage>(path, "Failed to load mesh");
             MessageQueue::Instance().Post(msg);
             return 0;
         }
+        m.GenerateLODs();
         m.Upload();
         e->mesh = std::move(m);
         e->loaded = true;
@@ -115,11 +118,14 @@ MeshHandle MeshManager::LoadMeshAsync(const std::string& path)
 
         if (!ok)
         {
+            m.ReleaseTextures();
+
             // Post failure message
             auto msg = std::make_shared<MeshLoadFailedMessage>(path, "Failed to load mesh");
             MessageQueue::Instance().Post(msg);
             return;
         }
+        m.GenerateLODs();
         m.Upload();
         e->mesh = std::move(m);
         e->loaded = true;
@@ -153,6 +159,7 @@ void MeshManager::Release(MeshHandle h)
     if (it == m_entries.end()) return;
     if (--it->second->refcount <= 0)
     {
+        if (it->second->loaded) it->second->mesh.ReleaseTextures();
         m_pathToHandle.erase(it->second->path);
         m_entries.erase(it);
     }
@@ -195,6 +202,7 @@ MeshHandle MeshManager::RegisterMesh(const std::string& key, Mesh&& mesh)
         auto eh = m_entries.find(existing->second);
         if (eh != m_entries.end())
         {
+            eh->second->mesh.ReleaseTextures();
             eh->second->mesh  = std::move(mesh);
             eh->second->loaded = true;
             return existing->second;
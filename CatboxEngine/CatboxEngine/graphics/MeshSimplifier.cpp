@@ -0,0 +1,423 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    // Collapses that turn a neighbouring triangle further than this (cosine) are refused
+    constexpr double MIN_NORMAL_COSINE = 0.2;
+
+    // Quadric weight of the planes holding open borders, and of those holding
+    // normal creases per unit of (1 - cosine) across the crease
+    constexpr double BORDER_WEIGHT = 10.0;
+    constexpr double CREASE_WEIGHT = 4.0;
+
+    uint64_t EdgeKey(uint32_t a, uint32_t b)
+    {
+        if (a > b) std::swap(a, b);
+        return ((uint64_t)a << 32) | b;
+    }
+}
+
+void MeshSimplifier::Quadric::AddPlane(double a, double b, double c, double d, double weight)
+{
+    Q[0] += weight * a * a; Q[1] += weight * a * b; Q[2] += weight * a * c; Q[3] += weight * a * d;
+    Q[4] += weight * b * b; Q[5] += weight * b * c; Q[6] += weight * b * d;
+    Q[7] += weight * c * c; Q[8] += weight * c * d;
+    Q[9] += weight * d * d;
+}
+
+void MeshSimplifier::Quadric::Add(const Quadric& o)
+{
+    for (int i = 0; i < 10; ++i)
+        Q[i] += o.Q[i];
+}
+
+double MeshSimplifier::Quadric::Evaluate(const glm::dvec3& p) const
+{
+    double x = p.x, y = p.y, z = p.z;
+    return Q[0] * x * x + 2.0 * Q[1] * x * y + 2.0 * Q[2] * x * z + 2.0 * Q[3] * x +
+           Q[4] * y * y + 2.0 * Q[5] * y * z + 2.0 * Q[6] * y +
+           Q[7] * z * z + 2.0 * Q[8] * z +
+           Q[9];
+}
+
+MeshSimplifier::MeshSimplifier(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& triangles,
+                               const std::vector<uint32_t>& groups)
+    : m_triangles(triangles), m_groups(groups)
+{
+    size_t vertexCount = vertices.size();
+    m_normals.resize(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        glm::vec3 n(vertices[v].Normal.x, vertices[v].Normal.y, vertices[v].Normal.z);
+        float length = glm::length(n);
+        m_normals[v] = length > 0.0f ? n / length : n;
+    }
+
+    WeldPositions(vertices);
+    size_t positionCount = m_positions.size();
+
+    size_t triangleCount = m_triangles.size() / 3;
+    m_triangleAlive.assign(triangleCount, 1);
+    m_positionTriangles.resize(positionCount);
+    m_quadrics.resize(positionCount);
+    m_versions.assign(positionCount, 0);
+
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        uint32_t i0 = m_triangles[t * 3], i1 = m_triangles[t * 3 + 1], i2 = m_triangles[t * 3 + 2];
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+        {
+            m_triangleAlive[t] = 0;
+            continue;
+        }
+        uint32_t p0 = m_vertexPosition[i0], p1 = m_vertexPosition[i1], p2 = m_vertexPosition[i2];
+        if (p0 == p1 || p1 == p2 || p0 == p2)
+        {
+            m_triangleAlive[t] = 0;
+            continue;
+        }
+        m_liveTriangles++;
+        m_positionTriangles[p0].push_back((uint32_t)t);
+        m_positionTriangles[p1].push_back((uint32_t)t);
+        m_positionTriangles[p2].push_back((uint32_t)t);
+
+        // Plane quadric of the triangle on each corner
+        glm::dvec3 n = glm::cross(m_positions[p1] - m_positions[p0], m_positions[p2] - m_positions[p0]);
+        double length = glm::length(n);
+        if (length <= 0.0)
+            continue;
+        n /= length;
+        double d = -glm::dot(n, m_positions[p0]);
+        m_quadrics[p0].AddPlane(n.x, n.y, n.z, d, 1.0);
+        m_quadrics[p1].AddPlane(n.x, n.y, n.z, d, 1.0);
+        m_quadrics[p2].AddPlane(n.x, n.y, n.z, d, 1.0);
+    }
+
+    ClassifyPositions(vertices);
+
+    for (uint32_t p = 0; p < positionCount; ++p)
+        PushCollapses(p);
+}
+
+void MeshSimplifier::WeldPositions(const std::vector<Vertex>& vertices)
+{
+    // Weld by exact position: split normals and UVs share one position
+    struct Key
+    {
+        float X, Y, Z;
+        bool operator==(const Key& o) const { return X == o.X && Y == o.Y && Z == o.Z; }
+    };
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const
+        {
+            uint32_t h[3];
+            std::memcpy(h, &k, sizeof(h));
+            return (size_t)(h[0] * 73856093u ^ h[1] * 19349663u ^ h[2] * 83492791u);
+        }
+    };
+
+    size_t vertexCount = vertices.size();
+    std::unordered_map<Key, uint32_t, KeyHash> ids;
+    ids.reserve(vertexCount);
+    m_vertexPosition.resize(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        const Vec3& p = vertices[v].Position;
+        auto it = ids.emplace(Key{ p.x, p.y, p.z }, (uint32_t)m_positions.size());
+        if (it.second)
+            m_positions.push_back(glm::dvec3(p.x, p.y, p.z));
+        m_vertexPosition[v] = it.first->second;
+    }
+}
+
+void MeshSimplifier::ClassifyPositions(const std::vector<Vertex>& vertices)
+{
+    size_t positionCount = m_positions.size();
+    m_locked.assign(positionCount, 0);
+
+    // Lock positions whose vertices disagree on UV, or whose triangles
+    // belong to different groups
+    std::vector<uint32_t> positionVertex(positionCount, UINT32_MAX);
+    std::vector<uint32_t> positionGroup(positionCount, UINT32_MAX);
+    for (size_t t = 0; t < m_triangleAlive.size(); ++t)
+    {
+        if (!m_triangleAlive[t])
+            continue;
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t v = m_triangles[t * 3 + c];
+            uint32_t p = m_vertexPosition[v];
+            if (positionVertex[p] == UINT32_MAX)
+                positionVertex[p] = v;
+            else if (vertices[positionVertex[p]].UV.x != vertices[v].UV.x ||
+                     vertices[positionVertex[p]].UV.y != vertices[v].UV.y)
+                m_locked[p] = 1;  // UV seam
+            if (positionGroup[p] == UINT32_MAX)
+                positionGroup[p] = m_groups[t];
+            else if (positionGroup[p] != m_groups[t])
+                m_locked[p] = 1;  // Submesh boundary
+        }
+    }
+
+    // Edges used by one triangle are borders, by more than two non-manifold;
+    // a shared edge whose sides use different vertices is a normal crease
+    struct EdgeUse
+    {
+        uint32_t Count = 0;
+        uint32_t VertexA = 0, VertexB = 0;  // First triangle's vertices at the lower and higher position
+        double Crease = 0.0;                // 1 - cosine between normals split across the edge
+    };
+    std::unordered_map<uint64_t, EdgeUse> edges;
+    edges.reserve(m_liveTriangles * 3);
+    for (size_t t = 0; t < m_triangleAlive.size(); ++t)
+    {
+        if (!m_triangleAlive[t])
+            continue;
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t a = m_triangles[t * 3 + c];
+            uint32_t b = m_triangles[t * 3 + (c + 1) % 3];
+            if (m_vertexPosition[a] > m_vertexPosition[b])
+                std::swap(a, b);
+
+            EdgeUse& edge = edges[EdgeKey(m_vertexPosition[a], m_vertexPosition[b])];
+            if (edge.Count++ == 0)
+            {
+                edge.VertexA = a;
+                edge.VertexB = b;
+                continue;
+            }
+            if (a != edge.VertexA)
+                edge.Crease = std::max(edge.Crease, 1.0 - (double)glm::dot(m_normals[a], m_normals[edge.VertexA]));
+            if (b != edge.VertexB)
+                edge.Crease = std::max(edge.Crease, 1.0 - (double)glm::dot(m_normals[b], m_normals[edge.VertexB]));
+        }
+    }
+
+    // Planes through those edges, upright on each side's triangle, hold the
+    // edge in place without locking it
+    for (size_t t = 0; t < m_triangleAlive.size(); ++t)
+    {
+        if (!m_triangleAlive[t])
+            continue;
+
+        const uint32_t* tri = &m_triangles[t * 3];
+        const glm::dvec3& p0 = m_positions[m_vertexPosition[tri[0]]];
+        glm::dvec3 normal = glm::cross(m_positions[m_vertexPosition[tri[1]]] - p0, m_positions[m_vertexPosition[tri[2]]] - p0);
+        if (glm::length(normal) <= 0.0)
+            continue;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t a = m_vertexPosition[tri[c]];
+            uint32_t b = m_vertexPosition[tri[(c + 1) % 3]];
+            const EdgeUse& edge = edges[EdgeKey(a, b)];
+            double weight = edge.Count != 2 ? BORDER_WEIGHT : CREASE_WEIGHT * edge.Crease;
+            if (weight <= 0.0)
+                continue;
+
+            glm::dvec3 n = glm::cross(m_positions[b] - m_positions[a], normal);
+            double length = glm::length(n);
+            if (length <= 0.0)
+                continue;
+            n /= length;
+            double d = -glm::dot(n, m_positions[a]);
+            m_quadrics[a].AddPlane(n.x, n.y, n.z, d, weight);
+            m_quadrics[b].AddPlane(n.x, n.y, n.z, d, weight);
+        }
+    }
+}
+
+void MeshSimplifier::PushCollapses(uint32_t position)
+{
+    for (uint32_t t : m_positionTriangles[position])
+    {
+        if (!m_triangleAlive[t])
+            continue;
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t other = m_vertexPosition[m_triangles[t * 3 + c]];
+            if (other == position)
+                continue;
+            TryPush(position, other);
+            TryPush(other, position);
+        }
+    }
+}
+
+bool MeshSimplifier::TryPush(uint32_t from, uint32_t to)
+{
+    if (m_locked[from])
+        return false;
+
+    Quadric q = m_quadrics[from];
+    q.Add(m_quadrics[to]);
+    Collapse collapse;
+    collapse.Cost = std::max(q.Evaluate(m_positions[to]), 0.0);
+    collapse.From = from;
+    collapse.To = to;
+    collapse.FromVersion = m_versions[from];
+    collapse.ToVersion = m_versions[to];
+    m_heap.push_back(collapse);
+    std::push_heap(m_heap.begin(), m_heap.end());
+    return true;
+}
+
+bool MeshSimplifier::HasPosition(uint32_t triangle, uint32_t position) const
+{
+    const uint32_t* tri = &m_triangles[triangle * 3];
+    return m_vertexPosition[tri[0]] == position || m_vertexPosition[tri[1]] == position ||
+           m_vertexPosition[tri[2]] == position;
+}
+
+bool MeshSimplifier::FlipsTriangles(uint32_t from, uint32_t to) const
+{
+    const glm::dvec3& target = m_positions[to];
+    for (uint32_t t : m_positionTriangles[from])
+    {
+        if (!m_triangleAlive[t] || HasPosition(t, to))
+            continue;  // Removed by the collapse
+
+        const uint32_t* tri = &m_triangles[t * 3];
+        glm::dvec3 p[3], moved[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t position = m_vertexPosition[tri[c]];
+            p[c] = m_positions[position];
+            moved[c] = position == from ? target : p[c];
+        }
+        glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        glm::dvec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+        double lengths = glm::length(before) * glm::length(after);
+        if (lengths <= 0.0 || glm::dot(before, after) < MIN_NORMAL_COSINE * lengths)
+            return true;
+    }
+    return false;
+}
+
+uint32_t MeshSimplifier::PickVertex(uint32_t vertex, uint32_t from, uint32_t to) const
+{
+    // Prefer the vertices the collapsed edge's triangles use at 'to': they
+    // share vertex's UV chart. Among them, the closest normal wins.
+    uint32_t best = UINT32_MAX;
+    float bestCosine = -2.0f;
+    for (int pass = 0; pass < 2 && best == UINT32_MAX; ++pass)
+    {
+        for (uint32_t t : m_positionTriangles[to])
+        {
+            if (!m_triangleAlive[t] || (pass == 0 && !HasPosition(t, from)))
+                continue;
+            for (int c = 0; c < 3; ++c)
+            {
+                uint32_t candidate = m_triangles[t * 3 + c];
+                if (m_vertexPosition[candidate] != to)
+                    continue;
+                float cosine = glm::dot(m_normals[vertex], m_normals[candidate]);
+                if (cosine > bestCosine)
+                {
+                    best = candidate;
+                    bestCosine = cosine;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void MeshSimplifier::ApplyCollapse(uint32_t from, uint32_t to)
+{
+    // Pick every surviving corner's new vertex before the edge's triangles die
+    std::vector<std::pair<uint32_t, uint32_t>> remap;
+    for (uint32_t t : m_positionTriangles[from])
+    {
+        if (!m_triangleAlive[t] || HasPosition(t, to))
+            continue;
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t v = m_triangles[t * 3 + c];
+            if (m_vertexPosition[v] != from)
+                continue;
+            auto it = std::find_if(remap.begin(), remap.end(), [v](const auto& r) { return r.first == v; });
+            if (it == remap.end())
+                remap.emplace_back(v, PickVertex(v, from, to));
+        }
+    }
+
+    for (uint32_t t : m_positionTriangles[from])
+    {
+        if (!m_triangleAlive[t])
+            continue;
+
+        if (HasPosition(t, to))
+        {
+            m_triangleAlive[t] = 0;
+            m_liveTriangles--;
+            continue;
+        }
+        uint32_t* tri = &m_triangles[t * 3];
+        for (int c = 0; c < 3; ++c)
+        {
+            if (m_vertexPosition[tri[c]] != from)
+                continue;
+            uint32_t v = tri[c];
+            tri[c] = std::find_if(remap.begin(), remap.end(), [v](const auto& r) { return r.first == v; })->second;
+        }
+        m_positionTriangles[to].push_back(t);
+    }
+    m_positionTriangles[from].clear();
+    m_positionTriangles[from].shrink_to_fit();
+
+    m_quadrics[to].Add(m_quadrics[from]);
+    m_locked[from] = 1;  // Gone; never a collapse source again
+    m_versions[from]++;
+    m_versions[to]++;
+
+    // Drop dead triangles from the survivor's list before re-queueing its edges
+    auto& list = m_positionTriangles[to];
+    list.erase(std::remove_if(list.begin(), list.end(), [this](uint32_t t) { return !m_triangleAlive[t]; }),
+               list.end());
+    PushCollapses(to);
+}
+
+size_t MeshSimplifier::Simplify(size_t targetTriangles, float maxError)
+{
+    double maxCost = (double)maxError * maxError;
+    while (m_liveTriangles > targetTriangles && !m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end());
+        Collapse collapse = m_heap.back();
+        if (collapse.Cost > maxCost)
+        {
+            // Cheapest collapse is too expensive; keep it for a later, looser call
+            std::push_heap(m_heap.begin(), m_heap.end());
+            break;
+        }
+        m_heap.pop_back();
+
+        // Stale: one of the vertices changed since this was queued
+        if (collapse.FromVersion != m_versions[collapse.From] || collapse.ToVersion != m_versions[collapse.To] ||
+            m_locked[collapse.From])
+            continue;
+        if (FlipsTriangles(collapse.From, collapse.To))
+            continue;
+
+        ApplyCollapse(collapse.From, collapse.To);
+        m_error = std::max(m_error, (float)std::sqrt(collapse.Cost));
+    }
+    return m_liveTriangles;
+}
+
+void MeshSimplifier::GetTriangles(uint32_t group, std::vector<uint32_t>& out) const
+{
+    out.clear();
+    for (size_t t = 0; t < m_triangleAlive.size(); ++t)
+    {
+        if (m_triangleAlive[t] && m_groups[t] == group)
+            out.insert(out.end(), m_triangles.begin() + t * 3, m_triangles.begin() + t * 3 + 3);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "Mesh.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Quadric error edge-collapse simplification used to build mesh LODs.
+//
+// Works on welded positions: a collapse moves every vertex at one position
+// onto a neighbouring position (no new vertices are made), re-pointing each
+// corner at the vertex there whose normal matches best, so every level keeps
+// drawing from the original vertex buffer with its exact UVs, normals and
+// skin weights. Positions on a UV seam or between submeshes are locked in
+// place, which keeps those boundaries watertight at every level. Normal
+// creases and open borders stay free but add planes through their edges to
+// the quadrics, so moving off them costs error. Simplify() can be called
+// repeatedly with falling targets; each call continues from the previous
+// result.
+class MeshSimplifier
+{
+public:
+    // triangles: vertex indices into vertices (three per triangle);
+    // groups: one id per triangle (submesh), never merged across
+    MeshSimplifier(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& triangles,
+                   const std::vector<uint32_t>& groups);
+
+    // Collapses edges until targetTriangles remain or the next collapse would
+    // cost more than maxError (world units). Returns the remaining count.
+    size_t Simplify(size_t targetTriangles, float maxError);
+
+    // Current triangles of one group
+    void GetTriangles(uint32_t group, std::vector<uint32_t>& out) const;
+
+    size_t GetTriangleCount() const { return m_liveTriangles; }
+    // Largest collapse error accepted so far (world units)
+    float GetError() const { return m_error; }
+
+private:
+    // Symmetric 4x4 error matrix: xx xy xz xw yy yz yw zz zw ww
+    struct Quadric
+    {
+        double Q[10] = {};
+
+        void AddPlane(double a, double b, double c, double d, double weight);
+        void Add(const Quadric& o);
+        double Evaluate(const glm::dvec3& p) const;
+    };
+
+    struct Collapse
+    {
+        double Cost;
+        uint32_t From, To;
+        uint32_t FromVersion, ToVersion;
+        bool operator<(const Collapse& o) const { return Cost > o.Cost; }  // min-heap
+    };
+
+    // Per vertex
+    std::vector<uint32_t> m_vertexPosition;
+    std::vector<glm::vec3> m_normals;
+    // Per triangle (vertex indices)
+    std::vector<uint32_t> m_triangles;
+    std::vector<uint32_t> m_groups;
+    std::vector<uint8_t> m_triangleAlive;
+    // Per welded position; collapses run between these
+    std::vector<glm::dvec3> m_positions;
+    std::vector<std::vector<uint32_t>> m_positionTriangles;
+    std::vector<Quadric> m_quadrics;
+    std::vector<uint8_t> m_locked;
+    std::vector<uint32_t> m_versions;
+    std::vector<Collapse> m_heap;
+    size_t m_liveTriangles = 0;
+    float m_error = 0.0f;
+
+    void WeldPositions(const std::vector<Vertex>& vertices);
+    void ClassifyPositions(const std::vector<Vertex>& vertices);
+    void PushCollapses(uint32_t position);
+    bool TryPush(uint32_t from, uint32_t to);
+    bool HasPosition(uint32_t triangle, uint32_t position) const;
+    bool FlipsTriangles(uint32_t from, uint32_t to) const;
+    uint32_t PickVertex(uint32_t vertex, uint32_t from, uint32_t to) const;
+    void ApplyCollapse(uint32_t from, uint32_t to);
+};
@@ -0,0 +1,461 @@
+#include "OcclusionCuller.h"
+#include "FrustumCuller.h"
+#include "Mesh.h"
+#include "../core/WorkerPool.h"
+#include "../resources/EntityManager.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define CATBOX_CULL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    // Clip-space w below which a box corner counts as behind the camera
+    constexpr float MIN_CLIP_W = 1e-4f;
+
+    // Entities per test batch: whole 64-bit visibility words per task
+    constexpr size_t TEST_BATCH = 64;
+}
+
+void OcclusionCuller::Cull(const EntityManager& entityManager, const FrustumCuller& culler, const std::vector<uint8_t>& entityLOD,
+                           const glm::mat4& viewProj, VisibilitySet& visibility)
+{
+    m_occluderCount = 0;
+    m_triangles.clear();
+    m_culledCount = 0;
+
+    size_t count = culler.GetCount();
+    if (count == 0)
+        return;
+
+    WorkerPool& pool = WorkerPool::Instance();
+
+    // Screen rectangle and nearest depth of every box
+    m_bounds.resize(count);
+    pool.ParallelFor(count, 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (culler.IsUnbounded(i))
+                m_bounds[i].Valid = false;
+            else
+                m_bounds[i] = ProjectBox(culler.GetBoundsMin(i), culler.GetBoundsMax(i), viewProj);
+        }
+    });
+
+    SelectOccluders(entityManager, culler, entityLOD, visibility);
+    if (m_occluderCount == 0)
+        return;
+
+    // Transform, clip and set up each occluder's triangles
+    pool.ParallelFor((size_t)m_occluderCount, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k)
+        {
+            Occluder& occluder = m_occluders[k];
+            SetupOccluder(occluder, viewProj * culler.GetWorldMatrix(occluder.EntityIndex));
+        }
+    });
+    for (int k = 0; k < m_occluderCount; ++k)
+        m_triangles.insert(m_triangles.end(), m_occluders[k].Triangles.begin(), m_occluders[k].Triangles.end());
+
+    // Each task owns one row of tiles: no two tasks write the same pixel
+    m_depth.resize(WIDTH * HEIGHT);
+    m_tileMaxDepth.resize(TILES_X * TILES_Y);
+    pool.ParallelFor(TILES_Y, 1, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row)
+            RasterizeBand((int)row);
+    });
+
+    std::atomic<int> culled{ 0 };
+    pool.ParallelFor(count, TEST_BATCH, [&](size_t begin, size_t end) {
+        int local = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (m_isOccluder[i] || !visibility.Test(i))
+                continue;
+            if (IsOccluded(m_bounds[i]))
+            {
+                visibility.Clear(i);
+                ++local;
+            }
+        }
+        culled += local;
+    });
+    m_culledCount = culled;
+}
+
+OcclusionCuller::ScreenBounds OcclusionCuller::ProjectBox(const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                                          const glm::mat4& viewProj)
+{
+    ScreenBounds b;
+    b.MinX = b.MinY = b.MinZ = FLT_MAX;
+    b.MaxX = b.MaxY = -FLT_MAX;
+    b.Valid = true;
+
+    for (int c = 0; c < 8; ++c)
+    {
+        glm::vec4 corner((c & 1) ? boxMax.x : boxMin.x,
+                         (c & 2) ? boxMax.y : boxMin.y,
+                         (c & 4) ? boxMax.z : boxMin.z, 1.0f);
+        glm::vec4 clip = viewProj * corner;
+        if (clip.w <= MIN_CLIP_W)
+        {
+            b.Valid = false;
+            return b;
+        }
+
+        float invW = 1.0f / clip.w;
+        float x = (clip.x * invW * 0.5f + 0.5f) * WIDTH;
+        float y = (clip.y * invW * 0.5f + 0.5f) * HEIGHT;
+        float z = clip.z * invW * 0.5f + 0.5f;
+        b.MinX = std::min(b.MinX, x);
+        b.MaxX = std::max(b.MaxX, x);
+        b.MinY = std::min(b.MinY, y);
+        b.MaxY = std::max(b.MaxY, y);
+        b.MinZ = std::min(b.MinZ, z);
+    }
+    return b;
+}
+
+void OcclusionCuller::SelectOccluders(const EntityManager& entityManager, const FrustumCuller& culler,
+                                      const std::vector<uint8_t>& entityLOD, const VisibilitySet& visibility)
+{
+    const auto& entities = entityManager.GetAll();
+    size_t count = std::min(entities.size(), culler.GetCount());
+    m_isOccluder.assign(culler.GetCount(), 0);
+
+    // (screen area, entity); tagged occluders sort first
+    std::vector<std::pair<float, size_t>> candidates;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Entity& e = entities[i];
+        if (!visibility.Test(i) || culler.IsUnbounded(i) || e.Alpha < 1.0f)
+            continue;
+
+        // Skinned meshes only have their bind pose on the CPU
+        const Mesh* mesh = culler.GetMesh(i);
+        if (!mesh || mesh->HasSkeleton || mesh->Indices.empty() || mesh->Vertices.empty())
+            continue;
+        int lod = i < entityLOD.size() ? entityLOD[i] : 0;
+
+        float area;
+        if (e.IsOccluder)
+        {
+            area = FLT_MAX;
+        }
+        else
+        {
+            if (mesh->GetTriangleCount(lod) > MAX_AUTO_OCCLUDER_TRIANGLES)
+                continue;
+
+            // The camera is inside or right next to the box: it can hide anything
+            const ScreenBounds& b = m_bounds[i];
+            if (!b.Valid)
+            {
+                area = 1.0f;
+            }
+            else
+            {
+                float w = std::min(b.MaxX, (float)WIDTH) - std::max(b.MinX, 0.0f);
+                float h = std::min(b.MaxY, (float)HEIGHT) - std::max(b.MinY, 0.0f);
+                area = (w > 0.0f && h > 0.0f) ? (w * h) / (WIDTH * HEIGHT) : 0.0f;
+            }
+            if (area < MIN_OCCLUDER_SCREEN_AREA)
+                continue;
+        }
+        candidates.push_back({ area, i });
+    }
+
+    size_t selected = std::min(candidates.size(), (size_t)MAX_OCCLUDERS);
+    std::partial_sort(candidates.begin(), candidates.begin() + selected, candidates.end(),
+                      [](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) { return a.first > b.first; });
+
+    if (m_occluders.size() < selected)
+        m_occluders.resize(selected);
+    for (size_t k = 0; k < selected; ++k)
+    {
+        size_t i = candidates[k].second;
+        m_occluders[k].EntityIndex = i;
+        m_occluders[k].OccluderMesh = culler.GetMesh(i);
+        m_occluders[k].LOD = i < entityLOD.size() ? entityLOD[i] : 0;
+        m_isOccluder[i] = 1;
+    }
+    m_occluderCount = (int)selected;
+}
+
+void OcclusionCuller::SetupOccluder(Occluder& occluder, const glm::mat4& mvp)
+{
+    const Mesh& mesh = *occluder.OccluderMesh;
+    occluder.Triangles.clear();
+
+    occluder.ClipVertices.resize(mesh.Vertices.size());
+    for (size_t v = 0; v < mesh.Vertices.size(); ++v)
+    {
+        const Vec3& p = mesh.Vertices[v].Position;
+        occluder.ClipVertices[v] = mvp * glm::vec4(p.x, p.y, p.z, 1.0f);
+    }
+
+    // LOD ranges index past Indices, into LODIndices (same element buffer)
+    const uint32_t lodBase = (uint32_t)mesh.Indices.size();
+    auto indexAt = [&](uint32_t i) { return i < lodBase ? mesh.Indices[i] : mesh.LODIndices[i - lodBase]; };
+
+    auto addRange = [&](uint32_t firstIndex, uint32_t indexCount, uint32_t baseVertex) {
+        uint32_t end = std::min(firstIndex + indexCount, lodBase + (uint32_t)mesh.LODIndices.size());
+        for (uint32_t i = firstIndex; i + 2 < end; i += 3)
+        {
+            size_t i0 = indexAt(i) + baseVertex;
+            size_t i1 = indexAt(i + 1) + baseVertex;
+            size_t i2 = indexAt(i + 2) + baseVertex;
+            if (i0 >= occluder.ClipVertices.size() || i1 >= occluder.ClipVertices.size() ||
+                i2 >= occluder.ClipVertices.size())
+                continue;
+
+            const glm::vec4& a = occluder.ClipVertices[i0];
+            const glm::vec4& b = occluder.ClipVertices[i1];
+            const glm::vec4& c = occluder.ClipVertices[i2];
+
+            // Entirely outside one side of the frustum (near handled by clipping)
+            if ((a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+                (a.y > a.w && b.y > b.w && c.y > c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w) ||
+                (a.z > a.w && b.z > b.w && c.z > c.w))
+                continue;
+
+            // Distance to the near plane (z = -w); clip the triangle where it crosses
+            float da = a.z + a.w, db = b.z + b.w, dc = c.z + c.w;
+            if (da >= 0.0f && db >= 0.0f && dc >= 0.0f)
+            {
+                EmitTriangle(a, b, c, occluder.Triangles);
+                continue;
+            }
+            if (da < 0.0f && db < 0.0f && dc < 0.0f)
+                continue;
+
+            glm::vec4 polygon[4];
+            int n = 0;
+            const glm::vec4* in[3] = { &a, &b, &c };
+            float d[3] = { da, db, dc };
+            for (int e = 0; e < 3; ++e)
+            {
+                int next = (e + 1) % 3;
+                if (d[e] >= 0.0f)
+                    polygon[n++] = *in[e];
+                if ((d[e] >= 0.0f) != (d[next] >= 0.0f))
+                {
+                    float t = d[e] / (d[e] - d[next]);
+                    polygon[n++] = *in[e] + (*in[next] - *in[e]) * t;
+                }
+            }
+            for (int k = 1; k + 1 < n; ++k)
+                EmitTriangle(polygon[0], polygon[k], polygon[k + 1], occluder.Triangles);
+        }
+    };
+
+    // The level drawn this frame: one range per submesh, as in Mesh::DrawSubMesh
+    const MeshLOD* level = nullptr;
+    if (occluder.LOD > 0 && occluder.LOD <= (int)mesh.LODs.size())
+        level = &mesh.LODs[occluder.LOD - 1];
+    if (mesh.SubMeshes.empty())
+    {
+        if (level)
+            addRange(level->Ranges[0].FirstIndex, level->Ranges[0].IndexCount, 0);
+        else
+            addRange(0, lodBase, 0);
+    }
+    else
+    {
+        for (size_t s = 0; s < mesh.SubMeshes.size(); ++s)
+        {
+            const SubMesh& sub = mesh.SubMeshes[s];
+            if (level)
+                addRange(level->Ranges[s].FirstIndex, level->Ranges[s].IndexCount, sub.BaseVertex);
+            else
+                addRange(sub.FirstIndex, sub.IndexCount, sub.BaseVertex);
+        }
+    }
+}
+
+void OcclusionCuller::EmitTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c,
+                                   std::vector<ScreenTriangle>& out)
+{
+    // To pixels (bottom-left origin) and [0,1] depth
+    glm::vec3 v[3];
+    const glm::vec4* clip[3] = { &a, &b, &c };
+    for (int i = 0; i < 3; ++i)
+    {
+        float invW = 1.0f / clip[i]->w;
+        v[i] = glm::vec3((clip[i]->x * invW * 0.5f + 0.5f) * WIDTH,
+                         (clip[i]->y * invW * 0.5f + 0.5f) * HEIGHT,
+                         clip[i]->z * invW * 0.5f + 0.5f);
+    }
+
+    // Both windings occlude; make it counter-clockwise
+    float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+    if (area < 0.0f)
+    {
+        std::swap(v[1], v[2]);
+        area = -area;
+    }
+    if (area <= 1e-6f)
+        return;
+
+    // Pixels whose centres (x + 0.5) can fall inside
+    float minX = std::min(v[0].x, std::min(v[1].x, v[2].x));
+    float maxX = std::max(v[0].x, std::max(v[1].x, v[2].x));
+    float minY = std::min(v[0].y, std::min(v[1].y, v[2].y));
+    float maxY = std::max(v[0].y, std::max(v[1].y, v[2].y));
+
+    ScreenTriangle tri;
+    tri.MinX = std::max((int)std::ceil(minX - 0.5f), 0);
+    tri.MaxX = std::min((int)std::floor(maxX - 0.5f), WIDTH - 1);
+    tri.MinY = std::max((int)std::ceil(minY - 0.5f), 0);
+    tri.MaxY = std::min((int)std::floor(maxY - 0.5f), HEIGHT - 1);
+    if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY)
+        return;
+
+    for (int e = 0; e < 3; ++e)
+    {
+        const glm::vec3& p0 = v[e];
+        const glm::vec3& p1 = v[(e + 1) % 3];
+        tri.EdgeA[e] = p0.y - p1.y;
+        tri.EdgeB[e] = p1.x - p0.x;
+        tri.EdgeC[e] = -(tri.EdgeA[e] * p0.x + tri.EdgeB[e] * p0.y);
+    }
+
+    float dzdx = ((v[1].z - v[0].z) * (v[2].y - v[0].y) - (v[2].z - v[0].z) * (v[1].y - v[0].y)) / area;
+    float dzdy = ((v[2].z - v[0].z) * (v[1].x - v[0].x) - (v[1].z - v[0].z) * (v[2].x - v[0].x)) / area;
+    tri.ZA = dzdx;
+    tri.ZB = dzdy;
+    tri.ZC = v[0].z - dzdx * v[0].x - dzdy * v[0].y;
+    out.push_back(tri);
+}
+
+void OcclusionCuller::RasterizeBand(int tileRow)
+{
+    int minY = tileRow * TILE_SIZE;
+    int maxY = minY + TILE_SIZE - 1;
+    std::fill(m_depth.begin() + minY * WIDTH, m_depth.begin() + (maxY + 1) * WIDTH, 1.0f);
+
+    for (const ScreenTriangle& tri : m_triangles)
+    {
+        if (tri.MaxY < minY || tri.MinY > maxY)
+            continue;
+        RasterizeRows(tri, std::max(tri.MinY, minY), std::min(tri.MaxY, maxY));
+    }
+
+    // Farthest depth per tile for the coarse test
+    for (int tx = 0; tx < TILES_X; ++tx)
+    {
+        float farthest = 0.0f;
+        for (int y = minY; y <= maxY; ++y)
+        {
+            const float* row = &m_depth[y * WIDTH + tx * TILE_SIZE];
+            for (int x = 0; x < TILE_SIZE; ++x)
+                farthest = std::max(farthest, row[x]);
+        }
+        m_tileMaxDepth[tileRow * TILES_X + tx] = farthest;
+    }
+}
+
+void OcclusionCuller::RasterizeRows(const ScreenTriangle& tri, int minY, int maxY)
+{
+    // Start on a multiple of four; lanes left of MinX fail the edge tests anyway
+    int startX = tri.MinX & ~3;
+
+#ifdef CATBOX_CULL_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 step = _mm_set1_ps(4.0f);
+    const __m128 startPx = _mm_add_ps(_mm_set1_ps((float)startX), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+    __m128 edgeA[3], stepE[3];
+    for (int e = 0; e < 3; ++e)
+    {
+        edgeA[e] = _mm_set1_ps(tri.EdgeA[e]);
+        stepE[e] = _mm_mul_ps(edgeA[e], step);
+    }
+    const __m128 zA = _mm_set1_ps(tri.ZA);
+    const __m128 stepZ = _mm_mul_ps(zA, step);
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        float py = y + 0.5f;
+        __m128 e0 = _mm_add_ps(_mm_mul_ps(edgeA[0], startPx), _mm_set1_ps(tri.EdgeB[0] * py + tri.EdgeC[0]));
+        __m128 e1 = _mm_add_ps(_mm_mul_ps(edgeA[1], startPx), _mm_set1_ps(tri.EdgeB[1] * py + tri.EdgeC[1]));
+        __m128 e2 = _mm_add_ps(_mm_mul_ps(edgeA[2], startPx), _mm_set1_ps(tri.EdgeB[2] * py + tri.EdgeC[2]));
+        __m128 z = _mm_add_ps(_mm_mul_ps(zA, startPx), _mm_set1_ps(tri.ZB * py + tri.ZC));
+
+        float* row = &m_depth[y * WIDTH];
+        for (int x = startX; x <= tri.MaxX; x += 4)
+        {
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                       _mm_cmpge_ps(e2, zero));
+            if (_mm_movemask_ps(inside))
+            {
+                __m128 depth = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(depth, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, depth)));
+            }
+            e0 = _mm_add_ps(e0, stepE[0]);
+            e1 = _mm_add_ps(e1, stepE[1]);
+            e2 = _mm_add_ps(e2, stepE[2]);
+            z = _mm_add_ps(z, stepZ);
+        }
+    }
+#else
+    for (int y = minY; y <= maxY; ++y)
+    {
+        float py = y + 0.5f;
+        float* row = &m_depth[y * WIDTH];
+        for (int x = startX; x <= tri.MaxX; ++x)
+        {
+            float px = x + 0.5f;
+            if (tri.EdgeA[0] * px + tri.EdgeB[0] * py + tri.EdgeC[0] < 0.0f ||
+                tri.EdgeA[1] * px + tri.EdgeB[1] * py + tri.EdgeC[1] < 0.0f ||
+                tri.EdgeA[2] * px + tri.EdgeB[2] * py + tri.EdgeC[2] < 0.0f)
+                continue;
+            row[x] = std::min(row[x], tri.ZA * px + tri.ZB * py + tri.ZC);
+        }
+    }
+#endif
+}
+
+bool OcclusionCuller::IsOccluded(const ScreenBounds& bounds) const
+{
+    if (!bounds.Valid)
+        return false;
+
+    // Every pixel the rectangle touches
+    int minX = std::max((int)std::floor(bounds.MinX), 0);
+    int maxX = std::min((int)std::floor(bounds.MaxX), WIDTH - 1);
+    int minY = std::max((int)std::floor(bounds.MinY), 0);
+    int maxY = std::min((int)std::floor(bounds.MaxY), HEIGHT - 1);
+    if (minX > maxX || minY > maxY)
+        return false;
+
+    float z = bounds.MinZ;
+    for (int ty = minY / TILE_SIZE; ty <= maxY / TILE_SIZE; ++ty)
+    {
+        for (int tx = minX / TILE_SIZE; tx <= maxX / TILE_SIZE; ++tx)
+        {
+            // The whole tile is nearer than the box
+            if (m_tileMaxDepth[ty * TILES_X + tx] < z)
+                continue;
+
+            int y0 = std::max(minY, ty * TILE_SIZE), y1 = std::min(maxY, ty * TILE_SIZE + TILE_SIZE - 1);
+            int x0 = std::max(minX, tx * TILE_SIZE), x1 = std::min(maxX, tx * TILE_SIZE + TILE_SIZE - 1);
+            for (int y = y0; y <= y1; ++y)
+            {
+                const float* row = &m_depth[y * WIDTH];
+                for (int x = x0; x <= x1; ++x)
+                {
+                    if (row[x] >= z)
+                        return false;
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class EntityManager;
+class FrustumCuller;
+struct Mesh;
+struct VisibilitySet;
+
+// CPU software occlusion culling for the camera view.
+//
+// A few large occluders (entities tagged Entity::IsOccluder, then the
+// biggest opaque meshes on screen) are rasterized into a small depth buffer
+// on the worker threads, one band of tile rows per task and four pixels at a
+// time with SSE. Each TILE_SIZE square also keeps the farthest depth it
+// holds, so most boxes are settled per tile before any pixel is read. An
+// entity whose box is behind every depth it covers is removed from the
+// camera's visibility set; shadow views are left alone. Nothing is read back
+// from the GPU, so the result is the same on every driver.
+class OcclusionCuller
+{
+public:
+    // Rasterizes this frame's occluders and clears the hidden entities from
+    // visibility (the camera set after frustum culling). entityLOD is the
+    // level of detail chosen per entity; occluders rasterize that level.
+    void Cull(const EntityManager& entityManager, const FrustumCuller& culler, const std::vector<uint8_t>& entityLOD,
+              const glm::mat4& viewProj, VisibilitySet& visibility);
+
+    // Last Cull()
+    int GetOccluderCount() const { return m_occluderCount; }
+    int GetTriangleCount() const { return (int)m_triangles.size(); }
+    int GetCulledCount() const { return m_culledCount; }
+
+    // Depth buffer size; multiples of TILE_SIZE (and of 4 for the SSE rows)
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 128;
+    static constexpr int TILE_SIZE = 8;
+    static constexpr int TILES_X = WIDTH / TILE_SIZE;
+    static constexpr int TILES_Y = HEIGHT / TILE_SIZE;
+
+    static constexpr int MAX_OCCLUDERS = 24;
+    // Automatic occluders: minimum share of the screen covered by their
+    // bounds, and a triangle limit so dense meshes are not rasterized
+    static constexpr float MIN_OCCLUDER_SCREEN_AREA = 0.02f;
+    static constexpr size_t MAX_AUTO_OCCLUDER_TRIANGLES = 20000;
+
+private:
+    // Projected box: pixel rectangle and nearest depth
+    struct ScreenBounds
+    {
+        float MinX, MinY, MaxX, MaxY;
+        float MinZ;
+        bool Valid;  // False when part of the box is behind the camera
+    };
+
+    // Edge functions and depth plane in pixel space, E = A*x + B*y + C >= 0 inside
+    struct ScreenTriangle
+    {
+        float EdgeA[3], EdgeB[3], EdgeC[3];
+        float ZA, ZB, ZC;
+        int MinX, MaxX, MinY, MaxY;
+    };
+
+    struct Occluder
+    {
+        size_t EntityIndex;
+        const Mesh* OccluderMesh;
+        int LOD;
+        std::vector<glm::vec4> ClipVertices;
+        std::vector<ScreenTriangle> Triangles;
+    };
+
+    std::vector<float> m_depth;         // WIDTH * HEIGHT, NDC depth in [0,1], cleared to 1
+    std::vector<float> m_tileMaxDepth;  // TILES_X * TILES_Y
+    std::vector<ScreenBounds> m_bounds; // Per entity
+    std::vector<uint8_t> m_isOccluder;  // Per entity; occluders are never tested
+    std::vector<Occluder> m_occluders;  // Kept between frames for their buffers
+    int m_occluderCount = 0;
+    std::vector<ScreenTriangle> m_triangles;
+    int m_culledCount = 0;
+
+    static ScreenBounds ProjectBox(const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::mat4& viewProj);
+    void SelectOccluders(const EntityManager& entityManager, const FrustumCuller& culler,
+                         const std::vector<uint8_t>& entityLOD, const VisibilitySet& visibility);
+    static void SetupOccluder(Occluder& occluder, const glm::mat4& mvp);
+    static void EmitTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c,
+                             std::vector<ScreenTriangle>& out);
+    void RasterizeBand(int tileRow);
+    void RasterizeRows(const ScreenTriangle& tri, int minY, int maxY);
+    bool IsOccluded(const ScreenBounds& bounds) const;
+};
@@ -3,13 +3,32 @@
 #include "MeshManager.h"
 #include "Light.h"
 #include "GraphicsSettings.h"
+#include "TerrainQuadtree.h"
+#include "StreamBuffer.h"
+#include "DebugDraw.h"
 #include "../resources/Entity.h"
-#include "../gameplay/AnimationSystem.h"
+#include "../core/WorkerPool.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+
+namespace
+{
+    // FNV-1a style mixing for the static caster sets of shadow tiles
+    constexpr uint64_t HASH_SEED = 14695981039346656037ull;
+
+    uint64_t HashCombine(uint64_t hash, uint64_t value)
+    {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        return hash * 1099511628211ull;
+    }
+}
 
 RenderPipeline::RenderPipeline()
 {
@@ -17,8 +36,9 @@ RenderPipeline::RenderPipeline()
 
 RenderPipeline::~RenderPipeline()
 {
-    if (m_lineVAO != 0) { glDeleteVertexArrays(1, &m_lineVAO); m_lineVAO = 0; }
-    if (m_lineVBO != 0) { glDeleteBuffers(1, &m_lineVBO); m_lineVBO = 0; }
+    DebugDraw::Instance().Release();
+    if (m_skinnedInstanceBuffer != 0) { glDeleteBuffers(1, &m_skinnedInstanceBuffer); m_skinnedInstanceBuffer = 0; }
+    StreamBuffer::Instance().Release();
 }
 
 bool RenderPipeline::Initialize()
@@ -28,8 +48,24 @@ bool RenderPipeline::Initialize()
     
     // Initialize shadow shader
     m_shadowShader.Initialize("./shaders/ShadowMap.vert", "./shaders/ShadowMap.frag");
+    
+    // Depth pre-pass (GraphicsSettings::DepthPrepass)
+    m_depthShader.Initialize("./shaders/DepthPrepass.vert", "./shaders/DepthPrepass.frag");
+
+    // Per-frame uploads fall back to glBufferData without it
+    StreamBuffer::Instance().Initialize();
+
+    if (!DebugDraw::Instance().Initialize())
+        std::cerr << "RenderPipeline: debug draw unavailable.\n";
 
-    InitLineRenderer();
+    // Skinned meshes are drawn in their bind pose if the compute pass is unavailable
+    if (!m_skinningPass.Initialize())
+        std::cerr << "RenderPipeline: skinning pass failed to initialize.\n";
+
+    // Deferred path stays unavailable (forward is used) if its shaders fail
+    m_deferredReady = m_gbufferPass.Initialize() && m_lightingPass.Initialize();
+    if (!m_deferredReady)
+        std::cerr << "RenderPipeline: deferred path failed to initialize, using forward.\n";
 
     if (!m_skybox.Initialize())
         std::cerr << "RenderPipeline: skybox failed to initialize.\n";
@@ -40,23 +76,113 @@ bool RenderPipeline::Initialize()
 void RenderPipeline::Render(EntityManager& entityManager, Camera& camera, int displayWidth, int displayHeight)
 {
     m_stats.Reset();
+    ++m_frameIndex;
+    StreamBuffer::Instance().BeginFrame();
+
+    camera.Aspect = (float)displayWidth / (float)displayHeight;
+    glm::mat4 view = camera.GetViewMatrix();
+    glm::mat4 proj = camera.GetProjectionMatrix();
+    glm::mat4 viewProj = proj * view;
+
+    // World matrices and bounds are built once and shared by every pass
+    m_culler.Gather(entityManager);
+    SelectLODs(entityManager, camera);
+    SelectTerrainChunks(entityManager, camera);
+
+    // One visibility pass for the camera and every shadow-casting light
+    BuildViews(camera, view, viewProj);
+    if (m_enableFrustumCulling)
+    {
+        if (m_enableBVHCulling)
+        {
+            m_bvh.Update(entityManager, m_culler);
+            m_bvh.Cull(m_viewFrusta, m_viewCount, m_visibility);
+        }
+        else
+        {
+            m_culler.Cull(m_viewFrusta, m_viewCount, m_visibility);
+        }
+
+        // Camera only: occluded entities still cast shadows
+        if (GraphicsSettings::Instance().OcclusionCulling && m_viewCount > 0)
+        {
+            m_occlusionCuller.Cull(entityManager, m_culler, m_entityLOD, viewProj, m_visibility.Views[0]);
+            m_stats.Occluders = m_occlusionCuller.GetOccluderCount();
+            m_stats.OccluderTriangles = m_occlusionCuller.GetTriangleCount();
+            m_stats.OcclusionCulled = m_occlusionCuller.GetCulledCount();
+        }
+    }
+    m_stats.ViewCount = m_viewCount;
+
+    if (GraphicsSettings::Instance().DebugDrawBounds)
+        QueueEntityBounds();
+
+    // Skin every animated mesh once; all views read the result
+    m_bonePalette.Update(entityManager, m_culler.GetCount());
+    m_skinningPass.Execute(entityManager, m_culler.GetCount(), m_bonePalette);
+    m_stats.SkinnedVertices = (int)m_skinningPass.GetVertexCount();
+    m_stats.BonePaletteBytes = (int)m_bonePalette.GetByteSize();
+    BuildSkinnedBatches(entityManager);
+    BuildDrawList(entityManager);
 
     // 1. Shadow Pass - Render shadow maps for all lights
     if (m_enableShadows)
     {
+        m_shadowTimer.Begin();
         ShadowPass(entityManager);
+        m_shadowTimer.End();
+        m_stats.ShadowPassTime = m_shadowTimer.GetMilliseconds();
     }
 
-    // Reset viewport for main rendering
-    glViewport(0, 0, displayWidth, displayHeight);
+    BuildShadowTileTable();
 
-    // 2. Geometry Pass - Render scene with lighting
-    camera.Aspect = (float)displayWidth / (float)displayHeight;
-    glm::mat4 view = camera.GetViewMatrix();
-    glm::mat4 proj = camera.GetProjectionMatrix();
-    glm::mat4 viewProj = proj * view;
+    // Pack the lights once; clusters also serve forward draws on the deferred path
+    m_lightBuffer.Update(LightManager::Instance().GetAllLights(), m_shadowTable);
+    m_forwardPass.AssignLights(m_lightBuffer, camera, view, proj, displayWidth, displayHeight);
+    m_stats.LightCount = (int)m_lightBuffer.GetCount();
+    m_stats.ClusterLightRefs = m_forwardPass.GetClusterLightRefs();
+
+    // 2. Opaque geometry: shaded while drawing, or G-buffer + lighting pass
+    if (GraphicsSettings::Instance().Path == RenderPath::Deferred && m_deferredReady)
+    {
+        DeferredPass(camera, view, proj, displayWidth, displayHeight);
+    }
+    else
+    {
+        // Reset viewport for main rendering
+        glViewport(0, 0, displayWidth, displayHeight);
+
+        bool prepass = GraphicsSettings::Instance().DepthPrepass;
+        if (prepass)
+        {
+            m_prepassTimer.Begin();
+            DepthPrepass(entityManager, viewProj);
+            m_prepassTimer.End();
+            m_stats.DepthPrepassTime = m_prepassTimer.GetMilliseconds();
+
+            // Depth is final: shade only the surface that won
+            glDepthFunc(GL_LEQUAL);
+            glDepthMask(GL_FALSE);
+        }
 
-    GeometryPass(entityManager, camera, viewProj);
+        m_mainTimer.Begin();
+        GeometryPass(camera, viewProj);
+        m_mainTimer.End();
+        m_stats.MainPassTime = m_mainTimer.GetMilliseconds();
+
+        if (prepass)
+        {
+            glDepthMask(GL_TRUE);
+            glDepthFunc(GL_LESS);
+            m_opaqueTimeWithPrepass = m_stats.DepthPrepassTime + m_stats.MainPassTime;
+        }
+        else
+        {
+            m_opaqueTimeWithoutPrepass = m_stats.MainPassTime;
+        }
+    }
+    m_stats.OpaqueTimeWithoutPrepass = m_opaqueTimeWithoutPrepass;
+    m_stats.OpaqueTimeWithPrepass = m_opaqueTimeWithPrepass;
 
     // 3. Skybox Pass — drawn after opaque geometry so the depth buffer is
     //    populated and the sky only fills pixels at maximum depth (far plane).
@@ -80,18 +206,275 @@ void RenderPipeline::Render(EntityManager& entityManager, Camera& camera, int di
         }
     }
 
-    // 4. Render light indicators (debug visualization)
+    // 4. Light indicators and everything else queued for debug drawing
     if (m_enableLightIndicators)
     {
-        RenderLightIndicators(viewProj);
+        QueueLightIndicators();
     }
+    m_stats.DebugPrimitives = DebugDraw::Instance().Flush(viewProj);
+
+    m_stats.StreamedBytes = (int)StreamBuffer::Instance().GetUsedBytes();
+}
+
+void RenderPipeline::BuildViews(const Camera& camera, const glm::mat4& cameraView, const glm::mat4& cameraViewProj)
+{
+    auto& lightMgr = LightManager::Instance();
+    auto& lights = lightMgr.GetAllLights();
+    lightMgr.UpdateShadowResources(camera, MAX_SHADOWED_LIGHTS);
+
+    m_viewCount = 0;
+    m_viewFrusta[m_viewCount++] = Frustum::FromMatrix(cameraViewProj);
+
+    // Only the first lights get shadow views
+    m_shadowViews.clear();
+    size_t shadowedLights = std::min(lights.size(), (size_t)MAX_SHADOWED_LIGHTS);
+    for (size_t i = 0; i < shadowedLights; ++i)
+    {
+        Light& light = lights[i];
+        // No tiles: off screen, or the atlas had no room this frame
+        if (!m_enableShadows || !light.CastsShadows || !light.Enabled || light.ShadowTileCount == 0)
+            continue;
+
+        if (light.UsesCascades())
+        {
+            if (m_viewCount + light.ShadowTileCount > MultiViewVisibility::MAX_VIEWS)
+                continue;
+
+            // Each cascade is its own view so casters are culled per slice
+            ComputeCascades(light, camera, cameraView, light.ShadowTiles[0].Size);
+            for (int c = 0; c < light.ShadowTileCount; ++c)
+            {
+                m_viewFrusta[m_viewCount] = Frustum::FromMatrix(light.CascadeMatrices[c]);
+                m_shadowViews.push_back({ (int)i, c, m_viewCount++ });
+            }
+        }
+        else
+        {
+            if (m_viewCount >= MultiViewVisibility::MAX_VIEWS)
+                continue;
+
+            light.LightSpaceMatrix = ComputeLightSpaceMatrix(light);
+            m_viewFrusta[m_viewCount] = Frustum::FromMatrix(light.LightSpaceMatrix);
+            m_shadowViews.push_back({ (int)i, -1, m_viewCount++ });
+        }
+    }
+}
+
+void RenderPipeline::ComputeCascades(Light& light, const Camera& camera, const glm::mat4& cameraView, int tileSize)
+{
+    int count = std::min(light.CascadeCount, MAX_SHADOW_CASCADES);
+    float nearZ = camera.Near;
+    float farZ = std::max(std::min(camera.Far, light.ShadowDistance), nearZ + 0.01f);
+
+    // Practical split scheme: blend logarithmic and uniform distribution
+    float splits[MAX_SHADOW_CASCADES + 1];
+    splits[0] = nearZ;
+    for (int c = 1; c <= count; ++c)
+    {
+        float p = (float)c / (float)count;
+        float logSplit = nearZ * std::pow(farZ / nearZ, p);
+        float uniformSplit = nearZ + (farZ - nearZ) * p;
+        splits[c] = light.CascadeSplitLambda * logSplit + (1.0f - light.CascadeSplitLambda) * uniformSplit;
+    }
+
+    glm::vec3 direction(light.Direction.x, light.Direction.y, light.Direction.z);
+    direction = glm::length(direction) > 0.001f ? glm::normalize(direction) : glm::vec3(0.0f, -1.0f, 0.0f);
+    glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+    // Rotation only: the texel grid stays fixed in world space while the camera moves
+    glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), direction, up);
+    glm::mat4 invView = glm::inverse(cameraView);
+
+    // Squared slope of the frustum corner rays
+    float tanHalfFov = std::tan(glm::radians(camera.FOV) * 0.5f);
+    float k = tanHalfFov * tanHalfFov * (1.0f + camera.Aspect * camera.Aspect);
+
+    for (int c = 0; c < count; ++c)
+    {
+        float n = splits[c];
+        float f = splits[c + 1];
+
+        // Bounding sphere of the slice, centred on the view axis. Its size does
+        // not change as the camera turns, which texel snapping relies on.
+        float d = 0.5f * (f + n) * (1.0f + k);
+        float radius;
+        if (d >= f)
+        {
+            d = f;
+            radius = f * std::sqrt(k);
+        }
+        else
+        {
+            radius = std::sqrt((d - n) * (d - n) + n * n * k);
+        }
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        glm::vec3 centre = glm::vec3(invView * glm::vec4(0.0f, 0.0f, -d, 1.0f));
+        glm::vec3 lightCentre = glm::vec3(lightRotation * glm::vec4(centre, 1.0f));
+
+        // Snap to whole shadow texels to stop edges shimmering
+        float texel = 2.0f * radius / (float)tileSize;
+        lightCentre.x = std::floor(lightCentre.x / texel) * texel;
+        lightCentre.y = std::floor(lightCentre.y / texel) * texel;
+
+        // Near plane pulled back towards the light so off-screen casters still land in the map
+        glm::mat4 projection = glm::ortho(lightCentre.x - radius, lightCentre.x + radius,
+                                          lightCentre.y - radius, lightCentre.y + radius,
+                                          -lightCentre.z - radius - light.CascadeCasterRange,
+                                          -lightCentre.z + radius);
+        light.CascadeMatrices[c] = projection * lightRotation;
+        light.CascadeSplits[c] = f;
+    }
+}
+
+glm::mat4 RenderPipeline::ComputeLightSpaceMatrix(const Light& light)
+{
+    glm::mat4 lightProjection, lightView;
+    
+    if (light.Type == LightType::Directional)
+    {
+        float size = light.ShadowOrthoSize;
+        lightProjection = glm::ortho(-size, size, -size, size, light.ShadowNearPlane, light.ShadowFarPlane);
+        
+        // Position light opposite to direction
+        glm::vec3 lightPos(-light.Direction.x * 10.0f, -light.Direction.y * 10.0f, -light.Direction.z * 10.0f);
+        glm::vec3 target = lightPos + glm::vec3(light.Direction.x, light.Direction.y, light.Direction.z);
+        lightView = glm::lookAt(lightPos, target, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    else // Point or Spot light
+    {
+        // Normalize direction
+        glm::vec3 direction(light.Direction.x, light.Direction.y, light.Direction.z);
+        float dirLength = glm::length(direction);
+        if (dirLength > 0.001f)
+        {
+            direction = glm::normalize(direction);
+        }
+        else
+        {
+            direction = glm::vec3(0.0f, -1.0f, 0.0f); // Default downward
+        }
+        
+        float fov = (light.Type == LightType::Spot) ? light.OuterCutoff * 2.0f : light.ShadowFOV;
+        lightProjection = glm::perspective(glm::radians(fov), 1.0f, light.ShadowNearPlane, light.ShadowFarPlane);
+        
+        glm::vec3 lightPos(light.Position.x, light.Position.y, light.Position.z);
+        glm::vec3 target = lightPos + direction;
+        
+        // Choose appropriate up vector
+        glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+        if (std::abs(direction.y) > 0.99f)  // Near vertical
+        {
+            up = glm::vec3(1.0f, 0.0f, 0.0f);
+        }
+        
+        lightView = glm::lookAt(lightPos, target, up);
+    }
+    
+    return lightProjection * lightView;
+}
+
+bool RenderPipeline::IsDynamicCaster(const Entity& e, const Mesh& mesh, size_t entityIndex) const
+{
+    // Skinned and morphing meshes deform without their transform changing
+    return e.IsPlayer || e.IsEnemy || !e.BoneMatrices.empty() || !e.BoneDualQuats.empty() || !mesh.MorphTargets.empty() ||
+           m_culler.GetFramesSinceMoved(entityIndex) < DYNAMIC_CASTER_FRAMES;
 }
 
 void RenderPipeline::ShadowPass(EntityManager& entityManager)
 {
     auto& lightMgr = LightManager::Instance();
     auto& lights = lightMgr.GetAllLights();
+    const auto& entities = entityManager.GetAll();
+    const size_t count = std::min(entities.size(), m_culler.GetCount());
+    const auto& settings = GraphicsSettings::Instance();
+    lightMgr.SetShadowCaching(settings.ShadowCaching);
+    const bool caching = lightMgr.GetShadowAtlas().GetStaticFBO() != 0;
     
+    // 1. Decide what each tile needs. A tile is left alone when its matrix,
+    //    its static casters (by transform version) and its dynamic casters
+    //    are unchanged since it was drawn.
+    m_shadowTilePlans.clear();
+    for (size_t s = 0; s < m_shadowViews.size(); ++s)
+    {
+        const ShadowView& shadowView = m_shadowViews[s];
+        Light& light = lights[shadowView.LightIndex];
+        int viewIdx = shadowView.View;
+        int tileIdx = std::max(shadowView.Cascade, 0);
+        const ShadowTileCache& cache = light.ShadowCache[tileIdx];
+        const glm::mat4& matrix = shadowView.Cascade >= 0 ? light.CascadeMatrices[tileIdx] : light.LightSpaceMatrix;
+        
+        uint64_t staticHash = HashCombine(HASH_SEED, 0);
+        bool hasDynamic = false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Visibility first: most entities are outside most shadow views
+            if (!IsVisibleInView(i, viewIdx))
+            {
+                m_stats.ViewCulled[viewIdx]++;
+                continue;
+            }
+            const Mesh* mesh = m_culler.GetMesh(i);
+            if (!mesh || mesh->VAO == 0) continue;
+            m_stats.ViewRendered[viewIdx]++;
+            
+            if (IsDynamicCaster(entities[i], *mesh, i))
+            {
+                hasDynamic = true;
+                continue;
+            }
+            staticHash = HashCombine(staticHash, i);
+            staticHash = HashCombine(staticHash, m_culler.GetTransformVersion(i));
+            staticHash = HashCombine(staticHash, mesh->VAO);
+            staticHash = HashCombine(staticHash, GetEntityLOD(i));
+            if (const TerrainQuadtree* terrain = m_culler.GetTerrain(i))
+                staticHash = HashCombine(staticHash, terrain->GetSelectionVersion());
+        }
+        
+        bool contentValid = caching && cache.StaticValid && cache.Tile == light.ShadowTiles[tileIdx];
+        ShadowTilePlan plan;
+        plan.ShadowViewIndex = (int)s;
+        plan.StaticHash = staticHash;
+        plan.StaticDirty = !contentValid || cache.Matrix != matrix || cache.StaticHash != staticHash;
+        plan.HasDynamic = hasDynamic;
+        if (!plan.StaticDirty && !hasDynamic && !cache.HasDynamic)
+        {
+            m_stats.ShadowTilesCached++;
+            continue;
+        }
+        
+        // Distant lights and far cascades may show their previous content
+        // for a few frames while they wait for their turn
+        bool distant = shadowView.Cascade >= 2 ||
+                       (shadowView.Cascade < 0 && light.ShadowImportance < DISTANT_LIGHT_IMPORTANCE);
+        plan.Deferrable = contentValid && distant && m_frameIndex - cache.LastUpdateFrame < MAX_SHADOW_STALE_FRAMES;
+        plan.LastUpdateFrame = cache.LastUpdateFrame;
+        m_shadowTilePlans.push_back(plan);
+    }
+    
+    // 2. Round robin over the deferrable tiles: the longest-waiting ones use
+    //    this frame's budget, the rest keep their cached content
+    std::vector<ShadowTilePlan*> waiting;
+    for (auto& plan : m_shadowTilePlans)
+    {
+        if (plan.Deferrable)
+            waiting.push_back(&plan);
+    }
+    std::stable_sort(waiting.begin(), waiting.end(), [](const ShadowTilePlan* a, const ShadowTilePlan* b)
+    {
+        return a->LastUpdateFrame < b->LastUpdateFrame;
+    });
+    for (size_t w = 0; w < waiting.size(); ++w)
+    {
+        waiting[w]->Skip = (int)w >= std::max(settings.ShadowUpdateBudget, 0);
+        if (waiting[w]->Skip)
+            m_stats.ShadowTilesDeferred++;
+    }
+    
+    if (m_shadowTilePlans.size() == (size_t)m_stats.ShadowTilesDeferred)
+        return;
+    
+    // 3. Draw the tiles that need it
     m_shadowShader.Use();
     
     // Store current framebuffer to restore later
@@ -105,90 +488,105 @@ void RenderPipeline::ShadowPass(EntityManager& entityManager)
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
     
-    for (size_t lightIdx = 0; lightIdx < lights.size(); ++lightIdx)
+    // Every map is a tile of one atlas: bind it once, then only move the viewport
+    const ShadowAtlas& atlas = lightMgr.GetShadowAtlas();
+    glBindFramebuffer(GL_FRAMEBUFFER, atlas.GetFBO());
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
     {
-        auto& light = lights[lightIdx];
-        
-        if (!light.CastsShadows || !light.Enabled || light.ShadowMapFBO == 0)
-            continue;
-        
-        // Bind shadow map framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, light.ShadowMapFBO);
-        glViewport(0, 0, light.ShadowMapSize, light.ShadowMapSize);
-        glClear(GL_DEPTH_BUFFER_BIT);
-        
-        // Check framebuffer status
-        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-        if (status != GL_FRAMEBUFFER_COMPLETE)
-        {
-            std::cerr << "Shadow framebuffer incomplete for light: " << light.Name << std::endl;
-            continue;
-        }
-        
-        glm::mat4 lightProjection, lightView, lightSpaceMatrix;
-        
-        if (light.Type == LightType::Directional)
-        {
-            float size = light.ShadowOrthoSize;
-            lightProjection = glm::ortho(-size, size, -size, size, light.ShadowNearPlane, light.ShadowFarPlane);
-            
-            // Position light opposite to direction
-            glm::vec3 lightPos(-light.Direction.x * 10.0f, -light.Direction.y * 10.0f, -light.Direction.z * 10.0f);
-            glm::vec3 target = lightPos + glm::vec3(light.Direction.x, light.Direction.y, light.Direction.z);
-            lightView = glm::lookAt(lightPos, target, glm::vec3(0.0f, 1.0f, 0.0f));
-        }
-        else // Point or Spot light
+        std::cerr << "Shadow atlas framebuffer incomplete" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, currentFBO);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        return;
+    }
+    
+    // Scissor keeps clears and copies inside the tile
+    glEnable(GL_SCISSOR_TEST);
+    
+    // casters: 0 = all, 1 = static only, 2 = dynamic only
+    auto drawCasters = [&](int viewIdx, int casters)
+    {
+        for (size_t i = 0; i < count; ++i)
         {
-            // Normalize direction
-            glm::vec3 direction(light.Direction.x, light.Direction.y, light.Direction.z);
-            float dirLength = glm::length(direction);
-            if (dirLength > 0.001f)
-            {
-                direction = glm::normalize(direction);
-            }
-            else
-            {
-                direction = glm::vec3(0.0f, -1.0f, 0.0f); // Default downward
-            }
-            
-            float fov = (light.Type == LightType::Spot) ? light.OuterCutoff * 2.0f : light.ShadowFOV;
-            lightProjection = glm::perspective(glm::radians(fov), 1.0f, light.ShadowNearPlane, light.ShadowFarPlane);
+            if (!IsVisibleInView(i, viewIdx)) continue;
+            const auto& e = entities[i];
+            const Mesh* mesh = m_culler.GetMesh(i);
+            if (!mesh || mesh->VAO == 0) continue;
             
-            glm::vec3 lightPos(light.Position.x, light.Position.y, light.Position.z);
-            glm::vec3 target = lightPos + direction;
+            if (casters != 0 && IsDynamicCaster(e, *mesh, i) != (casters == 2))
+                continue;
             
-            // Choose appropriate up vector
-            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
-            if (std::abs(direction.y) > 0.99f)  // Near vertical
+            m_shadowShader.SetMat4("u_Model", m_culler.GetWorldMatrix(i));
+            if (const TerrainQuadtree* terrain = m_culler.GetTerrain(i))
             {
-                up = glm::vec3(1.0f, 0.0f, 0.0f);
+                int drawCalls = 0;
+                m_stats.ShadowTrianglesSubmitted += terrain->Draw(m_shadowShader, GetCullingFrustum(viewIdx), drawCalls);
+                continue;
             }
             
-            lightView = glm::lookAt(lightPos, target, up);
+            // Skinned casters read the vertices skinned for this frame
+            int lod = GetEntityLOD(i);
+            int skinnedOffset = m_skinningPass.GetOffset(i);
+            m_shadowShader.SetBool("u_HasSkeleton", skinnedOffset >= 0);
+            if (skinnedOffset >= 0)
+                m_shadowShader.SetInt("u_SkinnedVertexOffset", skinnedOffset);
+            mesh->DrawDepth(lod);
+            m_stats.ShadowTrianglesSubmitted += mesh->GetTriangleCount(lod);
         }
+    };
+    
+    for (const ShadowTilePlan& plan : m_shadowTilePlans)
+    {
+        if (plan.Skip)
+            continue;
+        
+        const ShadowView& shadowView = m_shadowViews[plan.ShadowViewIndex];
+        auto& light = lights[shadowView.LightIndex];
+        int tileIdx = std::max(shadowView.Cascade, 0);
+        const ShadowAtlasTile& tile = light.ShadowTiles[tileIdx];
+        ShadowTileCache& cache = light.ShadowCache[tileIdx];
+        const glm::mat4& matrix = shadowView.Cascade >= 0 ? light.CascadeMatrices[tileIdx] : light.LightSpaceMatrix;
         
-        lightSpaceMatrix = lightProjection * lightView;
-        m_shadowShader.SetMat4("u_LightSpaceMatrix", lightSpaceMatrix);
-        light.LightSpaceMatrix = lightSpaceMatrix;
+        glViewport(tile.X, tile.Y, tile.Size, tile.Size);
+        glScissor(tile.X, tile.Y, tile.Size, tile.Size);
+        m_shadowShader.SetMat4("u_LightSpaceMatrix", matrix);
         
-        // Render entities to shadow map
-        for (const auto& e : entityManager.GetAll())
+        if (!caching)
         {
-            Mesh* mesh = e.MeshHandle ? MeshManager::Instance().GetMesh(e.MeshHandle) : nullptr;
-            if (!mesh || mesh->VAO == 0) continue;
-            
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(e.Transform.Position.x, e.Transform.Position.y, e.Transform.Position.z));
-            model = glm::rotate(model, glm::radians(e.Transform.Rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-            model = glm::rotate(model, glm::radians(e.Transform.Rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-            model = glm::rotate(model, glm::radians(e.Transform.Rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-            model = glm::scale(model, glm::vec3(e.Transform.Scale.x, e.Transform.Scale.y, e.Transform.Scale.z));
+            glClear(GL_DEPTH_BUFFER_BIT);
+            drawCasters(shadowView.View, 0);
+            cache.StaticValid = false;
+        }
+        else
+        {
+            if (plan.StaticDirty)
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, atlas.GetStaticFBO());
+                glClear(GL_DEPTH_BUFFER_BIT);
+                drawCasters(shadowView.View, 1);
+                cache.StaticHash = plan.StaticHash;
+                cache.StaticValid = true;
+                m_stats.ShadowStaticRedraws++;
+            }
             
-            m_shadowShader.SetMat4("u_Model", model);
-            mesh->Draw();
+            // Static depth is copied, only dynamic casters are drawn again
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, atlas.GetStaticFBO());
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, atlas.GetFBO());
+            glBlitFramebuffer(tile.X, tile.Y, tile.X + tile.Size, tile.Y + tile.Size,
+                              tile.X, tile.Y, tile.X + tile.Size, tile.Y + tile.Size,
+                              GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            if (plan.HasDynamic)
+                drawCasters(shadowView.View, 2);
         }
+        
+        cache.Tile = tile;
+        cache.Matrix = matrix;
+        cache.HasDynamic = plan.HasDynamic;
+        cache.LastUpdateFrame = m_frameIndex;
+        m_stats.ShadowTilesRendered++;
     }
     
+    glDisable(GL_SCISSOR_TEST);
+    
     // CRITICAL: Restore default framebuffer
     glBindFramebuffer(GL_FRAMEBUFFER, currentFBO);
     
@@ -196,318 +594,490 @@ void RenderPipeline::ShadowPass(EntityManager& entityManager)
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 }
 
-void RenderPipeline::GeometryPass(EntityManager& entityManager, Camera& camera, const glm::mat4& viewProj)
+void RenderPipeline::GeometryPass(Camera& camera, const glm::mat4& viewProj)
 {
-    m_mainShader.Use();
-    m_mainShader.SetBool("u_IsUnlit", false);  // safety: clear any leftover overlay state
-    m_mainShader.SetVec3("u_CameraPos", camera.Position.x, camera.Position.y, camera.Position.z);
-    SetupLightUniforms(viewProj);
-    
-    for (const auto& e : entityManager.GetAll())
+    BeginMainShader(camera);
+    DrawEntities(m_mainShader, viewProj);
+}
+
+void RenderPipeline::SelectLODs(EntityManager& entityManager, const Camera& camera)
+{
+    size_t count = std::min(entityManager.Size(), m_culler.GetCount());
+    if (m_entityLOD.size() != count)
+        m_entityLOD.assign(count, 0);
+
+    const GraphicsSettings& settings = GraphicsSettings::Instance();
+    if (!settings.MeshLOD)
     {
-        Mesh* mesh = e.MeshHandle ? MeshManager::Instance().GetMesh(e.MeshHandle) : nullptr;
-        if (!mesh) continue;
-        
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(e.Transform.Position.x, e.Transform.Position.y, e.Transform.Position.z));
-        model = glm::rotate(model, glm::radians(e.Transform.Rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(e.Transform.Rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(e.Transform.Rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        model = glm::scale(model, glm::vec3(e.Transform.Scale.x, e.Transform.Scale.y, e.Transform.Scale.z));
-        
-        if (m_enableFrustumCulling && FrustumCullEntity(e, mesh, model, camera))
+        std::fill(m_entityLOD.begin(), m_entityLOD.end(), 0);
+        return;
+    }
+
+    glm::vec3 eye(camera.Position.x, camera.Position.y, camera.Position.z);
+    float tanHalfFov = std::tan(glm::radians(camera.FOV) * 0.5f);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Mesh* mesh = m_culler.GetMesh(i);
+        if (!mesh || mesh->LODs.empty() || m_culler.IsUnbounded(i))
         {
-            m_stats.EntitiesCulled++;
+            m_entityLOD[i] = 0;
             continue;
         }
-        
-        m_stats.EntitiesRendered++;
-        m_mainShader.SetMat4("u_MVP", viewProj);
-        m_mainShader.SetMat4("transform", model);
-
-        // Upload bone matrices for skinned entities
-        bool hasSkeleton = mesh->HasSkeleton && !e.BoneMatrices.empty();
-        m_mainShader.SetBool("u_HasSkeleton", hasSkeleton);
-        if (hasSkeleton)
+
+        // Bounding sphere diameter as a share of the screen height
+        glm::vec3 boundsMin = m_culler.GetBoundsMin(i);
+        glm::vec3 boundsMax = m_culler.GetBoundsMax(i);
+        float radius = 0.5f * glm::length(boundsMax - boundsMin);
+        float distance = glm::length((boundsMin + boundsMax) * 0.5f - eye);
+        float screenSize = distance > radius ? radius / (distance * tanHalfFov) : FLT_MAX;
+        screenSize *= settings.LODBias;
+
+        // Cross a level boundary only once past it by the hysteresis margin
+        int lod = std::min((int)m_entityLOD[i], (int)mesh->LODs.size());
+        while (lod < (int)mesh->LODs.size() && screenSize < mesh->LODs[lod].ScreenSize * (1.0f - LOD_HYSTERESIS))
+            ++lod;
+        while (lod > 0 && screenSize > mesh->LODs[lod - 1].ScreenSize * (1.0f + LOD_HYSTERESIS))
+            --lod;
+        m_entityLOD[i] = (uint8_t)lod;
+    }
+}
+
+void RenderPipeline::SelectTerrainChunks(EntityManager& entityManager, const Camera& camera)
+{
+    size_t count = std::min(entityManager.Size(), m_culler.GetCount());
+    const GraphicsSettings& settings = GraphicsSettings::Instance();
+    glm::vec3 eye(camera.Position.x, camera.Position.y, camera.Position.z);
+    for (size_t i = 0; i < count; ++i)
+    {
+        TerrainQuadtree* terrain = m_culler.GetTerrain(i);
+        if (!terrain)
+            continue;
+
+        terrain->Select(m_culler.GetWorldMatrix(i), eye, settings.LODBias, !settings.MeshLOD);
+        m_stats.TerrainChunks += terrain->GetSelectedCount();
+    }
+}
+
+void RenderPipeline::BuildSkinnedBatches(EntityManager& entityManager)
+{
+    const auto& entities = entityManager.GetAll();
+    size_t count = std::min(entities.size(), m_culler.GetCount());
+    m_skinnedBatchOf.assign(count, -1);
+    m_skinnedBatches.clear();
+    m_skinnedInstances.clear();
+
+    // Everything DrawEntities sets per entity besides the transform and palette
+    struct BatchKey
+    {
+        MeshHandle Handle;
+        int LOD;
+        uint64_t Diffuse, Normal, Specular;  // override texture + 1, 0 = mesh textures
+        float Shininess;
+        float Alpha;
+        size_t EntityIndex;
+
+        auto Tie() const { return std::tie(Handle, LOD, Diffuse, Normal, Specular, Shininess, Alpha); }
+    };
+    std::vector<BatchKey> keys;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (m_skinningPass.GetOffset(i) < 0 || !IsVisibleInView(i, 0))
+            continue;
+
+        const Entity& e = entities[i];
+        keys.push_back({ e.MeshHandle, GetEntityLOD(i),
+                         e.HasDiffuseTextureOverride ? e.DiffuseTexture.Get() + 1ull : 0ull,
+                         e.HasNormalTextureOverride ? e.NormalTexture.Get() + 1ull : 0ull,
+                         e.HasSpecularTextureOverride ? e.SpecularTexture.Get() + 1ull : 0ull,
+                         e.Shininess, e.Alpha, i });
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const BatchKey& a, const BatchKey& b)
+    {
+        return a.Tie() < b.Tie();
+    });
+
+    // Runs of equal keys become one batch, led by their first entity
+    for (size_t k = 0; k < keys.size(); ++k)
+    {
+        size_t entity = keys[k].EntityIndex;
+        if (k == 0 || keys[k].Tie() != keys[k - 1].Tie())
         {
-            int count = (int)e.BoneMatrices.size();
-            if (count > MAX_BONES) count = MAX_BONES;
-            m_mainShader.SetMat4Array("u_BoneMatrices[0]", e.BoneMatrices.data(), count);
+            m_skinnedBatchOf[entity] = (int)m_skinnedBatches.size();
+            m_skinnedBatches.push_back({ entity, (int)m_skinnedInstances.size(), 0 });
         }
+        else
+        {
+            m_skinnedBatchOf[entity] = SKINNED_BATCH_MEMBER;
+        }
+        m_skinnedBatches.back().Count++;
+        m_skinnedInstances.push_back({ m_culler.GetWorldMatrix(entity),
+                                       glm::ivec4(m_skinningPass.GetOffset(entity), 0, 0, 0) });
+    }
+    m_stats.SkinnedInstances = (int)m_skinnedInstances.size();
+    m_stats.SkinnedBatches = (int)m_skinnedBatches.size();
 
-        if (!mesh->SubMeshes.empty())
+    StreamBuffer::BindStorage(SKINNED_INSTANCE_BINDING,
+                              StreamBuffer::Instance().UploadStorage(m_skinnedInstanceBuffer, m_skinnedInstances.data(),
+                                                                     m_skinnedInstances.size() * sizeof(SkinnedInstance)));
+}
+
+int RenderPipeline::BeginSkinnedDraw(const Shader& shader, size_t entityIndex)
+{
+    int batch = entityIndex < m_skinnedBatchOf.size() ? m_skinnedBatchOf[entityIndex] : -1;
+    if (batch == SKINNED_BATCH_MEMBER)
+        return 0;
+
+    shader.SetBool("u_HasSkeleton", batch >= 0);
+    shader.SetBool("u_Instanced", batch >= 0);
+    if (batch < 0)
+        return 1;
+
+    shader.SetInt("u_FirstInstance", m_skinnedBatches[batch].FirstInstance);
+    return m_skinnedBatches[batch].Count;
+}
+
+void RenderPipeline::DepthPrepass(EntityManager& entityManager, const glm::mat4& viewProj)
+{
+    m_depthShader.Use();
+    m_depthShader.SetMat4("u_MVP", viewProj);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    
+    size_t count = std::min(entityManager.Size(), m_culler.GetCount());
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!IsVisibleInView(i, 0)) continue;
+        const Mesh* mesh = m_culler.GetMesh(i);
+        if (!mesh || mesh->VAO == 0) continue;
+        
+        m_depthShader.SetMat4("transform", m_culler.GetWorldMatrix(i));
+        
+        // Skinned meshes read their skinned positions by vertex index, so
+        // everything draws from the packed position stream
+        int lod = GetEntityLOD(i);
+        int instances = BeginSkinnedDraw(m_depthShader, i);
+        if (const TerrainQuadtree* terrain = m_culler.GetTerrain(i))
         {
-            glBindVertexArray(mesh->VAO);
-            for (const auto& sub : mesh->SubMeshes)
-            {
-                m_mainShader.SetVec3("u_DiffuseColor", sub.DiffuseColor.x, sub.DiffuseColor.y, sub.DiffuseColor.z);
-                
-                // Check for entity texture override first, then submesh texture
-                bool hasDiffuse = e.HasDiffuseTextureOverride || sub.HasDiffuseTexture;
-                m_mainShader.SetBool("u_HasDiffuseMap", hasDiffuse);
-                if (hasDiffuse)
-                {
-                    glActiveTexture(GL_TEXTURE0);
-                    // Use entity override if available, otherwise use submesh texture
-                    unsigned int texToUse = e.HasDiffuseTextureOverride ? e.DiffuseTexture : sub.DiffuseTexture;
-                    glBindTexture(GL_TEXTURE_2D, texToUse);
-                    m_mainShader.SetTexture("u_DiffuseMap", 0);
-                }
-                
-                // Check for normal map override
-                bool hasNormal = e.HasNormalTextureOverride || sub.HasNormalTexture;
-                m_mainShader.SetBool("u_HasNormalMap", hasNormal);
-                if (hasNormal)
-                {
-                    glActiveTexture(GL_TEXTURE2);
-                    unsigned int texToUse = e.HasNormalTextureOverride ? e.NormalTexture : sub.NormalTexture;
-                    glBindTexture(GL_TEXTURE_2D, texToUse);
-                    m_mainShader.SetTexture("u_NormalMap", 2);
-                }
-                
-                // Check for specular map override
-                bool hasSpecular = e.HasSpecularTextureOverride || sub.HasSpecularTexture;
-                m_mainShader.SetBool("u_HasSpecularMap", hasSpecular);
-                if (hasSpecular)
-                {
-                    glActiveTexture(GL_TEXTURE1);
-                    unsigned int texToUse = e.HasSpecularTextureOverride ? e.SpecularTexture : sub.SpecularTexture;
-                    glBindTexture(GL_TEXTURE_2D, texToUse);
-                    m_mainShader.SetTexture("u_SpecularMap", 1);
-                }
-                
-                m_mainShader.SetVec3("u_SpecularColor", sub.SpecularColor.x, sub.SpecularColor.y, sub.SpecularColor.z);
-                m_mainShader.SetFloat("u_Shininess", e.Shininess);
-                m_mainShader.SetFloat("u_Alpha", e.Alpha);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sub.EBO);
-                glDrawElements(GL_TRIANGLES, (GLsizei)sub.Indices.size(), GL_UNSIGNED_INT, 0);
-                m_stats.DrawCalls++;
-            }
+            m_stats.TrianglesSubmitted += terrain->Draw(m_depthShader, GetCullingFrustum(0), m_stats.DrawCalls);
+            continue;
         }
-        else
+        if (instances == 0)
+            continue;
+        mesh->DrawDepth(lod, instances);
+        m_stats.DrawCalls++;
+        m_stats.TrianglesSubmitted += mesh->GetTriangleCount(lod) * instances;
+    }
+    m_depthShader.SetBool("u_HasSkeleton", false);
+    m_depthShader.SetBool("u_Instanced", false);
+    
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void RenderPipeline::BeginMainShader(const Camera& camera)
+{
+    m_mainShader.Use();
+    m_mainShader.SetBool("u_IsUnlit", false);  // safety: clear any leftover overlay state
+    m_mainShader.SetVec3("u_CameraPos", camera.Position.x, camera.Position.y, camera.Position.z);
+    m_mainShader.SetMat4("u_View", camera.GetViewMatrix());  // view depth selects the shadow cascade
+    SetupLightUniforms();
+}
+
+void RenderPipeline::DeferredPass(Camera& camera, const glm::mat4& view, const glm::mat4& proj,
+                                  int displayWidth, int displayHeight)
+{
+    // Lighting resolves into whatever the caller rendered to
+    GLint targetFBO = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &targetFBO);
+
+    glm::mat4 viewProj = proj * view;
+    m_mainTimer.Begin();
+    if (m_gbufferPass.Begin(displayWidth, displayHeight))
+    {
+        const Shader& gbufferShader = m_gbufferPass.GetShader();
+        gbufferShader.Use();
+        gbufferShader.SetMat4("u_View", view);
+        DrawEntities(gbufferShader, viewProj);
+    }
+    m_mainTimer.End();
+    m_stats.MainPassTime = m_mainTimer.GetMilliseconds();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glViewport(0, 0, displayWidth, displayHeight);
+
+    m_lightTimer.Begin();
+    m_lightingPass.Execute(m_gbufferPass, m_lightBuffer, m_shadowTable,
+                           LightManager::Instance().GetShadowAtlas().GetTexture(), camera, view, proj);
+    m_lightTimer.End();
+    m_stats.LightPassTime = m_lightTimer.GetMilliseconds();
+    m_stats.TileLightRefs = m_lightingPass.GetTileLightRefs();
+
+    // Later forward draws (light indicators) still use the main shader
+    BeginMainShader(camera);
+}
+
+void RenderPipeline::BuildDrawList(EntityManager& entityManager)
+{
+    const auto& entities = entityManager.GetAll();
+    size_t count = std::min(entities.size(), m_culler.GetCount());
+    size_t bucketCount = (count + DRAW_LIST_BATCH - 1) / DRAW_LIST_BATCH;
+    if (m_drawBuckets.size() < bucketCount)
+        m_drawBuckets.resize(bucketCount);
+
+    // Each task owns the bucket of its batch, so concatenating the buckets in
+    // order gives the same list however the batches were scheduled
+    WorkerPool::Instance().ParallelFor(count, DRAW_LIST_BATCH, [&](size_t begin, size_t end) {
+        DrawBucket& bucket = m_drawBuckets[begin / DRAW_LIST_BATCH];
+        bucket.Items.clear();
+        bucket.Rendered = 0;
+        bucket.Culled = 0;
+        for (size_t i = begin; i < end; ++i)
         {
-            m_mainShader.SetVec3("u_DiffuseColor", mesh->DiffuseColor.x, mesh->DiffuseColor.y, mesh->DiffuseColor.z);
-            
-            // Check for entity texture overrides
-            bool hasDiffuse = e.HasDiffuseTextureOverride || mesh->HasDiffuseTexture;
-            m_mainShader.SetBool("u_HasDiffuseMap", hasDiffuse);
-            if (hasDiffuse)
-            {
-                glActiveTexture(GL_TEXTURE0);
-                unsigned int texToUse = e.HasDiffuseTextureOverride ? e.DiffuseTexture : mesh->DiffuseTexture;
-                glBindTexture(GL_TEXTURE_2D, texToUse);
-                m_mainShader.SetTexture("u_DiffuseMap", 0);
-            }
-            
-            bool hasNormal = e.HasNormalTextureOverride || mesh->HasNormalTexture;
-            m_mainShader.SetBool("u_HasNormalMap", hasNormal);
-            if (hasNormal)
+            const Entity& e = entities[i];
+            const Mesh* mesh = m_culler.GetMesh(i);
+            if (!mesh)
+                continue;
+            if (!IsVisibleInView(i, 0))
             {
-                glActiveTexture(GL_TEXTURE2);
-                unsigned int texToUse = e.HasNormalTextureOverride ? e.NormalTexture : mesh->NormalTexture;
-                glBindTexture(GL_TEXTURE_2D, texToUse);
-                m_mainShader.SetTexture("u_NormalMap", 2);
+                bucket.Culled++;
+                continue;
             }
-            
-            bool hasSpecular = e.HasSpecularTextureOverride || mesh->HasSpecularTexture;
-            m_mainShader.SetBool("u_HasSpecularMap", hasSpecular);
-            if (hasSpecular)
+            bucket.Rendered++;
+
+            // Skinned entities are drawn by the batch they belong to
+            if (i < m_skinnedBatchOf.size() && m_skinnedBatchOf[i] == SKINNED_BATCH_MEMBER)
+                continue;
+
+            DrawItem item;
+            item.EntityIndex = (uint32_t)i;
+            item.Source = mesh;
+            item.Terrain = m_culler.GetTerrain(i);
+            item.LOD = GetEntityLOD(i);
+            item.Shininess = e.Shininess;
+            item.Alpha = e.Alpha;
+
+            if (mesh->SubMeshes.empty())
             {
-                glActiveTexture(GL_TEXTURE1);
-                unsigned int texToUse = e.HasSpecularTextureOverride ? e.SpecularTexture : mesh->SpecularTexture;
-                glBindTexture(GL_TEXTURE_2D, texToUse);
-                m_mainShader.SetTexture("u_SpecularMap", 1);
+                if (!item.Terrain && mesh->VAO == 0)
+                    continue;
+                item.SubMesh = -1;
+                ResolveMaterial(item, e, mesh->DiffuseColor, mesh->SpecularColor, mesh->HasDiffuseTexture ? mesh->DiffuseTexture : 0,
+                                mesh->HasNormalTexture ? mesh->NormalTexture : 0, mesh->HasSpecularTexture ? mesh->SpecularTexture : 0);
+                bucket.Items.push_back(item);
+                continue;
             }
-            
-            m_mainShader.SetVec3("u_SpecularColor", mesh->SpecularColor.x, mesh->SpecularColor.y, mesh->SpecularColor.z);
-            m_mainShader.SetFloat("u_Shininess", e.Shininess);
-            m_mainShader.SetFloat("u_Alpha", e.Alpha);
-            if (mesh->VAO != 0)
+
+            for (size_t s = 0; s < mesh->SubMeshes.size(); ++s)
             {
-                mesh->Draw();
-                m_stats.DrawCalls++;
+                const SubMesh& sub = mesh->SubMeshes[s];
+                item.SubMesh = (int32_t)s;
+                ResolveMaterial(item, e, sub.DiffuseColor, sub.SpecularColor, sub.HasDiffuseTexture ? sub.DiffuseTexture : 0,
+                                sub.HasNormalTexture ? sub.NormalTexture : 0, sub.HasSpecularTexture ? sub.SpecularTexture : 0);
+                bucket.Items.push_back(item);
             }
         }
+    });
+
+    m_drawItems.clear();
+    int rendered = 0;
+    int culled = 0;
+    for (size_t b = 0; b < bucketCount; ++b)
+    {
+        const DrawBucket& bucket = m_drawBuckets[b];
+        m_drawItems.insert(m_drawItems.end(), bucket.Items.begin(), bucket.Items.end());
+        rendered += bucket.Rendered;
+        culled += bucket.Culled;
     }
+    m_stats.EntitiesRendered += rendered;
+    m_stats.EntitiesCulled += culled;
+    m_stats.ViewRendered[0] += rendered;
+    m_stats.ViewCulled[0] += culled;
+
+    // Group draws sharing vertex arrays and textures; the entity and submesh
+    // break ties so the order never depends on the threads
+    std::sort(m_drawItems.begin(), m_drawItems.end(), [](const DrawItem& a, const DrawItem& b)
+    {
+        return std::tie(a.Key, a.EntityIndex, a.SubMesh) < std::tie(b.Key, b.EntityIndex, b.SubMesh);
+    });
 }
 
-void RenderPipeline::SetupLightUniforms(const glm::mat4& viewProj)
+void RenderPipeline::ResolveMaterial(DrawItem& item, const Entity& e, const Vec3& diffuseColor, const Vec3& specularColor,
+                                     unsigned int diffuseMap, unsigned int normalMap, unsigned int specularMap)
 {
-    auto& lights = LightManager::Instance().GetAllLights();
-    int numLights = std::min((int)lights.size(), 8);
-    m_mainShader.SetInt("u_NumLights", numLights);
-    
-    for (int i = 0; i < numLights; ++i)
-    {
-        const auto& light = lights[i];
-        std::string base = "u_Lights[" + std::to_string(i) + "].";
-        m_mainShader.SetInt((base + "type").c_str(), (int)light.Type);
-        m_mainShader.SetVec3((base + "position").c_str(), light.Position.x, light.Position.y, light.Position.z);
-        m_mainShader.SetVec3((base + "direction").c_str(), light.Direction.x, light.Direction.y, light.Direction.z);
-        m_mainShader.SetVec3((base + "color").c_str(), light.Color.x, light.Color.y, light.Color.z);
-        m_mainShader.SetFloat((base + "intensity").c_str(), light.Intensity);
-        m_mainShader.SetFloat((base + "constant").c_str(), light.Constant);
-        m_mainShader.SetFloat((base + "linear").c_str(), light.Linear);
-        m_mainShader.SetFloat((base + "quadratic").c_str(), light.Quadratic);
-        m_mainShader.SetFloat((base + "innerCutoff").c_str(), std::cos(glm::radians(light.InnerCutoff)));
-        m_mainShader.SetFloat((base + "outerCutoff").c_str(), std::cos(glm::radians(light.OuterCutoff)));
-        m_mainShader.SetBool((base + "castsShadows").c_str(), light.CastsShadows && light.Enabled);
-        m_mainShader.SetFloat((base + "shadowBias").c_str(), light.ShadowBias);
-        m_mainShader.SetBool((base + "enabled").c_str(), light.Enabled);
-        m_mainShader.SetMat4(("u_LightSpaceMatrices[" + std::to_string(i) + "]").c_str(), light.LightSpaceMatrix);
-        if (light.CastsShadows && light.Enabled)
+    // Entity overrides win over the mesh's own textures
+    item.DiffuseMap = e.HasDiffuseTextureOverride ? e.DiffuseTexture.Get() : diffuseMap;
+    item.NormalMap = e.HasNormalTextureOverride ? e.NormalTexture.Get() : normalMap;
+    item.SpecularMap = e.HasSpecularTextureOverride ? e.SpecularTexture.Get() : specularMap;
+    item.DiffuseColor = glm::vec3(diffuseColor.x, diffuseColor.y, diffuseColor.z);
+    item.SpecularColor = glm::vec3(specularColor.x, specularColor.y, specularColor.z);
+
+    uint64_t vao = item.Terrain ? 0 : item.Source->VAO;
+    item.Key = ((vao & 0xFFFF) << 48) | ((uint64_t)(item.DiffuseMap & 0xFFFF) << 32)
+             | ((uint64_t)(item.NormalMap & 0xFFFF) << 16) | (uint64_t)(item.SpecularMap & 0xFFFF);
+}
+
+void RenderPipeline::DrawEntities(const Shader& shader, const glm::mat4& viewProj)
+{
+    shader.SetMat4("u_MVP", viewProj);
+    shader.SetTexture("u_DiffuseMap", 0);
+    shader.SetTexture("u_SpecularMap", 1);
+    shader.SetTexture("u_NormalMap", 2);
+
+    // Only touch state that differs from the previous draw
+    size_t lastEntity = SIZE_MAX;
+    int instances = 1;
+    unsigned int lastVAO = 0;
+    unsigned int bound[3] = { ~0u, ~0u, ~0u };  // units 0-2: diffuse, specular, normal
+    auto bindMap = [&bound](int unit, unsigned int texture)
+    {
+        if (texture == 0 || bound[unit] == texture)
+            return;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        bound[unit] = texture;
+    };
+
+    for (const DrawItem& item : m_drawItems)
+    {
+        if (item.EntityIndex != lastEntity)
         {
-            glActiveTexture(GL_TEXTURE3 + i);
-            glBindTexture(GL_TEXTURE_2D, light.ShadowMapTexture);
-            m_mainShader.SetInt((base + "shadowMap").c_str(), 3 + i);
+            lastEntity = item.EntityIndex;
+            instances = BeginSkinnedDraw(shader, item.EntityIndex);
+            shader.SetMat4("transform", m_culler.GetWorldMatrix(item.EntityIndex));
+        }
+
+        shader.SetVec3("u_DiffuseColor", item.DiffuseColor.x, item.DiffuseColor.y, item.DiffuseColor.z);
+        shader.SetVec3("u_SpecularColor", item.SpecularColor.x, item.SpecularColor.y, item.SpecularColor.z);
+        shader.SetBool("u_HasDiffuseMap", item.DiffuseMap != 0);
+        shader.SetBool("u_HasSpecularMap", item.SpecularMap != 0);
+        shader.SetBool("u_HasNormalMap", item.NormalMap != 0);
+        bindMap(0, item.DiffuseMap);
+        bindMap(1, item.SpecularMap);
+        bindMap(2, item.NormalMap);
+        shader.SetFloat("u_Shininess", item.Shininess);
+        shader.SetFloat("u_Alpha", item.Alpha);
+
+        if (item.Terrain)
+        {
+            m_stats.TrianglesSubmitted += item.Terrain->Draw(shader, GetCullingFrustum(0), m_stats.DrawCalls);
+            lastVAO = 0;  // Terrain binds its own patch grid
+            continue;
         }
+
+        const Mesh* mesh = item.Source;
+        if (item.SubMesh < 0)
+        {
+            mesh->Draw(item.LOD, instances);
+            lastVAO = mesh->VAO;
+            m_stats.DrawCalls++;
+            m_stats.TrianglesSubmitted += mesh->GetTriangleCount(item.LOD) * instances;
+            continue;
+        }
+
+        if (mesh->VAO != lastVAO)
+        {
+            glBindVertexArray(mesh->VAO);
+            lastVAO = mesh->VAO;
+        }
+        if (item.SubMesh == 0)
+            m_stats.TrianglesSubmitted += mesh->GetTriangleCount(item.LOD) * instances;
+        mesh->DrawSubMesh((size_t)item.SubMesh, item.LOD, instances);
+        m_stats.DrawCalls++;
     }
+    shader.SetBool("u_HasSkeleton", false);
+    shader.SetBool("u_Instanced", false);
 }
 
-bool RenderPipeline::FrustumCullEntity(const Entity& entity, Mesh* mesh, const glm::mat4& model, Camera& camera)
+void RenderPipeline::SetupLightUniforms()
 {
-    bool validBounds = (mesh->BoundsMin.x != FLT_MAX) && (mesh->BoundsMax.x != -FLT_MAX);
-    if (!validBounds) return false;
+    // Light data and per-cluster lists live in storage buffers
+    m_lightBuffer.Bind();
+    m_forwardPass.Bind(m_mainShader);
     
-    glm::vec4 worldMin = model * glm::vec4(mesh->BoundsMin.x, mesh->BoundsMin.y, mesh->BoundsMin.z, 1.0f);
-    glm::vec4 worldMax = model * glm::vec4(mesh->BoundsMax.x, mesh->BoundsMax.y, mesh->BoundsMax.z, 1.0f);
-    return !camera.IsBoxInFrustum(Vec3{worldMin.x, worldMin.y, worldMin.z}, Vec3{worldMax.x, worldMax.y, worldMax.z});
+    // All shadow maps live in one atlas; each light points at its tiles
+    m_shadowTable.Upload(m_mainShader, LightManager::Instance().GetShadowAtlas().GetTexture(), SHADOW_ATLAS_TEXTURE_UNIT);
 }
 
-void RenderPipeline::RenderLightIndicators(const glm::mat4& viewProj)
+void RenderPipeline::BuildShadowTileTable()
 {
-    auto& lights = LightManager::Instance().GetAllLights();
-    if (lights.empty()) return;
-    
-    static MeshHandle lightCubeMesh = 0;
-    if (lightCubeMesh == 0) lightCubeMesh = MeshManager::Instance().GetSharedCubeHandle();
+    auto& lightMgr = LightManager::Instance();
+    const auto& lights = lightMgr.GetAllLights();
+    const ShadowAtlas& atlas = lightMgr.GetShadowAtlas();
     
-    Mesh* cubeMesh = MeshManager::Instance().GetMesh(lightCubeMesh);
-    if (!cubeMesh) return;
+    m_shadowTable.LightFirstTile.assign(lights.size(), -1);
+    m_shadowTable.LightCascadeCount.assign(lights.size(), 0);
+    m_shadowTable.Count = std::min((int)m_shadowViews.size(), ShadowTileTable::MAX_TILES);
     
-    for (const auto& light : lights)
+    // Only tiles ShadowPass rendered this frame are sampled. Shadow views are
+    // ordered by light with cascades adjacent, so a light's tiles occupy
+    // consecutive slots starting at its first view.
+    for (int slot = 0; slot < m_shadowTable.Count; ++slot)
     {
-        if (light.Type == LightType::Directional) continue;
-        
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(light.Position.x, light.Position.y, light.Position.z));
-        model = glm::scale(model, glm::vec3(0.2f, 0.2f, 0.2f));
+        const ShadowView& shadowView = m_shadowViews[slot];
+        const auto& light = lights[shadowView.LightIndex];
+        int tileIdx = std::max(shadowView.Cascade, 0);
         
-        m_mainShader.SetMat4("u_MVP", viewProj);
-        m_mainShader.SetMat4("transform", model);
-        m_mainShader.SetVec3("u_DiffuseColor", light.Color.x, light.Color.y, light.Color.z);
-        m_mainShader.SetBool("u_HasDiffuseMap", false);
-        m_mainShader.SetBool("u_HasSpecularMap", false);
-        m_mainShader.SetBool("u_HasNormalMap", false);
-        m_mainShader.SetFloat("u_Alpha", light.Enabled ? 1.0f : 0.3f);
+        // The matrix the tile was last drawn with; cached and deferred tiles lag behind the light
+        m_shadowTable.Matrices[slot] = light.ShadowCache[tileIdx].Matrix;
+        m_shadowTable.Rects[slot] = atlas.GetUVRect(light.ShadowTiles[tileIdx]);
         
-        if (cubeMesh->VAO != 0) cubeMesh->Draw();
+        if (tileIdx == 0)
+        {
+            m_shadowTable.LightFirstTile[shadowView.LightIndex] = slot;
+            m_shadowTable.LightCascadeCount[shadowView.LightIndex] =
+                shadowView.Cascade >= 0 ? std::min(light.ShadowTileCount, m_shadowTable.Count - slot) : 0;
+        }
     }
 }
 
-void RenderPipeline::InitLineRenderer()
+void RenderPipeline::QueueLightIndicators()
 {
-    glGenVertexArrays(1, &m_lineVAO);
-    glGenBuffers(1, &m_lineVBO);
-
-    glBindVertexArray(m_lineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_lineVBO);
-    glBufferData(GL_ARRAY_BUFFER, MAX_LINE_VERTS * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
-
-    // Only position attribute (location 0); normals/UVs/tangents default to 0, which is fine
-    // for unlit rendering.
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+    DebugDraw& debug = DebugDraw::Instance();
+    for (const auto& light : LightManager::Instance().GetAllLights())
+    {
+        if (light.Type == LightType::Directional) continue;
 
-    glBindVertexArray(0);
+        glm::vec3 position(light.Position.x, light.Position.y, light.Position.z);
+        glm::vec3 color(light.Color.x, light.Color.y, light.Color.z);
+        if (light.Enabled)
+            debug.SolidBox(position, glm::vec3(0.1f), color);
+        else
+            debug.Box(position - glm::vec3(0.1f), position + glm::vec3(0.1f), color);
+    }
 }
 
-void RenderPipeline::DrawLines(const std::vector<glm::vec3>& linePoints,
-                               const glm::mat4& viewProj, float r, float g, float b)
+void RenderPipeline::QueueEntityBounds()
 {
-    if (linePoints.empty() || m_lineVAO == 0) return;
-
-    const size_t count = std::min(linePoints.size(), static_cast<size_t>(MAX_LINE_VERTS));
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_lineVBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0,
-                    static_cast<GLsizeiptr>(count * sizeof(glm::vec3)), linePoints.data());
-
-    m_mainShader.SetMat4("u_MVP", viewProj);
-    m_mainShader.SetMat4("transform", glm::mat4(1.0f));
-    m_mainShader.SetVec3("u_DiffuseColor", r, g, b);
-
-    glLineWidth(2.0f);
-    glBindVertexArray(m_lineVAO);
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(count));
-    glBindVertexArray(0);
-    glLineWidth(1.0f);
+    // Camera view: visible green, culled (frustum or occlusion) red
+    DebugDraw& debug = DebugDraw::Instance();
+    for (size_t i = 0; i < m_culler.GetCount(); ++i)
+    {
+        bool visible = m_viewCount == 0 || IsVisibleInView(i, 0);
+        debug.Box(m_culler.GetBoundsMin(i), m_culler.GetBoundsMax(i),
+                  visible ? glm::vec3(0.1f, 1.0f, 0.1f) : glm::vec3(1.0f, 0.1f, 0.1f));
+    }
 }
 
-void RenderPipeline::RenderWaypointOverlay(EntityManager& entityManager,
-                                           Camera& camera, int displayWidth, int displayHeight)
+void RenderPipeline::QueueWaypointOverlay(const EntityManager& entityManager)
 {
-    camera.Aspect = static_cast<float>(displayWidth) / static_cast<float>(displayHeight);
-    const glm::mat4 viewProj = camera.GetProjectionMatrix() * camera.GetViewMatrix();
-
-    static MeshHandle s_cubeMesh = 0;
-    if (s_cubeMesh == 0)
-        s_cubeMesh = MeshManager::Instance().GetSharedCubeHandle();
-    Mesh* cube = MeshManager::Instance().GetMesh(s_cubeMesh);
-    if (!cube || cube->VAO == 0) return;
-
-    m_mainShader.Use();
-    m_mainShader.SetBool("u_IsUnlit", true);
-    m_mainShader.SetBool("u_HasDiffuseMap", false);
-    m_mainShader.SetBool("u_HasSpecularMap", false);
-    m_mainShader.SetBool("u_HasNormalMap", false);
-    m_mainShader.SetFloat("u_Alpha", 1.0f);
-    m_mainShader.SetMat4("u_MVP", viewProj);
-
+    DebugDraw& debug = DebugDraw::Instance();
     for (const auto& entity : entityManager.GetAll())
     {
         if (!entity.IsEnemy || entity.PatrolWaypoints.empty())
             continue;
 
         const size_t count = entity.PatrolWaypoints.size();
-
-        // --- Waypoint nodes ---
         for (size_t w = 0; w < count; ++w)
         {
             const Vec3& wp = entity.PatrolWaypoints[w];
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(wp.x, wp.y, wp.z));
-            model = glm::scale(model, glm::vec3(0.3f));
-            m_mainShader.SetMat4("transform", model);
+            const Vec3& next = entity.PatrolWaypoints[(w + 1) % count];
+            glm::vec3 position(wp.x, wp.y, wp.z);
 
             // First waypoint (start) is green, rest are orange
-            if (w == 0)
-                m_mainShader.SetVec3("u_DiffuseColor", 0.1f, 1.0f, 0.1f);
-            else
-                m_mainShader.SetVec3("u_DiffuseColor", 1.0f, 0.5f, 0.0f);
-
-            cube->Draw();
-        }
-
-        // --- Connecting lines ---
-        std::vector<glm::vec3> lineVerts;
-        lineVerts.reserve(count * 2);
-
-        for (size_t w = 0; w + 1 < count; ++w)
-        {
-            lineVerts.emplace_back(entity.PatrolWaypoints[w].x,   entity.PatrolWaypoints[w].y,   entity.PatrolWaypoints[w].z);
-            lineVerts.emplace_back(entity.PatrolWaypoints[w+1].x, entity.PatrolWaypoints[w+1].y, entity.PatrolWaypoints[w+1].z);
-        }
+            debug.SolidBox(position, glm::vec3(0.15f), w == 0 ? glm::vec3(0.1f, 1.0f, 0.1f) : glm::vec3(1.0f, 0.5f, 0.0f));
 
-        // Loop mode: also connect last waypoint back to first
-        if (entity.EnemyPatrolMode == PatrolMode::Loop && count > 1)
-        {
-            lineVerts.emplace_back(entity.PatrolWaypoints[count - 1].x, entity.PatrolWaypoints[count - 1].y, entity.PatrolWaypoints[count - 1].z);
-            lineVerts.emplace_back(entity.PatrolWaypoints[0].x,         entity.PatrolWaypoints[0].y,         entity.PatrolWaypoints[0].z);
+            // Connecting lines; loop mode also connects the last waypoint back to the first
+            bool closing = w + 1 == count;
+            if (count > 1 && (!closing || entity.EnemyPatrolMode == PatrolMode::Loop))
+                debug.Line(position, glm::vec3(next.x, next.y, next.z), glm::vec3(1.0f));
         }
-
-        if (!lineVerts.empty())
-            DrawLines(lineVerts, viewProj, 1.0f, 1.0f, 1.0f);  // white
     }
-
-    m_mainShader.SetBool("u_IsUnlit", false);
 }
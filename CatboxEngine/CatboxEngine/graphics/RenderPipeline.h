@@ -4,6 +4,16 @@
 #include "../resources/EntityManager.h"
 #include "../resources/Camera.h"
 #include "LightManager.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "../resources/SceneBVH.h"
+#include "LightBuffer.h"
+#include "BonePalette.h"
+#include "GpuTimer.h"
+#include "passes/ForwardPass.h"
+#include "passes/GBufferPass.h"
+#include "passes/LightingPass.h"
+#include "passes/SkinningPass.h"
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -12,19 +22,100 @@ struct RenderStats
 {
     int EntitiesRendered = 0;
     int EntitiesCulled = 0;
+
+    // Per-view culling results: view 0 = camera, 1.. = shadow maps / cascades
+    int ViewCount = 0;
+    int ViewRendered[MultiViewVisibility::MAX_VIEWS] = {};
+    int ViewCulled[MultiViewVisibility::MAX_VIEWS] = {};
+
     int DrawCalls = 0;
+
+    // Triangles sent to the GPU after LOD selection: camera passes (pre-pass,
+    // main / G-buffer) and shadow maps
+    int TrianglesSubmitted = 0;
+    int ShadowTrianglesSubmitted = 0;
+
+    // Terrain chunks selected across all terrains
+    int TerrainChunks = 0;
+
+    // Vertices skinned by the compute pre-pass and the size of their bone
+    // palettes; skinned entities drawn by the camera passes, and the
+    // instanced batches they were grouped into
+    int SkinnedVertices = 0;
+    int BonePaletteBytes = 0;
+    int SkinnedInstances = 0;
+    int SkinnedBatches = 0;
+
+    // Per-frame data written to the stream buffer by the pipeline
+    int StreamedBytes = 0;
+
+    // Lines and shapes drawn by DebugDraw
+    int DebugPrimitives = 0;
+
+    // Software occlusion culling (camera view only)
+    int Occluders = 0;
+    int OccluderTriangles = 0;
+    int OcclusionCulled = 0;
+
+    // Shadow caching: tiles redrawn / reused as-is / postponed by the update budget
+    int ShadowTilesRendered = 0;
+    int ShadowTilesCached = 0;
+    int ShadowTilesDeferred = 0;
+    int ShadowStaticRedraws = 0;  // Tiles whose static casters had to be redrawn
+
+    // Lights in the light buffer; light references summed over the forward
+    // clusters and (deferred path only) the lighting pass's screen tiles
+    int LightCount = 0;
+    int ClusterLightRefs = 0;
+    int TileLightRefs = 0;
+
+    // GPU milliseconds from timer queries (a few frames behind).
+    // MainPassTime is the forward pass or the G-buffer pass, LightPassTime the
+    // deferred lighting pass.
     float ShadowPassTime = 0.0f;
     float MainPassTime = 0.0f;
     float LightPassTime = 0.0f;
+    float DepthPrepassTime = 0.0f;
+
+    // Last forward opaque cost (pre-pass + main pass) measured with the
+    // depth pre-pass off and on, kept across frames for comparison
+    float OpaqueTimeWithoutPrepass = 0.0f;
+    float OpaqueTimeWithPrepass = 0.0f;
     
     void Reset()
     {
         EntitiesRendered = 0;
         EntitiesCulled = 0;
+        ViewCount = 0;
+        for (int v = 0; v < MultiViewVisibility::MAX_VIEWS; ++v)
+        {
+            ViewRendered[v] = 0;
+            ViewCulled[v] = 0;
+        }
         DrawCalls = 0;
+        TrianglesSubmitted = 0;
+        ShadowTrianglesSubmitted = 0;
+        TerrainChunks = 0;
+        SkinnedVertices = 0;
+        BonePaletteBytes = 0;
+        SkinnedInstances = 0;
+        SkinnedBatches = 0;
+        StreamedBytes = 0;
+        DebugPrimitives = 0;
+        Occluders = 0;
+        OccluderTriangles = 0;
+        OcclusionCulled = 0;
+        ShadowTilesRendered = 0;
+        ShadowTilesCached = 0;
+        ShadowTilesDeferred = 0;
+        ShadowStaticRedraws = 0;
+        LightCount = 0;
+        ClusterLightRefs = 0;
+        TileLightRefs = 0;
         ShadowPassTime = 0.0f;
         MainPassTime = 0.0f;
         LightPassTime = 0.0f;
+        DepthPrepassTime = 0.0f;
     }
 };
 
@@ -43,22 +134,28 @@ public:
     
     // Individual render passes
     void ShadowPass(EntityManager& entityManager);
-    void GeometryPass(EntityManager& entityManager, Camera& camera, const glm::mat4& viewProj);
+    void GeometryPass(Camera& camera, const glm::mat4& viewProj);
+    void DepthPrepass(EntityManager& entityManager, const glm::mat4& viewProj);
+    void DeferredPass(Camera& camera, const glm::mat4& view, const glm::mat4& proj,
+                      int displayWidth, int displayHeight);
     
-    // Debug rendering
-    void RenderLightIndicators(const glm::mat4& viewProj);
+    // Debug rendering (queued into DebugDraw, drawn at the end of Render)
+    void QueueLightIndicators();
+    void QueueEntityBounds();
 
-    // Editor-only overlay: patrol waypoint nodes and connecting lines
-    // Call this only when NOT in play mode.
-    void RenderWaypointOverlay(EntityManager& entityManager, Camera& camera, int displayWidth, int displayHeight);
+    // Editor-only overlay: patrol waypoint nodes and connecting lines.
+    // Queue before Render, and only when NOT in play mode.
+    void QueueWaypointOverlay(const EntityManager& entityManager);
     
     // Settings
     void SetEnableShadows(bool enable) { m_enableShadows = enable; }
     void SetEnableFrustumCulling(bool enable) { m_enableFrustumCulling = enable; }
+    void SetEnableBVHCulling(bool enable) { m_enableBVHCulling = enable; }
     void SetEnableLightIndicators(bool enable) { m_enableLightIndicators = enable; }
 
     bool GetEnableShadows() const { return m_enableShadows; }
     bool GetEnableFrustumCulling() const { return m_enableFrustumCulling; }
+    bool GetEnableBVHCulling() const { return m_enableBVHCulling; }
     bool GetEnableLightIndicators() const { return m_enableLightIndicators; }
 
     // Skybox access (colours / mode are edited via GraphicsSettings)
@@ -71,6 +168,16 @@ private:
     // Shaders
     Shader m_mainShader;
     Shader m_shadowShader;
+    Shader m_depthShader;
+
+    // Every enabled light, shared by both paths; forward clusters index into it
+    LightBuffer m_lightBuffer;
+    ForwardPass m_forwardPass;
+
+    // Deferred path (GraphicsSettings::Path)
+    GBufferPass m_gbufferPass;
+    LightingPass m_lightingPass;
+    bool m_deferredReady = false;
 
     // Skybox
     Skybox m_skybox;
@@ -78,19 +185,166 @@ private:
     // Settings
     bool m_enableShadows = true;
     bool m_enableFrustumCulling = true;
+    bool m_enableBVHCulling = true;  // false = flat SIMD sweep over every entity
     bool m_enableLightIndicators = true;
     
     // Stats
     RenderStats m_stats;
+    GpuTimer m_shadowTimer;
+    GpuTimer m_prepassTimer;
+    GpuTimer m_mainTimer;
+    GpuTimer m_lightTimer;
+    float m_opaqueTimeWithoutPrepass = 0.0f;
+    float m_opaqueTimeWithPrepass = 0.0f;
+
+    // Culling: world bounds gathered once per frame, camera visibility bits
+    FrustumCuller m_culler;
+    SceneBVH m_bvh;
+    OcclusionCuller m_occlusionCuller;
+    MultiViewVisibility m_visibility;
+    Frustum m_viewFrusta[MultiViewVisibility::MAX_VIEWS];
+    int m_viewCount = 0;
+
+    // Shadow maps rendered this frame, one per light or per cascade
+    struct ShadowView
+    {
+        int LightIndex;
+        int Cascade;  // index into Light::ShadowTiles / CascadeMatrices, -1 = single map
+        int View;     // index into m_viewFrusta / m_visibility
+    };
+    std::vector<ShadowView> m_shadowViews;
+
+    // Tiles the shading passes sample this frame, rebuilt after ShadowPass
+    ShadowTileTable m_shadowTable;
+    void BuildShadowTileTable();
+
+    // Shadow caching (see ShadowPass): per-tile work decided before drawing
+    struct ShadowTilePlan
+    {
+        int ShadowViewIndex = 0;
+        uint64_t StaticHash = 0;
+        uint64_t LastUpdateFrame = 0;
+        bool StaticDirty = false;   // Static casters must be redrawn into the static copy
+        bool HasDynamic = false;    // Dynamic casters to draw over the static depth
+        bool Deferrable = false;    // Distant; may wait for the update budget
+        bool Skip = false;          // Deferred this frame
+    };
+    std::vector<ShadowTilePlan> m_shadowTilePlans;
+    uint64_t m_frameIndex = 0;
+
+    // Entities that moved within this many frames are drawn as dynamic casters
+    static constexpr uint64_t DYNAMIC_CASTER_FRAMES = 30;
+    // Lights rated below this (LightManager importance) count as distant
+    static constexpr float DISTANT_LIGHT_IMPORTANCE = 0.5f;
+    // Deferred tiles are forced to update after this many frames
+    static constexpr uint64_t MAX_SHADOW_STALE_FRAMES = 8;
 
-    // Line renderer for debug overlays
-    unsigned int m_lineVAO = 0;
-    unsigned int m_lineVBO = 0;
-    static constexpr int MAX_LINE_VERTS = 2048;
-    void InitLineRenderer();
-    void DrawLines(const std::vector<glm::vec3>& linePoints, const glm::mat4& viewProj, float r, float g, float b);
+    bool IsDynamicCaster(const Entity& e, const Mesh& mesh, size_t entityIndex) const;
+
+    // Only the first lights get shadow maps (shadow views and tile slots are finite)
+    static constexpr int MAX_SHADOWED_LIGHTS = 8;
+
+    // Camera frustum plus one per shadow map; refreshes Light::LightSpaceMatrix
+    // and the cascade matrices/splits of directional lights
+    void BuildViews(const Camera& camera, const glm::mat4& cameraView, const glm::mat4& cameraViewProj);
+    static glm::mat4 ComputeLightSpaceMatrix(const Light& light);
+    static void ComputeCascades(Light& light, const Camera& camera, const glm::mat4& cameraView, int tileSize);
+    bool IsVisibleInView(size_t entityIndex, int view) const
+    {
+        return !m_enableFrustumCulling || m_visibility.Test(entityIndex, view);
+    }
+
+    // Level of detail per entity, chosen once per frame from the camera and
+    // shared by every pass; kept between frames for hysteresis
+    std::vector<uint8_t> m_entityLOD;
+    void SelectLODs(EntityManager& entityManager, const Camera& camera);
+    int GetEntityLOD(size_t entityIndex) const
+    {
+        return entityIndex < m_entityLOD.size() ? m_entityLOD[entityIndex] : 0;
+    }
+    // A level boundary must be crossed by this share before switching
+    static constexpr float LOD_HYSTERESIS = 0.15f;
+
+    // Bone matrices of every skinned entity, one storage buffer per frame,
+    // skinned once into vertices that every pass shares
+    BonePalette m_bonePalette;
+    SkinningPass m_skinningPass;
+
+    // Camera-visible skinned entities sharing mesh, level and material are
+    // drawn as one instanced batch; per instance the shaders read the world
+    // matrix and skinned vertices from shader storage (std430, SkinnedInstances)
+    struct SkinnedInstance
+    {
+        glm::mat4 Model;
+        glm::ivec4 Params;  // x = first skinned vertex (SkinningPass)
+    };
+    struct SkinnedBatch
+    {
+        size_t Leader;       // Entity whose material the batch is drawn with
+        int FirstInstance;
+        int Count;
+    };
+    std::vector<SkinnedInstance> m_skinnedInstances;
+    std::vector<SkinnedBatch> m_skinnedBatches;
+    std::vector<int> m_skinnedBatchOf;  // per entity: batch it leads, -1 = none, SKINNED_BATCH_MEMBER = drawn by another
+    unsigned int m_skinnedInstanceBuffer = 0;
+    static constexpr int SKINNED_BATCH_MEMBER = -2;
+    // Must match SkinnedInstances in VertexShader.vert and DepthPrepass.vert
+    static constexpr unsigned int SKINNED_INSTANCE_BINDING = 6;
+    void BuildSkinnedBatches(EntityManager& entityManager);
+
+    // Sets the skinning uniforms for entity i and returns the instance count
+    // to draw it with (0 = drawn by another entity's batch)
+    int BeginSkinnedDraw(const Shader& shader, size_t entityIndex);
+
+    // Terrain chunks follow the camera too (Entity::TerrainChunks)
+    void SelectTerrainChunks(EntityManager& entityManager, const Camera& camera);
+    const Frustum* GetCullingFrustum(int view) const
+    {
+        return m_enableFrustumCulling ? &m_viewFrusta[view] : nullptr;
+    }
 
     // Helper functions
-    void SetupLightUniforms(const glm::mat4& viewProj);
-    bool FrustumCullEntity(const class Entity& entity, class Mesh* mesh, const glm::mat4& model, Camera& camera);
+    void SetupLightUniforms();
+    void BeginMainShader(const Camera& camera);
+
+    // Camera draw list: one item per visible mesh or submesh with its
+    // material resolved (entity overrides applied), built once per frame in
+    // parallel and shared by the forward and G-buffer passes
+    struct DrawItem
+    {
+        uint64_t Key = 0;           // Vertex array, then textures: equal state sorts together
+        uint32_t EntityIndex = 0;
+        int32_t SubMesh = -1;       // -1 = whole mesh
+        const Mesh* Source = nullptr;
+        const TerrainQuadtree* Terrain = nullptr;  // Drawn as chunks instead of Source
+        int LOD = 0;
+        unsigned int DiffuseMap = 0;   // 0 = none
+        unsigned int NormalMap = 0;
+        unsigned int SpecularMap = 0;
+        glm::vec3 DiffuseColor{ 0.0f };
+        glm::vec3 SpecularColor{ 0.0f };
+        float Shininess = 0.0f;
+        float Alpha = 1.0f;
+    };
+    // Written by one worker task each (one per DRAW_LIST_BATCH entities)
+    struct DrawBucket
+    {
+        std::vector<DrawItem> Items;
+        int Rendered = 0;
+        int Culled = 0;
+    };
+    std::vector<DrawItem> m_drawItems;
+    std::vector<DrawBucket> m_drawBuckets;
+    static constexpr size_t DRAW_LIST_BATCH = 256;
+    void BuildDrawList(EntityManager& entityManager);
+    static void ResolveMaterial(DrawItem& item, const Entity& e, const Vec3& diffuseColor, const Vec3& specularColor,
+                                unsigned int diffuseMap, unsigned int normalMap, unsigned int specularMap);
+
+    // Submits the draw list with shader (main shader or G-buffer shader; both
+    // read the same uniforms). Must run on the GL thread.
+    void DrawEntities(const Shader& shader, const glm::mat4& viewProj);
+
+    // Texture unit of u_ShadowAtlas in FragmentShader.frag
+    static constexpr int SHADOW_ATLAS_TEXTURE_UNIT = 3;
 };
@@ -8,7 +8,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-std::string Shader::LoadShaderSource(const char* path)
+std::string Shader::LoadShaderSource(const char* path, int depth)
 {
     std::ifstream shaderFile(path);
 
@@ -18,8 +18,32 @@ std::string Shader::LoadShaderSource(const char* path)
         return "";
     }
 
+    // #include "file" lines are replaced by the file, looked up next to the
+    // includer; #line keeps compile errors pointing at the includer's lines
+    const std::string directory(path, std::string(path).find_last_of("/\\") + 1);
     std::stringstream shaderStream;
-    shaderStream << shaderFile.rdbuf();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(shaderFile, line))
+    {
+        ++lineNumber;
+        const size_t open = line.find('"');
+        const size_t close = line.rfind('"');
+        if (line.rfind("#include", 0) != 0 || open == std::string::npos || close <= open)
+        {
+            shaderStream << line << '\n';
+            continue;
+        }
+
+        if (depth >= MAX_INCLUDE_DEPTH)
+        {
+            std::cerr << "Shader includes nested too deep: " << path << '\n';
+            continue;
+        }
+        const std::string includePath = directory + line.substr(open + 1, close - open - 1);
+        shaderStream << LoadShaderSource(includePath.c_str(), depth + 1);
+        shaderStream << "#line " << lineNumber + 1 << '\n';
+    }
     shaderFile.close();
 
     return shaderStream.str();
@@ -41,7 +65,8 @@ unsigned int Shader::CompileShader(const char* shaderPath, unsigned int shaderTy
     {
         char log[512];
         glGetShaderInfoLog(shaderObject, 512, nullptr, log);
-        const char* shaderTypeName = (shaderType == GL_VERTEX_SHADER) ? "Vertex" : "Fragment";
+        const char* shaderTypeName = (shaderType == GL_VERTEX_SHADER) ? "Vertex" :
+                                     (shaderType == GL_COMPUTE_SHADER) ? "Compute" : "Fragment";
         std::cerr << shaderTypeName << " Shader Compilation Failed: " << log << '\n';
     }
 
@@ -71,6 +96,28 @@ void Shader::Initialize(const char* vertexPath, const char* fragmentPath)
     glDeleteShader(fragmentShader);
 }
 
+void Shader::InitializeCompute(const char* computePath)
+{
+    const unsigned int computeShader = CompileShader(computePath, GL_COMPUTE_SHADER);
+
+    m_shaderProgram = glCreateProgram();
+    glAttachShader(m_shaderProgram, computeShader);
+    glLinkProgram(m_shaderProgram);
+
+    int result;
+    glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, &result);
+    if (!result)
+    {
+        char log[512];
+        glGetProgramInfoLog(m_shaderProgram, 512, nullptr, log);
+        std::cerr << "Compute Program Linking Failed: " << log << '\n';
+        glDeleteProgram(m_shaderProgram);
+        m_shaderProgram = 0;
+    }
+
+    glDeleteShader(computeShader);
+}
+
 void Shader::SetBool(const std::string& name, bool value) const
 {
     const GLint loc = glGetUniformLocation(m_shaderProgram, name.c_str());
@@ -107,6 +154,15 @@ void Shader::SetVec3(const std::string& name, float x, float y, float z) const
     }
 }
 
+void Shader::SetVec4(const std::string& name, float x, float y, float z, float w) const
+{
+    const GLint loc = glGetUniformLocation(m_shaderProgram, name.c_str());
+    if (loc != -1)
+    {
+        glUniform4f(loc, x, y, z, w);
+    }
+}
+
 void Shader::SetColor(float r, float g, float b) const
 {
     const GLint location = glGetUniformLocation(m_shaderProgram, "col");
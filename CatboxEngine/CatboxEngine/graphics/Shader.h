@@ -15,6 +15,7 @@ public:
     Shader& operator=(Shader&&) noexcept = default;
 
     void Initialize(const char* vertexPath, const char* fragmentPath);
+    void InitializeCompute(const char* computePath);  // Program stays 0 if it fails to link
     void Use() const;
     
     [[nodiscard]] unsigned int GetProgram() const noexcept { return m_shaderProgram; }
@@ -24,13 +25,16 @@ public:
     void SetInt(const std::string& name, int value) const;
     void SetFloat(const std::string& name, float value) const;
     void SetVec3(const std::string& name, float x, float y, float z) const;
+    void SetVec4(const std::string& name, float x, float y, float z, float w) const;
     void SetColor(float r, float g, float b) const;
     void SetTexture(const std::string& name, int unit) const;
     void SetMat4(const std::string& name, const glm::mat4& mat) const;
     void SetMat4Array(const std::string& name, const glm::mat4* mats, int count) const;
 
 private:
-    static std::string LoadShaderSource(const char* path);
+    static constexpr int MAX_INCLUDE_DEPTH = 4;
+
+    static std::string LoadShaderSource(const char* path, int depth = 0);
     static unsigned int CompileShader(const char* shaderPath, unsigned int shaderType);
 
     unsigned int m_shaderProgram = 0;
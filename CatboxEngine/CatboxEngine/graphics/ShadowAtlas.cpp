@@ -0,0 +1,227 @@
+#include "ShadowAtlas.h"
+#include "Shader.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+ShadowAtlas::~ShadowAtlas()
+{
+    Release();
+}
+
+bool ShadowAtlas::Initialize(int size, int minTileSize)
+{
+    Release();
+
+    m_size = size;
+    m_minTileSize = std::min(minTileSize, size);
+
+    bool complete = CreateDepthTarget(m_texture, m_fbo);
+
+    Clear();
+    return complete;
+}
+
+bool ShadowAtlas::SetStaticCopyEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        DeleteDepthTarget(m_staticTexture, m_staticFBO);
+        return false;
+    }
+    if (m_staticFBO != 0 || m_size == 0)
+        return false;
+
+    if (!CreateDepthTarget(m_staticTexture, m_staticFBO))
+    {
+        DeleteDepthTarget(m_staticTexture, m_staticFBO);
+        return false;
+    }
+    return true;
+}
+
+bool ShadowAtlas::CreateDepthTarget(unsigned int& texture, unsigned int& fbo)
+{
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, m_size, m_size, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+
+    // Shaders clamp to their tile, so no border is needed
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!complete)
+    {
+        std::cerr << "Shadow atlas framebuffer incomplete!" << std::endl;
+    }
+
+    // Start with the whole atlas empty
+    glClearDepth(1.0);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
+}
+
+void ShadowAtlas::DeleteDepthTarget(unsigned int& texture, unsigned int& fbo)
+{
+    if (fbo != 0)
+    {
+        glDeleteFramebuffers(1, &fbo);
+        fbo = 0;
+    }
+    if (texture != 0)
+    {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+}
+
+void ShadowAtlas::Release()
+{
+    DeleteDepthTarget(m_texture, m_fbo);
+    DeleteDepthTarget(m_staticTexture, m_staticFBO);
+    m_freeBlocks.clear();
+    m_size = 0;
+}
+
+void ShadowAtlas::Clear()
+{
+    int levels = LevelForSize(m_minTileSize) + 1;
+    m_freeBlocks.assign(levels, {});
+    if (m_size > 0)
+        m_freeBlocks[0].push_back(glm::ivec2(0, 0));
+}
+
+int ShadowAtlas::RoundTileSize(int size) const
+{
+    int tile = m_minTileSize;
+    while (tile < size && tile < m_size)
+        tile <<= 1;
+    return tile;
+}
+
+int ShadowAtlas::LevelForSize(int size) const
+{
+    int level = 0;
+    while ((m_size >> (level + 1)) >= size && (m_size >> (level + 1)) >= m_minTileSize)
+        ++level;
+    return level;
+}
+
+ShadowAtlasTile ShadowAtlas::Allocate(int size)
+{
+    ShadowAtlasTile tile;
+    if (m_size == 0)
+        return tile;
+
+    int level = LevelForSize(RoundTileSize(size));
+    glm::ivec2 origin;
+    if (!AllocateBlock(level, origin))
+        return tile;
+
+    tile.X = origin.x;
+    tile.Y = origin.y;
+    tile.Size = SizeForLevel(level);
+    return tile;
+}
+
+void ShadowAtlas::Free(const ShadowAtlasTile& tile)
+{
+    if (!tile.IsValid() || m_size == 0)
+        return;
+    FreeBlock(LevelForSize(tile.Size), glm::ivec2(tile.X, tile.Y));
+}
+
+bool ShadowAtlas::AllocateBlock(int level, glm::ivec2& origin)
+{
+    auto& blocks = m_freeBlocks[level];
+    if (!blocks.empty())
+    {
+        origin = blocks.back();
+        blocks.pop_back();
+        return true;
+    }
+
+    if (level == 0)
+        return false;
+
+    // Split a parent block: keep one quadrant, free the other three
+    glm::ivec2 parent;
+    if (!AllocateBlock(level - 1, parent))
+        return false;
+
+    int half = SizeForLevel(level);
+    blocks.push_back(parent + glm::ivec2(half, half));
+    blocks.push_back(parent + glm::ivec2(0, half));
+    blocks.push_back(parent + glm::ivec2(half, 0));
+    origin = parent;
+    return true;
+}
+
+void ShadowAtlas::FreeBlock(int level, glm::ivec2 origin)
+{
+    auto& blocks = m_freeBlocks[level];
+    if (level > 0)
+    {
+        // Merge back into the parent when all three siblings are free too
+        int parentSize = SizeForLevel(level - 1);
+        glm::ivec2 parent = (origin / parentSize) * parentSize;
+        int half = SizeForLevel(level);
+
+        glm::ivec2 siblings[4] = {
+            parent, parent + glm::ivec2(half, 0), parent + glm::ivec2(0, half), parent + glm::ivec2(half, half)
+        };
+        int freeSiblings = 0;
+        for (const glm::ivec2& s : siblings)
+        {
+            if (s != origin && std::find(blocks.begin(), blocks.end(), s) != blocks.end())
+                ++freeSiblings;
+        }
+
+        if (freeSiblings == 3)
+        {
+            blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&](const glm::ivec2& b)
+            {
+                return (b / parentSize) * parentSize == parent;
+            }), blocks.end());
+            FreeBlock(level - 1, parent);
+            return;
+        }
+    }
+    blocks.push_back(origin);
+}
+
+glm::vec4 ShadowAtlas::GetUVRect(const ShadowAtlasTile& tile) const
+{
+    if (m_size == 0)
+        return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+    float inv = 1.0f / (float)m_size;
+    return glm::vec4(tile.X * inv, tile.Y * inv, tile.Size * inv, tile.Size * inv);
+}
+
+void ShadowTileTable::Upload(const Shader& shader, unsigned int atlasTexture, int textureUnit) const
+{
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    shader.SetInt("u_ShadowAtlas", textureUnit);
+
+    for (int slot = 0; slot < Count; ++slot)
+    {
+        std::string index = "[" + std::to_string(slot) + "]";
+        shader.SetMat4("u_ShadowMatrices" + index, Matrices[slot]);
+        shader.SetVec4("u_ShadowRects" + index, Rects[slot].x, Rects[slot].y, Rects[slot].z, Rects[slot].w);
+    }
+}
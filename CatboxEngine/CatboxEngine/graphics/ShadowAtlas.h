@@ -0,0 +1,107 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class Shader;
+
+// Square region of the shadow atlas, in texels
+struct ShadowAtlasTile
+{
+    int X = 0;
+    int Y = 0;
+    int Size = 0;
+
+    bool IsValid() const { return Size > 0; }
+    bool operator==(const ShadowAtlasTile& other) const { return X == other.X && Y == other.Y && Size == other.Size; }
+    bool operator!=(const ShadowAtlasTile& other) const { return !(*this == other); }
+};
+
+// What a tile currently holds, so unchanged shadow maps are not redrawn
+struct ShadowTileCache
+{
+    ShadowAtlasTile Tile;             // Where it was rendered; a moved tile starts over
+    glm::mat4 Matrix{ 1.0f };         // Matrix the content was rendered with (what the shader samples)
+    uint64_t StaticHash = 0;          // Static casters baked into the static copy
+    bool StaticValid = false;
+    bool HasDynamic = false;          // Dynamic casters were drawn over the static depth
+    uint64_t LastUpdateFrame = 0;
+};
+
+// Tiles rendered this frame, in the layout the shading passes sample them:
+// u_ShadowMatrices / u_ShadowRects in FragmentShader.frag and lighting.frag
+struct ShadowTileTable
+{
+    static constexpr int MAX_TILES = 32;
+
+    int Count = 0;
+    glm::mat4 Matrices[MAX_TILES];
+    glm::vec4 Rects[MAX_TILES];          // xy = offset, zw = scale in atlas UVs
+    std::vector<int> LightFirstTile;     // per light, -1 = no shadow this frame
+    std::vector<int> LightCascadeCount;  // per light, 0 = single tile
+
+    int GetFirstTile(size_t light) const { return light < LightFirstTile.size() ? LightFirstTile[light] : -1; }
+    int GetCascadeCount(size_t light) const { return light < LightCascadeCount.size() ? LightCascadeCount[light] : 0; }
+
+    // Binds the atlas to textureUnit and sets the tile arrays on shader
+    void Upload(const Shader& shader, unsigned int atlasTexture, int textureUnit) const;
+};
+
+// One depth texture shared by every shadow-casting light.
+// Tiles are handed out by a buddy allocator: power-of-two squares that split
+// into four on demand and merge back when all four siblings are free, so
+// lights can grow, shrink and go away without fragmenting the atlas.
+// While shadow caching is on, a second texture with the same layout holds
+// static-caster-only depth, which is copied back before drawing the dynamic
+// casters.
+class ShadowAtlas
+{
+public:
+    ShadowAtlas() = default;
+    ~ShadowAtlas();
+    ShadowAtlas(const ShadowAtlas&) = delete;
+    ShadowAtlas& operator=(const ShadowAtlas&) = delete;
+
+    // Creates the depth texture and framebuffer; size and minTileSize must be powers of two
+    bool Initialize(int size = 4096, int minTileSize = 128);
+    void Release();
+
+    // Creates or frees the static-caster copy (as large as the atlas).
+    // Returns true when it was just created, i.e. it holds nothing yet.
+    bool SetStaticCopyEnabled(bool enabled);
+
+    // Rounds up to a power of two in [minTileSize, size]; invalid tile when full
+    ShadowAtlasTile Allocate(int size);
+    void Free(const ShadowAtlasTile& tile);
+    void Clear();  // Frees every tile
+
+    // Tile size a request would get (power of two, clamped)
+    int RoundTileSize(int size) const;
+
+    // (offset.xy, scale.xy) mapping a tile's [0,1] shadow coordinates into atlas UVs
+    glm::vec4 GetUVRect(const ShadowAtlasTile& tile) const;
+
+    unsigned int GetTexture() const { return m_texture; }
+    unsigned int GetFBO() const { return m_fbo; }
+    unsigned int GetStaticFBO() const { return m_staticFBO; }  // 0 while the copy is disabled
+    int GetSize() const { return m_size; }
+    int GetMinTileSize() const { return m_minTileSize; }
+
+private:
+    unsigned int m_texture = 0;
+    unsigned int m_fbo = 0;
+    unsigned int m_staticTexture = 0;
+    unsigned int m_staticFBO = 0;
+    int m_size = 0;
+    int m_minTileSize = 0;
+
+    // Free block origins per level; level 0 is the whole atlas
+    std::vector<std::vector<glm::ivec2>> m_freeBlocks;
+
+    int LevelForSize(int size) const;
+    int SizeForLevel(int level) const { return m_size >> level; }
+    bool CreateDepthTarget(unsigned int& texture, unsigned int& fbo);
+    static void DeleteDepthTarget(unsigned int& texture, unsigned int& fbo);
+    bool AllocateBlock(int level, glm::ivec2& origin);
+    void FreeBlock(int level, glm::ivec2 origin);
+};
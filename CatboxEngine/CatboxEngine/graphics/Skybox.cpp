@@ -39,20 +39,8 @@ void Skybox::CleanupMesh()
 {
     if (!m_meshLoaded) return;
 
-    if (m_mesh.VAO != 0) { glDeleteVertexArrays(1, &m_mesh.VAO); m_mesh.VAO = 0; }
-    if (m_mesh.VBO != 0) { glDeleteBuffers(1,      &m_mesh.VBO); m_mesh.VBO = 0; }
-    if (m_mesh.EBO != 0) { glDeleteBuffers(1,      &m_mesh.EBO); m_mesh.EBO = 0; }
-
-    for (auto& sub : m_mesh.SubMeshes)
-    {
-        if (sub.EBO != 0) { glDeleteBuffers(1, &sub.EBO); sub.EBO = 0; }
-        if (sub.DiffuseTexture  != 0) { glDeleteTextures(1, &sub.DiffuseTexture);  sub.DiffuseTexture  = 0; }
-        if (sub.SpecularTexture != 0) { glDeleteTextures(1, &sub.SpecularTexture); sub.SpecularTexture = 0; }
-        if (sub.NormalTexture   != 0) { glDeleteTextures(1, &sub.NormalTexture);   sub.NormalTexture   = 0; }
-    }
-
-    if (m_mesh.DiffuseTexture  != 0) { glDeleteTextures(1, &m_mesh.DiffuseTexture);  m_mesh.DiffuseTexture  = 0; }
-    if (m_mesh.SpecularTexture != 0) { glDeleteTextures(1, &m_mesh.SpecularTexture); m_mesh.SpecularTexture = 0; }
+    m_mesh.ReleaseGPU();
+    m_mesh.ReleaseTextures();
 
     m_mesh = Mesh{};
     m_meshLoaded = false;
@@ -106,6 +94,7 @@ bool Skybox::LoadFromFile(const std::string& path)
     if (!ok)
     {
         std::cerr << "Skybox: failed to load mesh \"" << path << "\"\n";
+        newMesh.ReleaseTextures();
         return false;
     }
 
@@ -114,6 +103,7 @@ bool Skybox::LoadFromFile(const std::string& path)
     if (newMesh.VAO == 0)
     {
         std::cerr << "Skybox: mesh upload failed for \"" << path << "\"\n";
+        newMesh.ReleaseTextures();
         return false;
     }
 
@@ -164,7 +154,7 @@ void Skybox::Draw(const glm::mat4& view, const glm::mat4& projection)
     {
         // Bind the first available diffuse texture from the mesh
         glActiveTexture(GL_TEXTURE0);
-        unsigned int tex = 0;
+        TextureHandle tex = 0;
         if (!m_mesh.SubMeshes.empty())
         {
             for (const auto& sub : m_mesh.SubMeshes)
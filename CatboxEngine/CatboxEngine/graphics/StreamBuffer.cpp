@@ -0,0 +1,197 @@
+#include "StreamBuffer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+StreamBuffer& StreamBuffer::Instance()
+{
+    static StreamBuffer inst;
+    return inst;
+}
+
+bool StreamBuffer::Initialize(size_t regionBytes)
+{
+    if (m_buffer != 0)
+        return true;
+    if (!GLAD_GL_VERSION_4_4)
+    {
+        std::cerr << "StreamBuffer: GL 4.4 buffer storage unavailable, using plain uploads.\n";
+        return false;
+    }
+
+    GLint alignment = 16;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_storageAlignment = std::max<size_t>((size_t)alignment, 16);
+    return CreateBuffer(regionBytes);
+}
+
+bool StreamBuffer::CreateBuffer(size_t regionBytes)
+{
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    size_t totalBytes = regionBytes * REGION_COUNT;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)totalBytes, nullptr, flags);
+    m_mapped = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)totalBytes, flags);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (!m_mapped)
+    {
+        std::cerr << "StreamBuffer: failed to map " << totalBytes << " bytes.\n";
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+        return false;
+    }
+
+    m_regionBytes = regionBytes;
+    m_region = 0;
+    m_head = 0;
+    m_requested = 0;
+    return true;
+}
+
+void StreamBuffer::Release()
+{
+    for (void*& fence : m_fences)
+    {
+        if (fence) { glDeleteSync((GLsync)fence); fence = nullptr; }
+    }
+    if (m_buffer != 0)
+    {
+        // Deleting a mapped buffer unmaps it
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_mapped = nullptr;
+    m_regionBytes = 0;
+    m_head = 0;
+    m_requested = 0;
+}
+
+void StreamBuffer::BeginFrame()
+{
+    if (m_buffer == 0)
+        return;
+
+    // Outgrown: start over with a bigger buffer. The driver keeps the old one
+    // alive until the GPU is done with it.
+    if (m_requested > m_regionBytes)
+    {
+        size_t regionBytes = m_regionBytes;
+        while (regionBytes < m_requested)
+            regionBytes *= 2;
+        Release();
+        CreateBuffer(regionBytes);
+        return;
+    }
+
+    // Everything issued so far may read the current region
+    if (m_fences[m_region])
+        glDeleteSync((GLsync)m_fences[m_region]);
+    m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_region = (m_region + 1) % REGION_COUNT;
+    WaitForRegion(m_region);
+    m_head = 0;
+    m_requested = 0;
+}
+
+void StreamBuffer::WaitForRegion(int region)
+{
+    GLsync fence = (GLsync)m_fences[region];
+    if (!fence)
+        return;
+
+    // Only blocks when the CPU is REGION_COUNT frames ahead of the GPU
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    for (;;)
+    {
+        GLenum result = glClientWaitSync(fence, flags, 1000000);  // 1 ms
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+            break;
+        flags = 0;
+    }
+    glDeleteSync(fence);
+    m_fences[region] = nullptr;
+}
+
+StreamRange StreamBuffer::Allocate(size_t size, size_t alignment)
+{
+    StreamRange range;
+    if (m_buffer == 0)
+        return range;
+
+    size_t offset = (m_head + alignment - 1) & ~(alignment - 1);
+    m_requested = std::max(m_requested, offset + size);
+    if (offset + size > m_regionBytes)
+        return range;
+
+    m_head = offset + size;
+    range.Buffer = m_buffer;
+    range.Offset = (size_t)m_region * m_regionBytes + offset;
+    range.Size = size;
+    range.Data = m_mapped + range.Offset;
+    return range;
+}
+
+StreamRange StreamBuffer::UploadStorage(unsigned int& fallback, const void* data, size_t size)
+{
+    // An empty range cannot be bound; shaders then see zero-filled words
+    size_t bytes = std::max<size_t>(size, 16);
+    StreamRange range = Allocate(bytes, m_storageAlignment);
+    if (range.Data)
+    {
+        if (size > 0)
+            std::memcpy(range.Data, data, size);
+        if (bytes > size)
+            std::memset((unsigned char*)range.Data + size, 0, bytes - size);
+        return range;
+    }
+
+    SpecifyStorage(fallback, data, size);
+    range.Buffer = fallback;
+    range.Offset = 0;
+    range.Size = size > 0 ? size : bytes;  // SpecifyStorage fills an empty buffer with 16 bytes
+    return range;
+}
+
+void StreamBuffer::SpecifyStorage(unsigned int& buffer, const void* data, size_t size)
+{
+    static const uint32_t empty[4] = {};
+    if (buffer == 0)
+        glGenBuffers(1, &buffer);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    if (size == 0)
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(empty), empty, GL_STREAM_DRAW);
+    else
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void StreamBuffer::BindStorage(unsigned int binding, const StreamRange& range)
+{
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, range.Buffer, (GLintptr)range.Offset, (GLsizeiptr)range.Size);
+}
+
+void StreamBuffer::Write(unsigned int buffer, size_t offset, const void* data, size_t size)
+{
+    if (size == 0)
+        return;
+
+    StreamRange range = Allocate(size);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (range.Data)
+    {
+        std::memcpy(range.Data, data, size);
+        glBindBuffer(GL_COPY_READ_BUFFER, range.Buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)range.Offset, (GLintptr)offset, (GLsizeiptr)size);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    else
+    {
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
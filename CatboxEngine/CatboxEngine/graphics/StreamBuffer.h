@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+
+// Part of the stream buffer handed out for this frame
+struct StreamRange
+{
+    unsigned int Buffer = 0;
+    size_t Offset = 0;
+    size_t Size = 0;
+    void* Data = nullptr;   // Write-only mapping; nullptr when the frame's region is full
+};
+
+// Ring allocator for per-frame GPU data (instances, bone palettes, light
+// lists, debug lines, rewritten vertex streams). One buffer created with
+// glBufferStorage is mapped once, persistently and coherently, and split into
+// REGION_COUNT regions used by consecutive frames. BeginFrame() fences the
+// region just used and waits for the GPU to finish with the next one, so
+// writing through Data never stalls on the driver and never races the GPU.
+//
+// A frame that asks for more than its region gets nullptr allocations (the
+// helpers below then fall back to a plain glBufferData / glBufferSubData) and
+// the buffer is re-created twice as large at the next BeginFrame().
+// Must be used on the thread that holds the GL context.
+class StreamBuffer
+{
+public:
+    static StreamBuffer& Instance();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // False (every allocation fails) without GL 4.4 buffer storage
+    bool Initialize(size_t regionBytes = DEFAULT_REGION_BYTES);
+    void Release();
+
+    // Call once per frame before the first allocation
+    void BeginFrame();
+
+    // size bytes in this frame's region at a multiple of alignment (a power of two)
+    StreamRange Allocate(size_t size, size_t alignment = 16);
+
+    // Copies data into a shader storage range (never empty, SSBO-aligned).
+    // A full region re-specifies fallback instead and returns all of it.
+    StreamRange UploadStorage(unsigned int& fallback, const void* data, size_t size);
+    static void BindStorage(unsigned int binding, const StreamRange& range);
+
+    // Re-specifies buffer (created if 0) as a shader storage buffer holding
+    // size bytes of data, or 16 zero bytes when size is 0. data may be nullptr.
+    static void SpecifyStorage(unsigned int& buffer, const void* data, size_t size);
+
+    // Updates part of buffer by a GPU-side copy out of the ring, or
+    // glBufferSubData when the region is full
+    void Write(unsigned int buffer, size_t offset, const void* data, size_t size);
+
+    // Bytes handed out since BeginFrame()
+    size_t GetUsedBytes() const { return m_head; }
+    size_t GetRegionBytes() const { return m_regionBytes; }
+
+    static constexpr int REGION_COUNT = 3;
+    static constexpr size_t DEFAULT_REGION_BYTES = 4u << 20;
+
+private:
+    StreamBuffer() = default;
+    ~StreamBuffer() = default;
+
+    bool CreateBuffer(size_t regionBytes);
+    void WaitForRegion(int region);
+
+    unsigned int m_buffer = 0;
+    unsigned char* m_mapped = nullptr;
+    size_t m_regionBytes = 0;
+    size_t m_storageAlignment = 16;
+    void* m_fences[REGION_COUNT] = {};   // GLsync of the last frame that used each region
+    int m_region = 0;
+    size_t m_head = 0;          // Next free byte in the current region
+    size_t m_requested = 0;     // Asked for this frame, including what did not fit
+};
@@ -0,0 +1,52 @@
+#include "TerrainManager.h"
+#include "TerrainQuadtree.h"
+
+TerrainManager::TerrainManager() {}
+TerrainManager::~TerrainManager() {}
+
+TerrainManager& TerrainManager::Instance()
+{
+    static TerrainManager inst;
+    return inst;
+}
+
+TerrainHandle TerrainManager::Create(std::unique_ptr<TerrainQuadtree> chunks)
+{
+    if (!chunks)
+        return 0;
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    TerrainHandle h = m_nextHandle++;
+    m_terrains[h] = std::move(chunks);
+    return h;
+}
+
+TerrainQuadtree* TerrainManager::Get(TerrainHandle h) const
+{
+    if (h == 0)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_terrains.find(h);
+    return it != m_terrains.end() ? it->second.get() : nullptr;
+}
+
+void TerrainManager::Release(TerrainHandle h)
+{
+    std::unique_ptr<TerrainQuadtree> chunks;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_terrains.find(h);
+        if (it == m_terrains.end())
+            return;
+        chunks = std::move(it->second);
+        m_terrains.erase(it);
+    }
+    // GL objects are deleted here, outside the lock
+}
+
+void TerrainManager::Shutdown()
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_terrains.clear();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class TerrainQuadtree;
+
+using TerrainHandle = uint32_t;
+
+// Owns the LOD chunks (and so the GL objects) of every generated terrain.
+// Entities refer to them by handle, like meshes: copies of an entity (scene
+// captures, render snapshots) alias the same chunks but never free them. The
+// entity in the EntityManager owns its handle and releases it when it is
+// removed or its terrain is regenerated. Released handles look up nullptr
+// and are never reused. Create and Release need the GL context.
+class TerrainManager
+{
+public:
+    static TerrainManager& Instance();
+
+    TerrainManager(const TerrainManager&) = delete;
+    TerrainManager& operator=(const TerrainManager&) = delete;
+
+    TerrainHandle Create(std::unique_ptr<TerrainQuadtree> chunks);
+
+    // nullptr for 0 and released handles
+    TerrainQuadtree* Get(TerrainHandle h) const;
+
+    void Release(TerrainHandle h);
+
+    // Frees every terrain while the context still exists
+    void Shutdown();
+
+private:
+    TerrainManager();
+    ~TerrainManager();
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<TerrainHandle, std::unique_ptr<TerrainQuadtree>> m_terrains;
+    TerrainHandle m_nextHandle = 1;
+};
@@ -0,0 +1,605 @@
+#include "TerrainQuadtree.h"
+#include "VertexFormat.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    // Old monolithic terrain tiled its UVs 8 times across the whole grid
+    // (TERRAIN_UV_TILING in the vertex shaders)
+    constexpr float UV_TILING = 8.0f;
+
+    float DistanceToBox(const glm::vec3& p, const glm::vec3& boxMin, const glm::vec3& boxMax)
+    {
+        glm::vec3 d = glm::max(glm::max(boxMin - p, p - boxMax), glm::vec3(0.0f));
+        return glm::length(d);
+    }
+}
+
+TerrainQuadtree::~TerrainQuadtree()
+{
+    Release();
+}
+
+void TerrainQuadtree::Release()
+{
+    m_selected.clear();
+    if (m_vao != 0)           { glDeleteVertexArrays(1, &m_vao);     m_vao = 0; }
+    if (m_gridVBO != 0)       { glDeleteBuffers(1, &m_gridVBO);      m_gridVBO = 0; }
+    if (m_ebo != 0)           { glDeleteBuffers(1, &m_ebo);          m_ebo = 0; }
+    if (m_heightTexture != 0) { glDeleteTextures(1, &m_heightTexture); m_heightTexture = 0; }
+}
+
+float TerrainQuadtree::Height(int gx, int gz) const
+{
+    gx = std::max(0, std::min(gx, m_cellsX));
+    gz = std::max(0, std::min(gz, m_cellsZ));
+    return m_heights[(size_t)gz * (m_cellsX + 1) + gx] * (1.0f / 65535.0f);
+}
+
+float TerrainQuadtree::SampleHeight(float u, float v) const
+{
+    if (m_heights.empty())
+        return 0.0f;
+
+    float fx = std::max(0.0f, std::min(1.0f, u)) * m_cellsX;
+    float fz = std::max(0.0f, std::min(1.0f, v)) * m_cellsZ;
+    int ix = std::min((int)fx, m_cellsX - 1);
+    int iz = std::min((int)fz, m_cellsZ - 1);
+    float tx = fx - ix;
+    float tz = fz - iz;
+    float h00 = Height(ix, iz), h10 = Height(ix + 1, iz);
+    float h01 = Height(ix, iz + 1), h11 = Height(ix + 1, iz + 1);
+    return (h00 + (h10 - h00) * tx) * (1.0f - tz) + (h01 + (h11 - h01) * tx) * tz;
+}
+
+void TerrainQuadtree::Build(const std::vector<float>& heights, int cellsX, int cellsZ)
+{
+    Release();
+    m_cellsX = std::max(cellsX, 1);
+    m_cellsZ = std::max(cellsZ, 1);
+    m_heights.resize((size_t)(m_cellsX + 1) * (m_cellsZ + 1));
+    for (size_t i = 0; i < m_heights.size(); ++i)
+    {
+        float h = i < heights.size() ? std::max(0.0f, std::min(1.0f, heights[i])) : 0.0f;
+        m_heights[i] = (uint16_t)(h * 65535.0f + 0.5f);
+    }
+
+    // Terrains narrower than a chunk get one smaller chunk instead of a grid
+    // of collapsed quads
+    m_chunkCells = CHUNK_CELLS;
+    while (m_chunkCells > 2 && m_chunkCells / 2 >= std::max(m_cellsX, m_cellsZ))
+        m_chunkCells /= 2;
+
+    // Levels from the leaves up to a single row/column of roots
+    m_levels.clear();
+    Level leaves;
+    leaves.NodesX = (m_cellsX + m_chunkCells - 1) / m_chunkCells;
+    leaves.NodesZ = (m_cellsZ + m_chunkCells - 1) / m_chunkCells;
+    m_levels.push_back(leaves);
+    while (m_levels.back().NodesX > 1 || m_levels.back().NodesZ > 1)
+    {
+        const Level& below = m_levels.back();
+        Level level;
+        level.NodesX = (below.NodesX + 1) / 2;
+        level.NodesZ = (below.NodesZ + 1) / 2;
+        level.FirstNode = below.FirstNode + below.NodesX * below.NodesZ;
+        m_levels.push_back(level);
+    }
+    const Level& top = m_levels.back();
+    size_t nodeCount = (size_t)(top.FirstNode + top.NodesX * top.NodesZ);
+    m_nodeMinY.assign(nodeCount, FLT_MAX);
+    m_nodeMaxY.assign(nodeCount, -FLT_MAX);
+    m_split.assign(nodeCount, 0);
+    UpdateNodeBounds(0, 0, m_cellsX, m_cellsZ);
+
+    // One texel per grid vertex; read with texelFetch only
+    glGenTextures(1, &m_heightTexture);
+    glBindTexture(GL_TEXTURE_2D, m_heightTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, m_cellsX + 1, m_cellsZ + 1, 0, GL_RED, GL_UNSIGNED_SHORT, m_heights.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    BuildPatchGrid();
+    ++m_selectionVersion;
+}
+
+void TerrainQuadtree::UpdateHeights(int x, int z, int width, int depth, const float* heights)
+{
+    int x0 = std::max(x, 0), z0 = std::max(z, 0);
+    int x1 = std::min(x + width, m_cellsX + 1), z1 = std::min(z + depth, m_cellsZ + 1);
+    if (m_heightTexture == 0 || x0 >= x1 || z0 >= z1)
+        return;
+
+    std::vector<uint16_t> rect((size_t)(x1 - x0) * (z1 - z0));
+    for (int gz = z0; gz < z1; ++gz)
+    {
+        for (int gx = x0; gx < x1; ++gx)
+        {
+            float h = std::max(0.0f, std::min(1.0f, heights[(size_t)(gz - z) * width + (gx - x)]));
+            uint16_t value = (uint16_t)(h * 65535.0f + 0.5f);
+            m_heights[(size_t)gz * (m_cellsX + 1) + gx] = value;
+            rect[(size_t)(gz - z0) * (x1 - x0) + (gx - x0)] = value;
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_heightTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, z0, x1 - x0, z1 - z0, GL_RED, GL_UNSIGNED_SHORT, rect.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    UpdateNodeBounds(x0, z0, x1 - 1, z1 - 1);
+    ++m_selectionVersion;
+}
+
+void TerrainQuadtree::UpdateNodeBounds(int x0, int z0, int x1, int z1)
+{
+    // Leaves sharing a grid vertex on their border both see it
+    const Level& leaves = m_levels[0];
+    int leafX0 = std::max(x0 - 1, 0) / m_chunkCells, leafX1 = std::min(x1 / m_chunkCells, leaves.NodesX - 1);
+    int leafZ0 = std::max(z0 - 1, 0) / m_chunkCells, leafZ1 = std::min(z1 / m_chunkCells, leaves.NodesZ - 1);
+    for (int z = leafZ0; z <= leafZ1; ++z)
+    {
+        for (int x = leafX0; x <= leafX1; ++x)
+        {
+            uint32_t id = NodeId(0, x, z);
+            m_nodeMinY[id] = FLT_MAX;
+            m_nodeMaxY[id] = -FLT_MAX;
+            int gz1 = std::min((z + 1) * m_chunkCells, m_cellsZ);
+            int gx1 = std::min((x + 1) * m_chunkCells, m_cellsX);
+            for (int gz = z * m_chunkCells; gz <= gz1; ++gz)
+            {
+                for (int gx = x * m_chunkCells; gx <= gx1; ++gx)
+                {
+                    float h = Height(gx, gz);
+                    m_nodeMinY[id] = std::min(m_nodeMinY[id], h);
+                    m_nodeMaxY[id] = std::max(m_nodeMaxY[id], h);
+                }
+            }
+        }
+    }
+
+    // Then every ancestor of the touched leaves
+    for (int l = 1; l < (int)m_levels.size(); ++l)
+    {
+        leafX0 /= 2; leafX1 /= 2;
+        leafZ0 /= 2; leafZ1 /= 2;
+        for (int z = leafZ0; z <= leafZ1; ++z)
+        {
+            for (int x = leafX0; x <= leafX1; ++x)
+            {
+                uint32_t id = NodeId(l, x, z);
+                m_nodeMinY[id] = FLT_MAX;
+                m_nodeMaxY[id] = -FLT_MAX;
+                for (int cz = z * 2; cz <= z * 2 + 1; ++cz)
+                {
+                    for (int cx = x * 2; cx <= x * 2 + 1; ++cx)
+                    {
+                        if (!NodeExists(l - 1, cx, cz))
+                            continue;
+                        uint32_t child = NodeId(l - 1, cx, cz);
+                        m_nodeMinY[id] = std::min(m_nodeMinY[id], m_nodeMinY[child]);
+                        m_nodeMaxY[id] = std::max(m_nodeMaxY[id], m_nodeMaxY[child]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void TerrainQuadtree::BuildPatchGrid()
+{
+    const int n = m_chunkCells;
+    const uint32_t rowLength = (uint32_t)n + 1;
+
+    // Vertex (i, j) of a chunk; the shader turns it into a grid vertex with
+    // the chunk's origin and step
+    std::vector<float> grid;
+    grid.reserve((size_t)rowLength * rowLength * 3);
+    for (int j = 0; j <= n; ++j)
+    {
+        for (int i = 0; i <= n; ++i)
+        {
+            grid.push_back((float)i);
+            grid.push_back(0.0f);
+            grid.push_back((float)j);
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    indices.reserve((size_t)16 * n * n * 6);
+    for (uint32_t edges = 0; edges < 16; ++edges)
+    {
+        // On an edge that meets a coarser chunk, each odd vertex collapses
+        // onto the even one before it: the two quads beside it become a fan
+        // whose outer edge matches the neighbour's single quad
+        auto vertex = [&](int x, int z) -> uint32_t
+        {
+            if ((edges & EdgeNorth) && z == 0 && (x & 1))      --x;
+            else if ((edges & EdgeSouth) && z == n && (x & 1)) --x;
+            else if ((edges & EdgeWest) && x == 0 && (z & 1))  --z;
+            else if ((edges & EdgeEast) && x == n && (z & 1))  --z;
+            return (uint32_t)z * rowLength + (uint32_t)x;
+        };
+        auto addTriangle = [&](uint32_t i0, uint32_t i1, uint32_t i2)
+        {
+            if (i0 != i1 && i1 != i2 && i0 != i2)
+            {
+                indices.push_back(i0);
+                indices.push_back(i1);
+                indices.push_back(i2);
+            }
+        };
+
+        IndexRange& range = m_variants[edges];
+        range.FirstIndex = (uint32_t)indices.size();
+        for (int z = 0; z < n; ++z)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                // Same winding as the old monolithic grid
+                uint32_t a = vertex(x, z);
+                uint32_t b = vertex(x + 1, z);
+                uint32_t c = vertex(x, z + 1);
+                uint32_t d = vertex(x + 1, z + 1);
+                addTriangle(a, c, b);
+                addTriangle(b, c, d);
+            }
+        }
+        range.IndexCount = (uint32_t)indices.size() - range.FirstIndex;
+    }
+
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    glGenBuffers(1, &m_gridVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_gridVBO);
+    glBufferData(GL_ARRAY_BUFFER, grid.size() * sizeof(float), grid.data(), GL_STATIC_DRAW);
+    VertexFormat::BindPositionStream();
+
+    glGenBuffers(1, &m_ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+}
+
+int TerrainQuadtree::SelectedLevelAt(int level, int x, int z) const
+{
+    for (int l = (int)m_levels.size() - 1; l > level; --l)
+    {
+        int shift = l - level;
+        if (!m_split[NodeId(l, x >> shift, z >> shift)])
+            return l;
+    }
+    return level;
+}
+
+void TerrainQuadtree::CollectSelected(int level, int x, int z, std::vector<uint32_t>& out) const
+{
+    uint32_t id = NodeId(level, x, z);
+    if (level == 0 || !m_split[id])
+    {
+        out.push_back(id);
+        return;
+    }
+    for (int cz = z * 2; cz <= z * 2 + 1; ++cz)
+    {
+        for (int cx = x * 2; cx <= x * 2 + 1; ++cx)
+        {
+            if (NodeExists(level - 1, cx, cz))
+                CollectSelected(level - 1, cx, cz, out);
+        }
+    }
+}
+
+void TerrainQuadtree::DecodeNode(uint32_t node, int& level, int& x, int& z) const
+{
+    level = 0;
+    while (level + 1 < (int)m_levels.size() && (int)node >= m_levels[level + 1].FirstNode)
+        ++level;
+    int local = (int)node - m_levels[level].FirstNode;
+    x = local % m_levels[level].NodesX;
+    z = local / m_levels[level].NodesX;
+}
+
+void TerrainQuadtree::Select(const glm::mat4& world, const glm::vec3& eye, float detailScale, bool fullDetail)
+{
+    if (m_levels.empty())
+        return;
+
+    // World box of a node: local box as centre/extent through |M|
+    auto nodeBounds = [&](int level, int x, int z, glm::vec3& worldMin, glm::vec3& worldMax)
+    {
+        int span = m_chunkCells << level;
+        uint32_t id = NodeId(level, x, z);
+        glm::vec3 localMin((float)std::min(x * span, m_cellsX) / m_cellsX - 0.5f, m_nodeMinY[id],
+                           (float)std::min(z * span, m_cellsZ) / m_cellsZ - 0.5f);
+        glm::vec3 localMax((float)std::min((x + 1) * span, m_cellsX) / m_cellsX - 0.5f, m_nodeMaxY[id],
+                           (float)std::min((z + 1) * span, m_cellsZ) / m_cellsZ - 0.5f);
+        glm::vec3 center = glm::vec3(world * glm::vec4((localMin + localMax) * 0.5f, 1.0f));
+        glm::vec3 ext = (localMax - localMin) * 0.5f;
+        glm::vec3 worldExt;
+        worldExt.x = std::abs(world[0][0]) * ext.x + std::abs(world[1][0]) * ext.y + std::abs(world[2][0]) * ext.z;
+        worldExt.y = std::abs(world[0][1]) * ext.x + std::abs(world[1][1]) * ext.y + std::abs(world[2][1]) * ext.z;
+        worldExt.z = std::abs(world[0][2]) * ext.x + std::abs(world[1][2]) * ext.y + std::abs(world[2][2]) * ext.z;
+        worldMin = center - worldExt;
+        worldMax = center + worldExt;
+    };
+
+    // World width of one cell, for the split distance
+    float cellSize = std::max(glm::length(glm::vec3(world[0])) / m_cellsX,
+                              glm::length(glm::vec3(world[2])) / m_cellsZ);
+
+    // 1. Split by distance, top down
+    std::fill(m_split.begin(), m_split.end(), 0);
+    struct Pending { int Level, X, Z; };
+    std::vector<Pending> stack;
+    int top = (int)m_levels.size() - 1;
+    for (int z = 0; z < m_levels[top].NodesZ; ++z)
+        for (int x = 0; x < m_levels[top].NodesX; ++x)
+            stack.push_back({ top, x, z });
+    while (!stack.empty())
+    {
+        Pending node = stack.back();
+        stack.pop_back();
+        if (node.Level == 0)
+            continue;
+
+        glm::vec3 boundsMin, boundsMax;
+        nodeBounds(node.Level, node.X, node.Z, boundsMin, boundsMax);
+        float width = (float)(m_chunkCells << node.Level) * cellSize;
+        if (!fullDetail && DistanceToBox(eye, boundsMin, boundsMax) >= LOD_DISTANCE * detailScale * width)
+            continue;
+
+        m_split[NodeId(node.Level, node.X, node.Z)] = 1;
+        for (int cz = node.Z * 2; cz <= node.Z * 2 + 1; ++cz)
+            for (int cx = node.X * 2; cx <= node.X * 2 + 1; ++cx)
+                if (NodeExists(node.Level - 1, cx, cz))
+                    stack.push_back({ node.Level - 1, cx, cz });
+    }
+
+    // 2. Split until every neighbour is at most one level coarser, which is
+    //    all the stitching variants can close
+    static const int NEIGHBOURS[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    static const uint32_t NEIGHBOUR_EDGES[4] = { EdgeWest, EdgeEast, EdgeNorth, EdgeSouth };
+    std::vector<uint32_t> nodes;
+    for (bool changed = true; changed; )
+    {
+        changed = false;
+        nodes.clear();
+        for (int z = 0; z < m_levels[top].NodesZ; ++z)
+            for (int x = 0; x < m_levels[top].NodesX; ++x)
+                CollectSelected(top, x, z, nodes);
+
+        for (uint32_t node : nodes)
+        {
+            int level, x, z;
+            DecodeNode(node, level, x, z);
+            for (const auto& offset : NEIGHBOURS)
+            {
+                int nx = x + offset[0], nz = z + offset[1];
+                if (!NodeExists(level, nx, nz))
+                    continue;
+                int coarse = SelectedLevelAt(level, nx, nz);
+                if (coarse >= level + 2)
+                {
+                    m_split[NodeId(coarse, nx >> (coarse - level), nz >> (coarse - level))] = 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // 3. Stitching per edge and bounds for culling
+    std::vector<Selected> selected;
+    selected.reserve(nodes.size());
+    bool same = nodes.size() == m_selected.size();
+    for (uint32_t node : nodes)
+    {
+        int level, x, z;
+        DecodeNode(node, level, x, z);
+
+        Selected entry;
+        entry.Node = node;
+        entry.Edges = 0;
+        for (int n = 0; n < 4; ++n)
+        {
+            int nx = x + NEIGHBOURS[n][0], nz = z + NEIGHBOURS[n][1];
+            if (NodeExists(level, nx, nz) && SelectedLevelAt(level, nx, nz) > level)
+                entry.Edges |= NEIGHBOUR_EDGES[n];
+        }
+        nodeBounds(level, x, z, entry.WorldMin, entry.WorldMax);
+        if (same)
+        {
+            const Selected& previous = m_selected[selected.size()];
+            same = previous.Node == entry.Node && previous.Edges == entry.Edges;
+        }
+        selected.push_back(entry);
+    }
+    m_selected.swap(selected);
+    if (!same)
+        ++m_selectionVersion;
+}
+
+int TerrainQuadtree::Draw(const Shader& shader, const Frustum* frustum, int& drawCalls) const
+{
+    if (m_vao == 0)
+        return 0;
+
+    glActiveTexture(GL_TEXTURE0 + HEIGHT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, m_heightTexture);
+    shader.SetTexture("u_TerrainHeight", HEIGHT_TEXTURE_UNIT);
+    shader.SetVec4("u_TerrainCells", (float)m_cellsX, (float)m_cellsZ, 0.0f, 0.0f);
+    shader.SetBool("u_IsTerrain", true);
+    glBindVertexArray(m_vao);
+
+    int triangles = 0;
+    for (const Selected& entry : m_selected)
+    {
+        if (frustum && !frustum->IsBoxVisible(Vec3(entry.WorldMin.x, entry.WorldMin.y, entry.WorldMin.z),
+                                              Vec3(entry.WorldMax.x, entry.WorldMax.y, entry.WorldMax.z)))
+            continue;
+
+        int level, x, z;
+        DecodeNode(entry.Node, level, x, z);
+        int span = m_chunkCells << level;
+        shader.SetVec4("u_TerrainPatch", (float)(x * span), (float)(z * span), (float)(1 << level), 0.0f);
+
+        const IndexRange& range = m_variants[entry.Edges];
+        glDrawElements(GL_TRIANGLES, (GLsizei)range.IndexCount, GL_UNSIGNED_INT,
+                       (void*)(range.FirstIndex * sizeof(uint32_t)));
+        drawCalls++;
+        triangles += (int)range.IndexCount / 3;
+    }
+
+    glBindVertexArray(0);
+    shader.SetBool("u_IsTerrain", false);
+    glActiveTexture(GL_TEXTURE0);
+    return triangles;
+}
+
+int TerrainQuadtree::ProxyGridX(int i) const
+{
+    const int cellsX = std::min(m_cellsX, PROXY_CELLS);
+    return std::max(0, std::min(i, cellsX)) * m_cellsX / cellsX;
+}
+
+int TerrainQuadtree::ProxyGridZ(int j) const
+{
+    const int cellsZ = std::min(m_cellsZ, PROXY_CELLS);
+    return std::max(0, std::min(j, cellsZ)) * m_cellsZ / cellsZ;
+}
+
+float TerrainQuadtree::ProxyHeight(int i, int j) const
+{
+    // Lowest height over the proxy cells around the vertex: every proxy
+    // triangle then lies at or below the full-resolution surface
+    float h = FLT_MAX;
+    for (int gz = ProxyGridZ(j - 1); gz <= ProxyGridZ(j + 1); ++gz)
+        for (int gx = ProxyGridX(i - 1); gx <= ProxyGridX(i + 1); ++gx)
+            h = std::min(h, Height(gx, gz));
+    return h;
+}
+
+void TerrainQuadtree::SetProxyNormals(Mesh& mesh, int i0, int j0, int i1, int j1) const
+{
+    const int cellsX = std::min(m_cellsX, PROXY_CELLS);
+    const int cellsZ = std::min(m_cellsZ, PROXY_CELLS);
+    auto proxyHeight = [&](int i, int j)
+    {
+        i = std::max(0, std::min(i, cellsX));
+        j = std::max(0, std::min(j, cellsZ));
+        return mesh.Vertices[(size_t)j * (cellsX + 1) + i].Position.y;
+    };
+    for (int j = std::max(j0, 0); j <= std::min(j1, cellsZ); ++j)
+    {
+        for (int i = std::max(i0, 0); i <= std::min(i1, cellsX); ++i)
+        {
+            glm::vec3 normal = glm::normalize(glm::vec3((proxyHeight(i - 1, j) - proxyHeight(i + 1, j)) * cellsX * 0.5f, 1.0f,
+                                                        (proxyHeight(i, j - 1) - proxyHeight(i, j + 1)) * cellsZ * 0.5f));
+            mesh.Vertices[(size_t)j * (cellsX + 1) + i].Normal = { normal.x, normal.y, normal.z };
+        }
+    }
+}
+
+void TerrainQuadtree::SetProxyBounds(Mesh& mesh) const
+{
+    // Culling must still see the peaks the proxy sits under
+    mesh.CalculateBounds();
+    const Level& top = m_levels.back();
+    for (int z = 0; z < top.NodesZ; ++z)
+        for (int x = 0; x < top.NodesX; ++x)
+            mesh.BoundsMax.y = std::max(mesh.BoundsMax.y, m_nodeMaxY[NodeId((int)m_levels.size() - 1, x, z)]);
+}
+
+void TerrainQuadtree::BuildProxyMesh(Mesh& mesh) const
+{
+    if (m_heights.empty())
+        return;
+
+    const int cellsX = std::min(m_cellsX, PROXY_CELLS);
+    const int cellsZ = std::min(m_cellsZ, PROXY_CELLS);
+
+    mesh.Vertices.clear();
+    mesh.Indices.clear();
+    mesh.Vertices.reserve((size_t)(cellsX + 1) * (cellsZ + 1));
+    mesh.Indices.reserve((size_t)cellsX * cellsZ * 6);
+    for (int j = 0; j <= cellsZ; ++j)
+    {
+        for (int i = 0; i <= cellsX; ++i)
+        {
+            float u = (float)ProxyGridX(i) / m_cellsX;
+            float v = (float)ProxyGridZ(j) / m_cellsZ;
+            Vertex vert;
+            vert.Position = { u - 0.5f, ProxyHeight(i, j), v - 0.5f };
+            vert.UV       = { u * UV_TILING, v * UV_TILING, 0.0f };
+            vert.Tangent  = { 1.0f, 0.0f, 0.0f };
+            mesh.Vertices.push_back(vert);
+        }
+    }
+    SetProxyNormals(mesh, 0, 0, cellsX, cellsZ);
+
+    for (int j = 0; j < cellsZ; ++j)
+    {
+        for (int i = 0; i < cellsX; ++i)
+        {
+            uint32_t a = (uint32_t)( j      * (cellsX + 1) + i    );
+            uint32_t b = (uint32_t)( j      * (cellsX + 1) + i + 1);
+            uint32_t c = (uint32_t)((j + 1) * (cellsX + 1) + i    );
+            uint32_t d = (uint32_t)((j + 1) * (cellsX + 1) + i + 1);
+            mesh.Indices.insert(mesh.Indices.end(), { a, c, b, b, c, d });
+        }
+    }
+
+    SetProxyBounds(mesh);
+}
+
+void TerrainQuadtree::UpdateProxyMesh(Mesh& mesh, int x0, int z0, int x1, int z1,
+                                      size_t& firstVertex, size_t& vertexCount) const
+{
+    const int cellsX = std::min(m_cellsX, PROXY_CELLS);
+    const int cellsZ = std::min(m_cellsZ, PROXY_CELLS);
+    if (mesh.Vertices.size() != (size_t)(cellsX + 1) * (cellsZ + 1))
+    {
+        BuildProxyMesh(mesh);
+        firstVertex = 0;
+        vertexCount = mesh.Vertices.size();
+        return;
+    }
+
+    // Proxy vertices whose footprint (the proxy cells around them) overlaps
+    // the edited grid vertices
+    int i0 = 0, j0 = 0, i1 = cellsX, j1 = cellsZ;
+    while (i0 < cellsX && ProxyGridX(i0 + 1) < x0) ++i0;
+    while (i1 > 0 && ProxyGridX(i1 - 1) > x1) --i1;
+    while (j0 < cellsZ && ProxyGridZ(j0 + 1) < z0) ++j0;
+    while (j1 > 0 && ProxyGridZ(j1 - 1) > z1) --j1;
+    if (i0 > i1 || j0 > j1)
+    {
+        vertexCount = 0;
+        return;
+    }
+
+    for (int j = j0; j <= j1; ++j)
+        for (int i = i0; i <= i1; ++i)
+            mesh.Vertices[(size_t)j * (cellsX + 1) + i].Position.y = ProxyHeight(i, j);
+
+    // Normals read the neighbouring heights, so one more vertex around
+    SetProxyNormals(mesh, i0 - 1, j0 - 1, i1 + 1, j1 + 1);
+    SetProxyBounds(mesh);
+
+    // Whole rows: one contiguous span per stream
+    int firstRow = std::max(j0 - 1, 0);
+    int lastRow = std::min(j1 + 1, cellsZ);
+    firstVertex = (size_t)firstRow * (cellsX + 1);
+    vertexCount = (size_t)(lastRow - firstRow + 1) * (cellsX + 1);
+}
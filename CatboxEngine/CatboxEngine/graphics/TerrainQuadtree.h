@@ -0,0 +1,152 @@
+#pragma once
+#include "Mesh.h"
+#include "Shader.h"
+#include "../resources/Camera.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Chunked level of detail for heightmap terrain (geomipmapping on a quadtree).
+//
+// The height grid is covered by a quadtree whose every node is drawn as the
+// same CHUNK_CELLS x CHUNK_CELLS grid of quads: leaves sample every height,
+// each level up samples every second one of the level below. Once per frame
+// Select() walks the tree from the camera, splitting nodes that are close
+// relative to their size, then splits further until neighbouring chunks are
+// at most one level apart. An edge that meets a coarser neighbour drops its
+// odd vertices (one of 16 index variants shared by all chunks), so edges
+// always line up and no cracks open.
+//
+// There are no per-chunk vertices: every chunk draws the same flat patch
+// grid, displaced in the vertex shaders (u_IsTerrain) from an R16 texture
+// holding one texel per grid height. Memory is the heightmap, twice (GPU and
+// the CPU copy used for bounds and collision); editing heights is a texture
+// sub-upload. Must be used on the thread holding the GL context; with the
+// render thread running, only mutate it (Build, UpdateHeights, Release)
+// while that thread is idle, since it calls Select and Draw.
+class TerrainQuadtree
+{
+public:
+    TerrainQuadtree() = default;
+    ~TerrainQuadtree();
+
+    TerrainQuadtree(const TerrainQuadtree&) = delete;
+    TerrainQuadtree& operator=(const TerrainQuadtree&) = delete;
+
+    // heights: (cellsX + 1) x (cellsZ + 1) samples in [0,1], row-major by Z.
+    // The terrain spans [-0.5,0.5] on local X/Z like the old monolithic mesh.
+    void Build(const std::vector<float>& heights, int cellsX, int cellsZ);
+    void Release();
+
+    // Overwrites width x depth grid heights starting at grid vertex (x, z)
+    void UpdateHeights(int x, int z, int width, int depth, const float* heights);
+
+    // Bilinear height in [0,1] at normalised grid position (u, v)
+    float SampleHeight(float u, float v) const;
+    // Height in [0,1] of grid vertex (gx, gz), clamped to the grid
+    float Height(int gx, int gz) const;
+
+    int GetCellsX() const { return m_cellsX; }
+    int GetCellsZ() const { return m_cellsZ; }
+
+    // Chooses the chunks to draw for a camera at eye (world space).
+    // detailScale > 1 keeps finer chunks further away; fullDetail selects every leaf.
+    void Select(const glm::mat4& world, const glm::vec3& eye, float detailScale, bool fullDetail);
+
+    // Draws the selected chunks whose bounds touch frustum (nullptr = all of
+    // them) with shader, which must have the terrain uniforms (VertexShader,
+    // DepthPrepass, ShadowMap). Returns the triangle count; drawCalls is
+    // incremented per chunk.
+    int Draw(const Shader& shader, const Frustum* frustum, int& drawCalls) const;
+
+    // Coarse stand-in mesh for bounds, picking and occlusion: at most
+    // PROXY_CELLS quads per side, each vertex at the lowest height around it
+    // so it never rises above the drawn surface. BoundsMax covers the real peaks.
+    void BuildProxyMesh(Mesh& mesh) const;
+
+    // After UpdateHeights: refreshes only the proxy vertices over grid
+    // vertices [x0,x1] x [z0,z1] and their neighbours' normals, and returns
+    // the span of mesh.Vertices to re-upload (vertexCount 0 = none). A mesh
+    // that is not this terrain's proxy is rebuilt whole.
+    void UpdateProxyMesh(Mesh& mesh, int x0, int z0, int x1, int z1, size_t& firstVertex, size_t& vertexCount) const;
+
+    // Changes whenever the selected chunks or their stitching change
+    uint64_t GetSelectionVersion() const { return m_selectionVersion; }
+
+    // Last Select()
+    int GetSelectedCount() const { return (int)m_selected.size(); }
+
+    static constexpr int CHUNK_CELLS = 32;
+    static constexpr int PROXY_CELLS = 64;
+    // A node is split while the camera is closer than this many node widths
+    static constexpr float LOD_DISTANCE = 3.0f;
+    // Heightmap sampler unit, clear of the material maps and the shadow atlas
+    static constexpr int HEIGHT_TEXTURE_UNIT = 5;
+
+private:
+    // Edge bits of the stitching variants: set = neighbour one level coarser
+    enum Edge : uint32_t
+    {
+        EdgeWest  = 1,   // -X
+        EdgeEast  = 2,   // +X
+        EdgeNorth = 4,   // -Z
+        EdgeSouth = 8    // +Z
+    };
+
+    struct Level
+    {
+        int NodesX = 0;
+        int NodesZ = 0;
+        int FirstNode = 0;  // into m_nodeMinY / m_nodeMaxY / m_split
+    };
+
+    struct Selected
+    {
+        uint32_t Node;
+        uint32_t Edges;
+        glm::vec3 WorldMin;
+        glm::vec3 WorldMax;
+    };
+
+    std::vector<uint16_t> m_heights;   // unorm16, as uploaded
+    int m_cellsX = 0;
+    int m_cellsZ = 0;
+    int m_chunkCells = CHUNK_CELLS;  // Smaller for terrains under one chunk wide
+
+    std::vector<Level> m_levels;     // 0 = leaves
+    std::vector<float> m_nodeMinY;
+    std::vector<float> m_nodeMaxY;
+    std::vector<uint8_t> m_split;
+
+    // Patch grid shared by every chunk, and one element buffer holding the
+    // 16 stitching variants back to back
+    unsigned int m_vao = 0;
+    unsigned int m_gridVBO = 0;
+    unsigned int m_ebo = 0;
+    IndexRange m_variants[16];
+    unsigned int m_heightTexture = 0;
+
+    std::vector<Selected> m_selected;
+    uint64_t m_selectionVersion = 0;
+
+    uint32_t NodeId(int level, int x, int z) const { return (uint32_t)(m_levels[level].FirstNode + z * m_levels[level].NodesX + x); }
+    bool NodeExists(int level, int x, int z) const
+    {
+        return x >= 0 && z >= 0 && x < m_levels[level].NodesX && z < m_levels[level].NodesZ;
+    }
+
+    // Proxy vertex (i, j) sits on grid vertex (ProxyGridX(i), ProxyGridZ(j))
+    int ProxyGridX(int i) const;
+    int ProxyGridZ(int j) const;
+    float ProxyHeight(int i, int j) const;
+    void SetProxyNormals(Mesh& mesh, int i0, int j0, int i1, int j1) const;
+    void SetProxyBounds(Mesh& mesh) const;
+
+    // Level of the selected node covering the level-sized cell (x, z)
+    int SelectedLevelAt(int level, int x, int z) const;
+    void CollectSelected(int level, int x, int z, std::vector<uint32_t>& out) const;
+    void DecodeNode(uint32_t node, int& level, int& x, int& z) const;
+
+    void UpdateNodeBounds(int x0, int z0, int x1, int z1);
+    void BuildPatchGrid();
+};
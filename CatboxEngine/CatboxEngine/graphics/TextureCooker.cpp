@@ -0,0 +1,416 @@
+#include "TextureCooker.h"
+#include "GraphicsSettings.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// stb_image declarations only; the implementation is in Mesh.cpp via tiny_gltf.h
+#include "../Dependencies/stb_image.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr const char* CACHE_DIR = "./cache/textures";
+    constexpr uint32_t CACHE_MAGIC = 0x58455443;  // "CTEX"
+
+    // Cooked file: this header, then Levels x (uint32 byte count, blocks)
+    struct CookedHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t Format;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Levels;
+    };
+
+    // FNV-1a, 64-bit
+    uint64_t Hash(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    uint64_t HashValue(const T& value, uint64_t hash)
+    {
+        return Hash(&value, sizeof(T), hash);
+    }
+
+    // 2x2 box filter; odd edges repeat their last texel. Normal maps are
+    // averaged as vectors and renormalised, so mips do not shorten them.
+    void Downsample(const std::vector<uint8_t>& src, int width, int height, bool isNormalMap,
+                    std::vector<uint8_t>& dst, int& outWidth, int& outHeight)
+    {
+        outWidth = std::max(1, width / 2);
+        outHeight = std::max(1, height / 2);
+        dst.resize((size_t)outWidth * outHeight * 4);
+
+        for (int y = 0; y < outHeight; ++y)
+        {
+            for (int x = 0; x < outWidth; ++x)
+            {
+                const int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                const int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+                const uint8_t* taps[4] = {
+                    &src[((size_t)y0 * width + x0) * 4], &src[((size_t)y0 * width + x1) * 4],
+                    &src[((size_t)y1 * width + x0) * 4], &src[((size_t)y1 * width + x1) * 4]
+                };
+                uint8_t* out = &dst[((size_t)y * outWidth + x) * 4];
+
+                if (isNormalMap)
+                {
+                    float n[3] = {};
+                    for (const uint8_t* tap : taps)
+                        for (int c = 0; c < 3; ++c)
+                            n[c] += tap[c] / 127.5f - 1.0f;
+                    float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                    if (length < 1e-6f)
+                    {
+                        n[0] = n[1] = 0.0f;
+                        n[2] = length = 1.0f;
+                    }
+                    for (int c = 0; c < 3; ++c)
+                        out[c] = (uint8_t)std::lround((n[c] / length * 0.5f + 0.5f) * 255.0f);
+                    out[3] = 255;
+                }
+                else
+                {
+                    for (int c = 0; c < 4; ++c)
+                        out[c] = (uint8_t)((taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c] + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+TextureCooker& TextureCooker::Instance()
+{
+    static TextureCooker inst;
+    return inst;
+}
+
+TextureCooker::~TextureCooker()
+{
+    Shutdown();
+}
+
+unsigned int TextureCooker::LoadFile(const std::string& path, TextureUsage usage)
+{
+    // Identify the file by path, size and timestamp: a hit must not decode it
+    uint64_t source = Hash(path.data(), path.size());
+    std::error_code ec;
+    uintmax_t fileSize = fs::file_size(path, ec);
+    if (!ec)
+    {
+        source = HashValue(fileSize, source);
+        source = HashValue(fs::last_write_time(path, ec).time_since_epoch().count(), source);
+    }
+
+    uint64_t key = MakeKey(source, usage);
+    if (GraphicsSettings::Instance().CompressTextures)
+    {
+        if (unsigned int tex = UploadCooked(key))
+            return tex;
+    }
+
+    int width, height, channels;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!data) return 0;
+
+    unsigned int tex = UploadAndCook(key, data, width, height, usage);
+    stbi_image_free(data);
+    return tex;
+}
+
+unsigned int TextureCooker::LoadEncoded(const uint8_t* bytes, size_t size, TextureUsage usage)
+{
+    uint64_t key = MakeKey(Hash(bytes, size), usage);
+    if (GraphicsSettings::Instance().CompressTextures)
+    {
+        if (unsigned int tex = UploadCooked(key))
+            return tex;
+    }
+
+    int width, height, channels;
+    unsigned char* data = stbi_load_from_memory(bytes, (int)size, &width, &height, &channels, 4);
+    if (!data) return 0;
+
+    unsigned int tex = UploadAndCook(key, data, width, height, usage);
+    stbi_image_free(data);
+    return tex;
+}
+
+unsigned int TextureCooker::LoadPixels(const uint8_t* pixels, int width, int height, int channels, TextureUsage usage)
+{
+    if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        return 0;
+
+    const size_t texels = (size_t)width * height;
+    uint64_t source = HashValue(channels, HashValue(height, HashValue(width, Hash(pixels, texels * channels))));
+    uint64_t key = MakeKey(source, usage);
+    if (GraphicsSettings::Instance().CompressTextures)
+    {
+        if (unsigned int tex = UploadCooked(key))
+            return tex;
+    }
+
+    if (channels == 4)
+        return UploadAndCook(key, pixels, width, height, usage);
+
+    // Grey, grey + alpha or RGB to RGBA
+    std::vector<uint8_t> rgba(texels * 4);
+    for (size_t i = 0; i < texels; ++i)
+    {
+        const uint8_t* in = pixels + i * channels;
+        uint8_t* out = &rgba[i * 4];
+        out[0] = in[0];
+        out[1] = channels >= 3 ? in[1] : in[0];
+        out[2] = channels >= 3 ? in[2] : in[0];
+        out[3] = channels == 2 ? in[1] : (channels == 4 ? in[3] : 255);
+    }
+    return UploadAndCook(key, rgba.data(), width, height, usage);
+}
+
+void TextureCooker::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+uint64_t TextureCooker::MakeKey(uint64_t sourceHash, TextureUsage usage)
+{
+    const auto& settings = GraphicsSettings::Instance();
+    uint64_t key = HashValue(sourceHash, 14695981039346656037ull);
+    key = HashValue((uint32_t)usage, key);
+    key = HashValue(settings.HighQualityCompression, key);
+    key = HashValue(IsS3TCSupported(), key);
+    return HashValue(COOK_VERSION, key);
+}
+
+std::string TextureCooker::GetCachePath(uint64_t key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.ctex", (unsigned long long)key);
+    return std::string(CACHE_DIR) + "/" + name;
+}
+
+bool TextureCooker::IsS3TCSupported()
+{
+    if (m_s3tcSupported < 0)
+    {
+        m_s3tcSupported = 0;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i)
+        {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0)
+            {
+                m_s3tcSupported = 1;
+                break;
+            }
+        }
+    }
+    return m_s3tcSupported == 1;
+}
+
+BlockCompression::Format TextureCooker::ChooseFormat(const uint8_t* rgba, int width, int height, TextureUsage usage)
+{
+    using BlockCompression::Format;
+    if (usage == TextureUsage::Normal)
+        return Format::BC5;
+    if (usage == TextureUsage::Mask)
+        return Format::BC4;
+
+    // BPTC is core since GL 4.2; the S3TC formats are an extension
+    if (GraphicsSettings::Instance().HighQualityCompression || !IsS3TCSupported())
+        return Format::BC7;
+
+    const size_t texels = (size_t)width * height;
+    for (size_t i = 0; i < texels; ++i)
+    {
+        if (rgba[i * 4 + 3] != 255)
+            return Format::BC3;
+    }
+    return Format::BC1;
+}
+
+unsigned int TextureCooker::UploadCooked(uint64_t key)
+{
+    std::ifstream in(GetCachePath(key), std::ios::binary);
+    if (!in)
+        return 0;
+
+    CookedHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.Magic != CACHE_MAGIC || header.Version != COOK_VERSION || header.Levels == 0)
+    {
+        return 0;
+    }
+
+    auto format = static_cast<BlockCompression::Format>(header.Format);
+    auto& settings = GraphicsSettings::Instance();
+    uint32_t levels = settings.EnableMipmaps ? header.Levels : 1;
+
+    unsigned int tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+
+    int width = (int)header.Width, height = (int)header.Height;
+    std::vector<uint8_t> blocks;
+    for (uint32_t level = 0; level < levels; ++level)
+    {
+        uint32_t size = 0;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!in || size != BlockCompression::GetImageBytes(format, width, height))
+        {
+            std::cerr << "TextureCooker: corrupt cache file " << GetCachePath(key) << std::endl;
+            glDeleteTextures(1, &tex);
+            return 0;
+        }
+        blocks.resize(size);
+        in.read(reinterpret_cast<char*>(blocks.data()), size);
+
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, BlockCompression::GetGLFormat(format),
+                               width, height, 0, (GLsizei)size, blocks.data());
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    settings.ApplyToTexture(tex);
+    return tex;
+}
+
+unsigned int TextureCooker::UploadAndCook(uint64_t key, const uint8_t* rgba, int width, int height, TextureUsage usage)
+{
+    unsigned int tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+
+    auto& settings = GraphicsSettings::Instance();
+    if (settings.EnableMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    settings.ApplyToTexture(tex);
+
+    if (!settings.CompressTextures)
+        return tex;
+
+    CookJob job;
+    job.Key = key;
+    job.Format = ChooseFormat(rgba, width, height, usage);
+    job.Width = width;
+    job.Height = height;
+    job.Pixels.assign(rgba, rgba + (size_t)width * height * 4);
+    job.IsNormalMap = usage == TextureUsage::Normal;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_quit || !m_queued.insert(key).second)
+            return tex;
+        m_queue.push_back(std::move(job));
+        if (!m_thread.joinable())
+            m_thread = std::thread(&TextureCooker::WorkerLoop, this);
+    }
+    m_wake.notify_one();
+    return tex;
+}
+
+void TextureCooker::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_wake.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+        if (m_quit)
+            return;
+
+        CookJob job = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+
+        Cook(job, GetCachePath(job.Key));
+
+        lock.lock();
+        m_queued.erase(job.Key);
+    }
+}
+
+void TextureCooker::Cook(const CookJob& job, const std::string& path)
+{
+    std::error_code ec;
+    fs::create_directories(CACHE_DIR, ec);
+
+    // Written to a temporary name and renamed, so a reader never sees half a file
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "TextureCooker: cannot write " << tempPath << std::endl;
+        return;
+    }
+
+    uint32_t levels = 1;
+    for (int size = std::max(job.Width, job.Height); size > 1; size /= 2)
+        ++levels;
+
+    CookedHeader header = { CACHE_MAGIC, COOK_VERSION, (uint32_t)job.Format,
+                            (uint32_t)job.Width, (uint32_t)job.Height, levels };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<uint8_t> mip = job.Pixels, next, blocks;
+    int width = job.Width, height = job.Height;
+    for (uint32_t level = 0; level < levels; ++level)
+    {
+        BlockCompression::EncodeImage(job.Format, mip.data(), width, height, blocks);
+        uint32_t size = (uint32_t)blocks.size();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(blocks.data()), size);
+
+        if (level + 1 < levels)
+        {
+            Downsample(mip, width, height, job.IsNormalMap, next, width, height);
+            mip.swap(next);
+        }
+    }
+
+    out.close();
+    if (!out)
+    {
+        std::cerr << "TextureCooker: failed writing " << tempPath << std::endl;
+        fs::remove(tempPath, ec);
+        return;
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::cerr << "TextureCooker: cannot rename " << tempPath << ": " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "BlockCompression.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// What a texture holds, which decides its compressed format
+enum class TextureUsage
+{
+    Color,   // BC1, BC3 with alpha, BC7 in high quality
+    Normal,  // BC5: x and y only, shaders rebuild z
+    Mask     // BC4: the red channel (specular, roughness)
+};
+
+// Loads textures as block-compressed mip chains cooked on the CPU.
+//
+// A cooked texture lives in ./cache/textures, keyed by its source (path, size
+// and timestamp, or a hash of in-memory bytes), usage and format options. On a
+// cache hit every mip goes straight to glCompressedTexImage2D: no decode, no
+// glGenerateMipmap. On a miss the image is uploaded uncompressed as before and
+// a cook job is queued on a background thread, so the next load is a hit.
+//
+// Load* calls must be made on the thread holding the GL context and return 0
+// if the image cannot be decoded.
+class TextureCooker
+{
+public:
+    static TextureCooker& Instance();
+
+    TextureCooker(const TextureCooker&) = delete;
+    TextureCooker& operator=(const TextureCooker&) = delete;
+
+    unsigned int LoadFile(const std::string& path, TextureUsage usage);
+
+    // An encoded image (PNG, JPG, ...) in memory, e.g. embedded in a model file
+    unsigned int LoadEncoded(const uint8_t* bytes, size_t size, TextureUsage usage);
+
+    // Decoded pixels with 1-4 channels per texel, rows top to bottom
+    unsigned int LoadPixels(const uint8_t* pixels, int width, int height, int channels, TextureUsage usage);
+
+    // Drops queued cook jobs, waits for the one running and joins the thread
+    void Shutdown();
+
+private:
+    TextureCooker() = default;
+    ~TextureCooker();
+
+    struct CookJob
+    {
+        uint64_t Key;
+        BlockCompression::Format Format;
+        int Width;
+        int Height;
+        std::vector<uint8_t> Pixels;  // RGBA8
+        bool IsNormalMap;
+    };
+
+    // Cache key of a source image: also covers usage and the format options
+    uint64_t MakeKey(uint64_t sourceHash, TextureUsage usage);
+    std::string GetCachePath(uint64_t key) const;
+    bool IsS3TCSupported();
+    BlockCompression::Format ChooseFormat(const uint8_t* rgba, int width, int height, TextureUsage usage);
+
+    // Cache hit: the cooked mip chain, or 0 if there is none (or it is stale)
+    unsigned int UploadCooked(uint64_t key);
+
+    // Cache miss: uploads rgba uncompressed and queues it for cooking
+    unsigned int UploadAndCook(uint64_t key, const uint8_t* rgba, int width, int height, TextureUsage usage);
+
+    void WorkerLoop();
+    static void Cook(const CookJob& job, const std::string& path);
+
+    static constexpr uint32_t COOK_VERSION = 1;
+
+    int m_s3tcSupported = -1;  // -1 = not queried yet
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<CookJob> m_queue;
+    std::unordered_set<uint64_t> m_queued;  // Keys queued or cooking
+    bool m_quit = false;
+};
@@ -0,0 +1,170 @@
+#include "TextureManager.h"
+#include "GraphicsSettings.h"
+#include <glad/glad.h>
+#include <cstdio>
+#include <filesystem>
+
+namespace
+{
+    // FNV-1a, 64-bit
+    uint64_t HashBytes(const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Keys start with the usage: the same image cooked as colour and as a
+    // normal map are two textures
+    std::string ContentKey(uint64_t hash, const char* suffix, TextureUsage usage)
+    {
+        char key[48];
+        snprintf(key, sizeof(key), "%d#%016llx%s", (int)usage, (unsigned long long)hash, suffix);
+        return key;
+    }
+
+    // Base level size from GL, plus a third for the mip chain
+    size_t QueryTextureBytes(unsigned int texID)
+    {
+        glBindTexture(GL_TEXTURE_2D, texID);
+        int width = 0, height = 0, compressed = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+
+        size_t baseSize = (size_t)width * height * 4;
+        if (compressed)
+        {
+            int compressedSize = 0;
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+            baseSize = compressedSize;
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        bool mipmapped = GraphicsSettings::Instance().EnableMipmaps;
+        return mipmapped ? baseSize + baseSize / 3 : baseSize;
+    }
+}
+
+TextureManager& TextureManager::Instance()
+{
+    // Never destroyed: scenes held by other singletons release their
+    // entities' textures during static destruction, in no set order
+    static TextureManager* inst = new TextureManager();
+    return *inst;
+}
+
+TextureHandle TextureManager::Load(const std::string& path, TextureUsage usage)
+{
+    // "a/../b.png" and "b.png", or mixed separators, are the same file
+    std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+    std::string key = std::to_string((int)usage) + ":" + normalized;
+    return Acquire(key, [&]() { return TextureCooker::Instance().LoadFile(path, usage); });
+}
+
+TextureHandle TextureManager::LoadEncoded(const uint8_t* bytes, size_t size, TextureUsage usage)
+{
+    std::string key = ContentKey(HashBytes(bytes, size), "", usage);
+    return Acquire(key, [&]() { return TextureCooker::Instance().LoadEncoded(bytes, size, usage); });
+}
+
+TextureHandle TextureManager::LoadPixels(const uint8_t* pixels, int width, int height, int channels, TextureUsage usage)
+{
+    if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        return 0;
+
+    char shape[32];
+    snprintf(shape, sizeof(shape), ":%dx%dx%d", width, height, channels);
+    std::string key = ContentKey(HashBytes(pixels, (size_t)width * height * channels), shape, usage);
+    return Acquire(key, [&]() {
+        return TextureCooker::Instance().LoadPixels(pixels, width, height, channels, usage);
+    });
+}
+
+TextureHandle TextureManager::Acquire(const std::string& key, const std::function<unsigned int()>& load)
+{
+    // Held while loading so two loaders of one texture cannot both create it
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_keyToHandle.find(key);
+    if (it != m_keyToHandle.end())
+    {
+        m_entries[it->second].RefCount++;
+        return it->second;
+    }
+
+    TextureHandle h = load();
+    if (h == 0)
+        return 0;
+
+    Entry& e = m_entries[h];
+    e.Key = key;
+    e.RefCount = 1;
+    e.Bytes = QueryTextureBytes(h);
+    m_keyToHandle[key] = h;
+    return h;
+}
+
+void TextureManager::AddRef(TextureHandle h)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_entries.find(h);
+    if (it != m_entries.end()) it->second.RefCount++;
+}
+
+void TextureManager::Release(TextureHandle h)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_entries.find(h);
+    if (it == m_entries.end()) return;
+    if (--it->second.RefCount <= 0)
+    {
+        glDeleteTextures(1, &h);
+        m_keyToHandle.erase(it->second.Key);
+        m_entries.erase(it);
+    }
+}
+
+void TextureManager::Shutdown()
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (const auto& pair : m_entries)
+        glDeleteTextures(1, &pair.first);
+    m_entries.clear();
+    m_keyToHandle.clear();
+}
+
+size_t TextureManager::GetMemoryUsage(TextureHandle h) const
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_entries.find(h);
+    return it != m_entries.end() ? it->second.Bytes : 0;
+}
+
+size_t TextureManager::GetTotalGPUMemory() const
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    size_t total = 0;
+    for (const auto& pair : m_entries)
+        total += pair.second.Bytes;
+    return total;
+}
+
+size_t TextureManager::GetTextureCount() const
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_entries.size();
+}
+
+size_t TextureManager::GetReferenceCount() const
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    size_t total = 0;
+    for (const auto& pair : m_entries)
+        total += (size_t)pair.second.RefCount;
+    return total;
+}
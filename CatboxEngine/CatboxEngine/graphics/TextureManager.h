@@ -0,0 +1,100 @@
+#pragma once
+#include "TextureCooker.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// A texture owned by TextureManager. It is the GL texture name itself, so
+// draws bind it without a lookup; 0 = no texture.
+using TextureHandle = unsigned int;
+
+// Owns the material textures of meshes, entity overrides and the skybox.
+// Textures are shared by source: the same file, or the same in-memory image
+// bytes, loaded for the same usage returns the same handle. Every Load* that
+// returns a handle holds one reference; Release drops it and the last one
+// deletes the GL texture. Loads and releases need the GL context.
+class TextureManager
+{
+public:
+    static TextureManager& Instance();
+
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+
+    // Each returns 0 on failure
+    TextureHandle Load(const std::string& path, TextureUsage usage);
+    // Encoded image (PNG, JPG, ...) in memory, e.g. embedded in a model file
+    TextureHandle LoadEncoded(const uint8_t* bytes, size_t size, TextureUsage usage);
+    // Decoded pixels with 1-4 channels per texel
+    TextureHandle LoadPixels(const uint8_t* pixels, int width, int height, int channels, TextureUsage usage);
+
+    // Another reference to a handle the caller already holds
+    void AddRef(TextureHandle h);
+    void Release(TextureHandle h);
+
+    // Deletes every texture while the context still exists. Releases after
+    // this (objects destroyed at exit) only find nothing to drop.
+    void Shutdown();
+
+    // Memory statistics
+    size_t GetMemoryUsage(TextureHandle h) const;  // GPU bytes including mips, 0 if unknown
+    size_t GetTotalGPUMemory() const;
+    size_t GetTextureCount() const;
+    size_t GetReferenceCount() const;  // Above the texture count when textures are shared
+
+private:
+    TextureManager() = default;
+    ~TextureManager() = default;
+
+    struct Entry
+    {
+        std::string Key;
+        int RefCount = 0;
+        size_t Bytes = 0;
+    };
+
+    // Returns the texture for key with one more reference, calling load if
+    // there is none yet
+    TextureHandle Acquire(const std::string& key, const std::function<unsigned int()>& load);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, TextureHandle> m_keyToHandle;
+    std::unordered_map<TextureHandle, Entry> m_entries;
+};
+
+// One TextureManager reference that follows its holder: copies add a
+// reference, reassignment and destruction release it. The last one must be
+// dropped on the thread holding the GL context.
+class TextureRef
+{
+public:
+    TextureRef() = default;
+    // Takes over the reference returned by a Load* call
+    explicit TextureRef(TextureHandle h) : m_handle(h) {}
+    TextureRef(const TextureRef& other) : m_handle(other.m_handle)
+    {
+        if (m_handle != 0) TextureManager::Instance().AddRef(m_handle);
+    }
+    TextureRef(TextureRef&& other) noexcept : m_handle(other.m_handle) { other.m_handle = 0; }
+    TextureRef& operator=(TextureRef other) noexcept
+    {
+        std::swap(m_handle, other.m_handle);
+        return *this;
+    }
+    ~TextureRef() { Reset(); }
+
+    void Reset()
+    {
+        if (m_handle != 0) TextureManager::Instance().Release(m_handle);
+        m_handle = 0;
+    }
+
+    TextureHandle Get() const { return m_handle; }
+
+private:
+    TextureHandle m_handle = 0;
+};
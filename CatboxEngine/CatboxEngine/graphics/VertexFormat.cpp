@@ -0,0 +1,193 @@
+#include "VertexFormat.h"
+#include "Mesh.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+namespace
+{
+    uint32_t PackDirection(const Vec3& v, float w)
+    {
+        glm::vec3 d(v.x, v.y, v.z);
+        float len = glm::length(d);
+        d = len > 1e-8f ? d / len : glm::vec3(0.0f, 1.0f, 0.0f);
+        return glm::packSnorm3x10_1x2(glm::vec4(d, w));
+    }
+
+    // Normal and tangent deltas span [-2, 2]
+    uint32_t PackDirectionDelta(const std::vector<Vec3>& deltas, size_t i)
+    {
+        if (i >= deltas.size())
+            return glm::packSnorm3x10_1x2(glm::vec4(0.0f));
+        return glm::packSnorm3x10_1x2(glm::vec4(deltas[i].x, deltas[i].y, deltas[i].z, 0.0f) * 0.5f);
+    }
+}
+
+bool VertexFormat::HasSkinning(const std::vector<Vertex>& vertices)
+{
+    for (const auto& v : vertices)
+    {
+        if (v.BoneWeights[0] > 0.0f || v.BoneWeights[1] > 0.0f ||
+            v.BoneWeights[2] > 0.0f || v.BoneWeights[3] > 0.0f)
+            return true;
+    }
+    return false;
+}
+
+void VertexFormat::PackPositions(const std::vector<Vertex>& vertices, std::vector<float>& out)
+{
+    out.resize(vertices.size() * 3);
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        out[i * 3 + 0] = vertices[i].Position.x;
+        out[i * 3 + 1] = vertices[i].Position.y;
+        out[i * 3 + 2] = vertices[i].Position.z;
+    }
+}
+
+void VertexFormat::PackSurface(const std::vector<Vertex>& vertices, std::vector<PackedVertex>& out)
+{
+    out.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Vertex& v = vertices[i];
+        PackedVertex& p = out[i];
+        p.Normal  = PackDirection(v.Normal, 0.0f);
+        p.Tangent = PackDirection(v.Tangent, 1.0f);
+        p.UV[0]   = glm::packHalf1x16(v.UV.x);
+        p.UV[1]   = glm::packHalf1x16(v.UV.y);
+    }
+}
+
+void VertexFormat::PackSkin(const std::vector<Vertex>& vertices, std::vector<PackedSkin>& out)
+{
+    out.resize(vertices.size());
+    bool warned = false;
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Vertex& v = vertices[i];
+        PackedSkin& p = out[i];
+
+        float total = v.BoneWeights[0] + v.BoneWeights[1] + v.BoneWeights[2] + v.BoneWeights[3];
+        float scale = total > 0.0f ? 1.0f / total : 0.0f;
+
+        uint32_t sum = 0;
+        int largest = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+            int bone = v.BoneIndices[k];
+            if (bone < 0 || bone > (int)MaxBoneIndex)
+            {
+                if (!warned)
+                {
+                    std::cerr << "VertexFormat: bone index " << bone << " does not fit in 8 bits, clamping" << std::endl;
+                    warned = true;
+                }
+                bone = std::clamp(bone, 0, (int)MaxBoneIndex);
+            }
+            p.BoneIndices[k] = (uint8_t)bone;
+
+            float w = std::clamp(v.BoneWeights[k] * scale, 0.0f, 1.0f);
+            p.BoneWeights[k] = (uint16_t)std::lround(w * 65535.0f);
+            sum += p.BoneWeights[k];
+            if (p.BoneWeights[k] > p.BoneWeights[largest]) largest = k;
+        }
+
+        // Push rounding error onto the dominant influence so weights still sum to 1
+        if (sum > 0)
+            p.BoneWeights[largest] = (uint16_t)((int)p.BoneWeights[largest] + (65535 - (int)sum));
+    }
+}
+
+float VertexFormat::PackMorphTargets(const std::vector<MorphTarget>& targets, size_t vertexCount, std::vector<uint32_t>& out)
+{
+    size_t targetCount = std::min(targets.size(), (size_t)MaxMorphTargets);
+    if (targetCount < targets.size())
+        std::cerr << "VertexFormat: only the first " << MaxMorphTargets << " morph targets are kept" << std::endl;
+
+    float scale = 0.0f;
+    std::vector<uint32_t> counts(vertexCount, 0);
+    for (size_t t = 0; t < targetCount; ++t)
+    {
+        const MorphTarget& target = targets[t];
+        for (size_t i = 0; i < target.VertexIndices.size(); ++i)
+        {
+            if (target.VertexIndices[i] >= vertexCount)
+                continue;
+            ++counts[target.VertexIndices[i]];
+            const Vec3& d = target.PositionDeltas[i];
+            scale = std::max({ scale, std::abs(d.x), std::abs(d.y), std::abs(d.z) });
+        }
+    }
+    float invScale = scale > 0.0f ? 1.0f / scale : 0.0f;
+
+    // Prefix sum into the offset table; the deltas follow it
+    out.assign(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        out[v + 1] = out[v] + counts[v];
+    size_t header = out.size();
+    out.resize(header + (size_t)out[vertexCount] * 4);
+
+    std::vector<uint32_t> cursor(out.begin(), out.begin() + vertexCount);
+    for (size_t t = 0; t < targetCount; ++t)
+    {
+        const MorphTarget& target = targets[t];
+        for (size_t i = 0; i < target.VertexIndices.size(); ++i)
+        {
+            uint32_t v = target.VertexIndices[i];
+            if (v >= vertexCount)
+                continue;
+
+            const Vec3& d = target.PositionDeltas[i];
+            PackedMorphDelta p;
+            p.TargetPositionX = (uint32_t)t | (glm::packSnorm2x16(glm::vec2(0.0f, d.x * invScale)) & 0xFFFF0000u);
+            p.PositionYZ      = glm::packSnorm2x16(glm::vec2(d.y, d.z) * invScale);
+            p.Normal          = PackDirectionDelta(target.NormalDeltas, i);
+            p.Tangent         = PackDirectionDelta(target.TangentDeltas, i);
+
+            uint32_t* dst = &out[header + (size_t)cursor[v]++ * 4];
+            dst[0] = p.TargetPositionX;
+            dst[1] = p.PositionYZ;
+            dst[2] = p.Normal;
+            dst[3] = p.Tangent;
+        }
+    }
+    return scale;
+}
+
+void VertexFormat::BindPositionStream()
+{
+    glVertexAttribPointer(AttribPosition, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(AttribPosition);
+}
+
+void VertexFormat::BindSurfaceStream()
+{
+    // 10:10:10:2 requires size 4; the shader reads .xyz
+    glVertexAttribPointer(AttribNormal, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex),
+                          (void*)offsetof(PackedVertex, Normal));
+    glEnableVertexAttribArray(AttribNormal);
+
+    glVertexAttribPointer(AttribTangent, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex),
+                          (void*)offsetof(PackedVertex, Tangent));
+    glEnableVertexAttribArray(AttribTangent);
+
+    glVertexAttribPointer(AttribUV, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+                          (void*)offsetof(PackedVertex, UV));
+    glEnableVertexAttribArray(AttribUV);
+}
+
+void VertexFormat::BindSkinStream()
+{
+    glVertexAttribIPointer(AttribBoneIndices, 4, GL_UNSIGNED_BYTE, sizeof(PackedSkin),
+                           (void*)offsetof(PackedSkin, BoneIndices));
+    glEnableVertexAttribArray(AttribBoneIndices);
+
+    glVertexAttribPointer(AttribBoneWeights, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedSkin),
+                          (void*)offsetof(PackedSkin, BoneWeights));
+    glEnableVertexAttribArray(AttribBoneWeights);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Vertex;
+struct MorphTarget;
+
+// GPU-side vertex layouts.
+// Vertex (Mesh.h) stays the CPU authoring format used by the loaders, terrain
+// and morph targets; Mesh::Upload packs it into up to three streams:
+//
+//   stream 0  positions   float3                      12 bytes  (also used alone by depth-only passes)
+//   stream 1  surface     normal/tangent/uv, packed   12 bytes
+//   stream 2  skin        bone ids/weights, packed    12 bytes  (skinned meshes only)
+//
+// Morph targets are not a vertex stream: their deltas are packed sparsely
+// into one storage buffer (PackMorphTargets) read by Skinning.comp.
+
+// Normal, tangent and UV for one vertex
+struct PackedVertex
+{
+	uint32_t Normal;   // snorm 10:10:10:2 (GL_INT_2_10_10_10_REV), w unused
+	uint32_t Tangent;  // snorm 10:10:10:2, w = handedness
+	uint16_t UV[2];    // half float
+};
+
+// Skinning influences for one vertex
+struct PackedSkin
+{
+	uint8_t  BoneIndices[4];
+	uint16_t BoneWeights[4];  // unorm16, sum to 65535
+};
+
+// One vertex moved by one morph target
+struct PackedMorphDelta
+{
+	uint32_t TargetPositionX;  // target index (low 16 bits), position.x snorm16 (high 16 bits)
+	uint32_t PositionYZ;       // snorm16 pair; positions are scaled by Mesh::MorphPositionScale
+	uint32_t Normal;           // snorm 10:10:10:2 of delta / 2
+	uint32_t Tangent;          // snorm 10:10:10:2 of delta / 2
+};
+
+static_assert(sizeof(PackedVertex) == 12, "PackedVertex must stay tightly packed");
+static_assert(sizeof(PackedSkin) == 12, "PackedSkin must stay tightly packed");
+static_assert(sizeof(PackedMorphDelta) == 16, "PackedMorphDelta must stay tightly packed");
+
+namespace VertexFormat
+{
+    // Shader attribute locations (VertexShader.vert / ShadowMap.vert)
+    enum Attribute : uint32_t
+    {
+        AttribPosition    = 0,
+        AttribNormal      = 1,
+        AttribUV          = 2,
+        AttribTangent     = 3,
+        AttribBoneIndices = 4,
+        AttribBoneWeights = 5
+    };
+
+    constexpr uint32_t MaxBoneIndex = 255;
+    constexpr uint32_t MaxMorphTargets = 65536;
+
+    // True if any vertex carries a non-zero bone weight
+    bool HasSkinning(const std::vector<Vertex>& vertices);
+
+    void PackPositions(const std::vector<Vertex>& vertices, std::vector<float>& out);
+    void PackSurface(const std::vector<Vertex>& vertices, std::vector<PackedVertex>& out);
+    void PackSkin(const std::vector<Vertex>& vertices, std::vector<PackedSkin>& out);
+
+    // Morph deltas grouped by vertex, as raw words: vertexCount + 1 offsets
+    // (vertex v owns deltas [out[v], out[v + 1])), then the PackedMorphDelta
+    // array. Returns the position scale, the largest delta component.
+    float PackMorphTargets(const std::vector<MorphTarget>& targets, size_t vertexCount, std::vector<uint32_t>& out);
+
+    // Attribute setup for the currently bound VAO / GL_ARRAY_BUFFER
+    void BindPositionStream();
+    void BindSurfaceStream();
+    void BindSkinStream();
+}
@@ -0,0 +1,173 @@
+#include "ForwardPass.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// SSBO binding points used by FragmentShader.frag (lights at LightBuffer::BINDING)
+namespace
+{
+    constexpr GLuint CLUSTER_BUFFER_BINDING = 3;
+    constexpr GLuint CLUSTER_INDEX_BUFFER_BINDING = 4;
+}
+
+ForwardPass::~ForwardPass()
+{
+    Release();
+}
+
+void ForwardPass::Release()
+{
+    if (m_clusterBuffer != 0) { glDeleteBuffers(1, &m_clusterBuffer); m_clusterBuffer = 0; }
+    if (m_indexBuffer != 0) { glDeleteBuffers(1, &m_indexBuffer); m_indexBuffer = 0; }
+}
+
+void ForwardPass::BuildClusterBounds(const glm::mat4& proj, float nearPlane, float farPlane)
+{
+    if (!m_bounds.empty() && proj == m_boundsProj && nearPlane == m_boundsNear && farPlane == m_boundsFar)
+        return;
+
+    m_boundsProj = proj;
+    m_boundsNear = nearPlane;
+    m_boundsFar = farPlane;
+    m_bounds.resize(CLUSTER_COUNT);
+
+    // View-space rays through the tile corners, scaled so that -z = 1
+    glm::mat4 invProj = glm::inverse(proj);
+    auto cornerRay = [&](int x, int y)
+    {
+        glm::vec4 ndc(2.0f * x / CLUSTER_X - 1.0f, 2.0f * y / CLUSTER_Y - 1.0f, -1.0f, 1.0f);
+        glm::vec4 p = invProj * ndc;
+        glm::vec3 v = glm::vec3(p) / p.w;
+        return v / -v.z;
+    };
+
+    for (int z = 0; z < CLUSTER_Z; ++z)
+    {
+        float d0 = nearPlane * std::pow(farPlane / nearPlane, (float)z / CLUSTER_Z);
+        float d1 = nearPlane * std::pow(farPlane / nearPlane, (float)(z + 1) / CLUSTER_Z);
+        for (int y = 0; y < CLUSTER_Y; ++y)
+        {
+            for (int x = 0; x < CLUSTER_X; ++x)
+            {
+                ClusterBounds& b = m_bounds[(z * CLUSTER_Y + y) * CLUSTER_X + x];
+                b.Min = glm::vec3(FLT_MAX);
+                b.Max = glm::vec3(-FLT_MAX);
+                for (int c = 0; c < 4; ++c)
+                {
+                    glm::vec3 ray = cornerRay(x + (c & 1), y + (c >> 1));
+                    b.Min = glm::min(b.Min, glm::min(ray * d0, ray * d1));
+                    b.Max = glm::max(b.Max, glm::max(ray * d0, ray * d1));
+                }
+            }
+        }
+    }
+}
+
+int ForwardPass::SliceForDepth(float viewDepth) const
+{
+    if (viewDepth <= m_boundsNear)
+        return 0;
+    int slice = (int)std::floor(std::log(viewDepth) * m_sliceScale + m_sliceBias);
+    return std::clamp(slice, 0, CLUSTER_Z - 1);
+}
+
+void ForwardPass::AssignLights(const LightBuffer& lights, const Camera& camera, const glm::mat4& view,
+                               const glm::mat4& proj, int width, int height)
+{
+    float nearPlane = camera.Near;
+    float farPlane = std::max(camera.Far, nearPlane * 1.001f);
+    BuildClusterBounds(proj, nearPlane, farPlane);
+
+    float logRatio = std::log(farPlane / nearPlane);
+    m_sliceScale = CLUSTER_Z / logRatio;
+    m_sliceBias = -CLUSTER_Z * std::log(nearPlane) / logRatio;
+    m_tilePixels = glm::vec2((float)std::max(width, 1) / CLUSTER_X, (float)std::max(height, 1) / CLUSTER_Y);
+
+    m_pairs.clear();
+    uint32_t globalCount = 0;
+    for (size_t l = 0; l < lights.GetCount(); ++l)
+    {
+        if (lights.IsGlobal(l))
+        {
+            ++globalCount;
+            continue;
+        }
+
+        const glm::vec4& positionRange = lights.GetLight(l).PositionRange;
+        float radius = positionRange.w;
+        glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(positionRange), 1.0f));
+
+        glm::vec2 ndcMin, ndcMax;
+        if (!LightBuffer::ProjectSphere(center, radius, proj, nearPlane, farPlane, ndcMin, ndcMax))
+            continue;
+
+        // Candidate box in the grid, then an exact sphere test per cluster
+        int x0 = std::clamp((int)((ndcMin.x * 0.5f + 0.5f) * CLUSTER_X), 0, CLUSTER_X - 1);
+        int x1 = std::clamp((int)((ndcMax.x * 0.5f + 0.5f) * CLUSTER_X), 0, CLUSTER_X - 1);
+        int y0 = std::clamp((int)((ndcMin.y * 0.5f + 0.5f) * CLUSTER_Y), 0, CLUSTER_Y - 1);
+        int y1 = std::clamp((int)((ndcMax.y * 0.5f + 0.5f) * CLUSTER_Y), 0, CLUSTER_Y - 1);
+        int z0 = SliceForDepth(-center.z - radius);
+        int z1 = SliceForDepth(-center.z + radius);
+
+        float radiusSq = radius * radius;
+        for (int z = z0; z <= z1; ++z)
+        {
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    uint32_t cluster = (uint32_t)((z * CLUSTER_Y + y) * CLUSTER_X + x);
+                    const ClusterBounds& b = m_bounds[cluster];
+                    glm::vec3 closest = glm::clamp(center, b.Min, b.Max);
+                    glm::vec3 d = closest - center;
+                    if (glm::dot(d, d) <= radiusSq)
+                        m_pairs.emplace_back(cluster, (uint32_t)l);
+                }
+            }
+        }
+    }
+
+    // Counting sort by cluster into one flat index list
+    m_clusters.assign(CLUSTER_COUNT + 1, glm::uvec2(0));
+    for (const auto& pair : m_pairs)
+        m_clusters[pair.first].y++;
+    m_clusters[CLUSTER_COUNT].y = globalCount;
+
+    uint32_t offset = 0;
+    for (glm::uvec2& cluster : m_clusters)
+    {
+        cluster.x = offset;
+        offset += cluster.y;
+        cluster.y = 0;
+    }
+    m_indices.resize(offset);
+    m_clusterLightRefs = (int)m_pairs.size();
+
+    for (const auto& pair : m_pairs)
+    {
+        glm::uvec2& cluster = m_clusters[pair.first];
+        m_indices[cluster.x + cluster.y++] = pair.second;
+    }
+    for (size_t l = 0; l < lights.GetCount(); ++l)
+    {
+        if (lights.IsGlobal(l))
+        {
+            glm::uvec2& global = m_clusters[CLUSTER_COUNT];
+            m_indices[global.x + global.y++] = (uint32_t)l;
+        }
+    }
+
+    StreamBuffer& stream = StreamBuffer::Instance();
+    m_clusterRange = stream.UploadStorage(m_clusterBuffer, m_clusters.data(), m_clusters.size() * sizeof(glm::uvec2));
+    m_indexRange = stream.UploadStorage(m_indexBuffer, m_indices.data(), m_indices.size() * sizeof(uint32_t));
+}
+
+void ForwardPass::Bind(const Shader& shader) const
+{
+    StreamBuffer::BindStorage(CLUSTER_BUFFER_BINDING, m_clusterRange);
+    StreamBuffer::BindStorage(CLUSTER_INDEX_BUFFER_BINDING, m_indexRange);
+
+    // xy = cluster tile size in pixels, z/w = depth slice scale/bias
+    shader.SetVec4("u_ClusterParams", m_tilePixels.x, m_tilePixels.y, m_sliceScale, m_sliceBias);
+}
@@ -1,7 +1,78 @@
 #pragma once
+#include "../Shader.h"
+#include "../LightBuffer.h"
+#include "../StreamBuffer.h"
+#include "../../resources/Camera.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
+// Clustered light culling for the forward path (FragmentShader.frag).
+//
+// The view frustum is cut into CLUSTER_X x CLUSTER_Y screen tiles and
+// CLUSTER_Z depth slices spaced exponentially between the near and far
+// planes. Each frame the lights' attenuation spheres are tested against the
+// view-space box of every cluster they could touch, and the result is a flat
+// index list per cluster in shader storage. A fragment finds its cluster
+// from gl_FragCoord and its view depth and only evaluates that list, plus
+// the lights that reach everywhere (directional / unattenuated).
 class ForwardPass
 {
 public:
-    
+    ForwardPass() = default;
+    ~ForwardPass();
+
+    ForwardPass(const ForwardPass&) = delete;
+    ForwardPass& operator=(const ForwardPass&) = delete;
+
+    void Release();
+
+    // Rebuilds the cluster light lists for this camera and uploads them
+    void AssignLights(const LightBuffer& lights, const Camera& camera, const glm::mat4& view,
+                      const glm::mat4& proj, int width, int height);
+
+    // Binds the cluster buffers and sets the lookup uniforms on shader
+    void Bind(const Shader& shader) const;
+
+    // Last frame: light references summed over all clusters
+    int GetClusterLightRefs() const { return m_clusterLightRefs; }
+
+    // Grid size; must match CLUSTER_X/Y/Z in FragmentShader.frag
+    static constexpr int CLUSTER_X = 16;
+    static constexpr int CLUSTER_Y = 9;
+    static constexpr int CLUSTER_Z = 24;
+    static constexpr int CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+private:
+    struct ClusterBounds
+    {
+        glm::vec3 Min;
+        glm::vec3 Max;
+    };
+
+    // This frame's lists in the stream buffer; the buffers below only when it is full
+    StreamRange m_clusterRange;
+    StreamRange m_indexRange;
+    unsigned int m_clusterBuffer = 0;
+    unsigned int m_indexBuffer = 0;
+
+    // View-space cluster boxes; only depend on the projection and screen size
+    std::vector<ClusterBounds> m_bounds;
+    glm::mat4 m_boundsProj{ 0.0f };
+    float m_boundsNear = 0.0f;
+    float m_boundsFar = 0.0f;
+
+    std::vector<glm::uvec2> m_clusters;                      // offset, count; last entry = global lights
+    std::vector<uint32_t> m_indices;
+    std::vector<std::pair<uint32_t, uint32_t>> m_pairs;      // (cluster, light) before sorting
+    int m_clusterLightRefs = 0;
+
+    // Depth slice lookup: slice = log(viewDepth) * m_sliceScale + m_sliceBias
+    float m_sliceScale = 0.0f;
+    float m_sliceBias = 0.0f;
+    glm::vec2 m_tilePixels{ 1.0f };
+
+    void BuildClusterBounds(const glm::mat4& proj, float nearPlane, float farPlane);
+    int SliceForDepth(float viewDepth) const;
 };
@@ -0,0 +1,114 @@
+#include "GBufferPass.h"
+#include <glad/glad.h>
+#include <iostream>
+
+namespace
+{
+    unsigned int CreateTarget(int width, int height, GLenum internalFormat, GLenum format, GLenum type)
+    {
+        unsigned int texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+
+        // Read back one texel per pixel
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+}
+
+GBufferPass::~GBufferPass()
+{
+    Release();
+}
+
+bool GBufferPass::Initialize()
+{
+    m_shader.Initialize("./shaders/VertexShader.vert", "./shaders/gbuffer.frag");
+    if (m_shader.GetProgram() == 0)
+    {
+        std::cerr << "GBufferPass: failed to compile shaders.\n";
+        return false;
+    }
+    return true;
+}
+
+void GBufferPass::Release()
+{
+    ReleaseTargets();
+}
+
+bool GBufferPass::CreateTargets(int width, int height)
+{
+    ReleaseTargets();
+    m_width = width;
+    m_height = height;
+
+    m_albedo = CreateTarget(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+    m_normal = CreateTarget(width, height, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+    m_material = CreateTarget(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+    m_depth = CreateTarget(width, height, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_albedo, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_normal, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, m_material, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depth, 0);
+
+    const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+    glDrawBuffers(3, drawBuffers);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!complete)
+    {
+        std::cerr << "G-buffer framebuffer incomplete!" << std::endl;
+        ReleaseTargets();
+    }
+    return complete;
+}
+
+void GBufferPass::ReleaseTargets()
+{
+    if (m_fbo != 0) { glDeleteFramebuffers(1, &m_fbo); m_fbo = 0; }
+    if (m_albedo != 0) { glDeleteTextures(1, &m_albedo); m_albedo = 0; }
+    if (m_normal != 0) { glDeleteTextures(1, &m_normal); m_normal = 0; }
+    if (m_material != 0) { glDeleteTextures(1, &m_material); m_material = 0; }
+    if (m_depth != 0) { glDeleteTextures(1, &m_depth); m_depth = 0; }
+    m_width = 0;
+    m_height = 0;
+}
+
+bool GBufferPass::Begin(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+    if ((m_fbo == 0 || width != m_width || height != m_height) && !CreateTargets(width, height))
+        return false;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glViewport(0, 0, width, height);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+
+    // Zero normal marks pixels no surface was written to
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClearDepth(1.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    return true;
+}
+
+void GBufferPass::BindTextures(int firstUnit) const
+{
+    const unsigned int textures[] = { m_albedo, m_normal, m_material, m_depth };
+    for (int i = 0; i < 4; ++i)
+    {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+    }
+}
@@ -1,7 +1,53 @@
 #pragma once
+#include "../Shader.h"
 
+// Geometry stage of the deferred path: opaque surfaces write their material
+// inputs into screen-sized targets instead of being lit straight away.
+//
+//   RT0  RGBA8    albedo.rgb
+//   RT1  RGBA16F  world normal.xyz
+//   RT2  RGBA8    specular.rgb, shininess / 256
+//   depth 32F     world position is rebuilt from it by LightingPass
+//
+// Draws use VertexShader.vert + gbuffer.frag, so skinning and the packed
+// vertex streams work exactly as on the forward path.
 class GBufferPass
 {
 public:
-    
+    GBufferPass() = default;
+    ~GBufferPass();
+
+    GBufferPass(const GBufferPass&) = delete;
+    GBufferPass& operator=(const GBufferPass&) = delete;
+
+    // Compiles the shader; targets are created on the first Begin()
+    bool Initialize();
+    void Release();
+
+    // Binds and clears the targets, recreating them when the size changed
+    bool Begin(int width, int height);
+
+    // Albedo, normal, material and depth on firstUnit .. firstUnit + 3
+    void BindTextures(int firstUnit) const;
+
+    const Shader& GetShader() const { return m_shader; }
+    unsigned int GetFBO() const { return m_fbo; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+    // Shininess is stored as shininess / SHININESS_SCALE in an 8-bit channel
+    static constexpr float SHININESS_SCALE = 256.0f;
+
+private:
+    Shader m_shader;
+    unsigned int m_fbo = 0;
+    unsigned int m_albedo = 0;
+    unsigned int m_normal = 0;
+    unsigned int m_material = 0;
+    unsigned int m_depth = 0;
+    int m_width = 0;
+    int m_height = 0;
+
+    bool CreateTargets(int width, int height);
+    void ReleaseTargets();
 };
@@ -0,0 +1,155 @@
+#include "LightingPass.h"
+#include "GBufferPass.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+
+// SSBO binding points used by lighting.frag (lights at LightBuffer::BINDING)
+namespace
+{
+    constexpr GLuint TILE_BUFFER_BINDING = 1;
+    constexpr GLuint INDEX_BUFFER_BINDING = 2;
+}
+
+LightingPass::~LightingPass()
+{
+    Release();
+}
+
+bool LightingPass::Initialize()
+{
+    m_shader.Initialize("./shaders/lighting.vert", "./shaders/lighting.frag");
+    if (m_shader.GetProgram() == 0)
+    {
+        std::cerr << "LightingPass: failed to compile shaders.\n";
+        return false;
+    }
+
+    // The full-screen triangle comes from gl_VertexID, but core profile still wants a VAO
+    glGenVertexArrays(1, &m_vao);
+    return true;
+}
+
+void LightingPass::Release()
+{
+    if (m_vao != 0) { glDeleteVertexArrays(1, &m_vao); m_vao = 0; }
+    if (m_tileBuffer != 0) { glDeleteBuffers(1, &m_tileBuffer); m_tileBuffer = 0; }
+    if (m_indexBuffer != 0) { glDeleteBuffers(1, &m_indexBuffer); m_indexBuffer = 0; }
+}
+
+void LightingPass::BinLights(const LightBuffer& lights, const Camera& camera, const glm::mat4& view,
+                             const glm::mat4& proj, int width, int height)
+{
+    int tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    int tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    int tileCount = tilesX * tilesY;
+
+    // Screen rectangle of each attenuation sphere
+    m_lightBins.assign(lights.GetCount(), LightBin());
+    for (size_t l = 0; l < lights.GetCount(); ++l)
+    {
+        LightBin& bin = m_lightBins[l];
+        bin.Global = lights.IsGlobal(l);
+        if (bin.Global)
+            continue;
+
+        const glm::vec4& positionRange = lights.GetLight(l).PositionRange;
+        glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(positionRange), 1.0f));
+        glm::vec2 ndcMin, ndcMax;
+        if (!LightBuffer::ProjectSphere(center, positionRange.w, proj, camera.Near, camera.Far, ndcMin, ndcMax))
+            continue;
+
+        // NDC -> pixels (bottom-left origin, like gl_FragCoord) -> tiles
+        bin.MinX = std::max((int)((ndcMin.x * 0.5f + 0.5f) * width) / TILE_SIZE, 0);
+        bin.MinY = std::max((int)((ndcMin.y * 0.5f + 0.5f) * height) / TILE_SIZE, 0);
+        bin.MaxX = std::min((int)((ndcMax.x * 0.5f + 0.5f) * width) / TILE_SIZE, tilesX - 1);
+        bin.MaxY = std::min((int)((ndcMax.y * 0.5f + 0.5f) * height) / TILE_SIZE, tilesY - 1);
+    }
+
+    // Count, prefix-sum, fill: one flat index list with a range per tile
+    m_tiles.assign(tileCount + 1, glm::uvec2(0));
+    for (const LightBin& bin : m_lightBins)
+    {
+        if (bin.Global)
+        {
+            m_tiles[tileCount].y++;
+            continue;
+        }
+        for (int y = bin.MinY; y <= bin.MaxY; ++y)
+            for (int x = bin.MinX; x <= bin.MaxX; ++x)
+                m_tiles[y * tilesX + x].y++;
+    }
+
+    uint32_t offset = 0;
+    for (glm::uvec2& tile : m_tiles)
+    {
+        tile.x = offset;
+        offset += tile.y;
+        tile.y = 0;
+    }
+    m_indices.resize(offset);
+    m_tileLightRefs = (int)offset;
+
+    for (size_t l = 0; l < m_lightBins.size(); ++l)
+    {
+        const LightBin& bin = m_lightBins[l];
+        if (bin.Global)
+        {
+            glm::uvec2& tile = m_tiles[tileCount];
+            m_indices[tile.x + tile.y++] = (uint32_t)l;
+            continue;
+        }
+        for (int y = bin.MinY; y <= bin.MaxY; ++y)
+        {
+            for (int x = bin.MinX; x <= bin.MaxX; ++x)
+            {
+                glm::uvec2& tile = m_tiles[y * tilesX + x];
+                m_indices[tile.x + tile.y++] = (uint32_t)l;
+            }
+        }
+    }
+}
+
+void LightingPass::Execute(const GBufferPass& gbuffer, const LightBuffer& lights,
+                           const ShadowTileTable& shadows, unsigned int shadowAtlas,
+                           const Camera& camera, const glm::mat4& view, const glm::mat4& proj)
+{
+    if (m_shader.GetProgram() == 0 || gbuffer.GetFBO() == 0)
+        return;
+
+    int width = gbuffer.GetWidth();
+    int height = gbuffer.GetHeight();
+    BinLights(lights, camera, view, proj, width, height);
+
+    StreamBuffer& stream = StreamBuffer::Instance();
+    StreamBuffer::BindStorage(TILE_BUFFER_BINDING,
+                              stream.UploadStorage(m_tileBuffer, m_tiles.data(), m_tiles.size() * sizeof(glm::uvec2)));
+    StreamBuffer::BindStorage(INDEX_BUFFER_BINDING,
+                              stream.UploadStorage(m_indexBuffer, m_indices.data(), m_indices.size() * sizeof(uint32_t)));
+    lights.Bind();
+
+    m_shader.Use();
+    gbuffer.BindTextures(GBUFFER_TEXTURE_UNIT);
+    m_shader.SetInt("u_GAlbedo", GBUFFER_TEXTURE_UNIT);
+    m_shader.SetInt("u_GNormal", GBUFFER_TEXTURE_UNIT + 1);
+    m_shader.SetInt("u_GMaterial", GBUFFER_TEXTURE_UNIT + 2);
+    m_shader.SetInt("u_GDepth", GBUFFER_TEXTURE_UNIT + 3);
+    shadows.Upload(m_shader, shadowAtlas, SHADOW_ATLAS_TEXTURE_UNIT);
+
+    m_shader.SetMat4("u_View", view);
+    m_shader.SetMat4("u_InvViewProj", glm::inverse(proj * view));
+    m_shader.SetVec3("u_CameraPos", camera.Position.x, camera.Position.y, camera.Position.z);
+    m_shader.SetInt("u_TilesX", (width + TILE_SIZE - 1) / TILE_SIZE);
+    m_shader.SetInt("u_GlobalTile", (int)m_tiles.size() - 1);
+
+    // Depth comes from the G-buffer via gl_FragDepth, so test nothing but keep the write
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_ALWAYS);
+    glDepthMask(GL_TRUE);
+
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    glDepthFunc(GL_LESS);
+}
@@ -1,7 +1,68 @@
 #pragma once
+#include "../Shader.h"
+#include "../LightBuffer.h"
+#include "../ShadowAtlas.h"
+#include "../../resources/Camera.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
 
+class GBufferPass;
+
+// Lighting stage of the deferred path: one full-screen triangle that shades
+// every G-buffer pixel once, for every light in the scene.
+//
+// Lights come from the frame's LightBuffer and are binned on the CPU into
+// TILE_SIZE x TILE_SIZE pixel screen tiles using the screen bounds of their
+// attenuation sphere (LightManager::ComputeLightRange). A pixel only loops
+// over its tile's list plus the lights that reach everywhere (directional /
+// unattenuated), so cost follows overlap rather than the total light count.
 class LightingPass
 {
 public:
-    
+    LightingPass() = default;
+    ~LightingPass();
+
+    LightingPass(const LightingPass&) = delete;
+    LightingPass& operator=(const LightingPass&) = delete;
+
+    bool Initialize();
+    void Release();
+
+    // Shades into the framebuffer bound by the caller (viewport must match the
+    // G-buffer) and writes scene depth, so later forward draws and the skybox
+    // depth-test against the deferred surfaces. Background pixels are left alone.
+    void Execute(const GBufferPass& gbuffer, const LightBuffer& lights,
+                 const ShadowTileTable& shadows, unsigned int shadowAtlas,
+                 const Camera& camera, const glm::mat4& view, const glm::mat4& proj);
+
+    // Last frame: light references across all screen tiles
+    int GetTileLightRefs() const { return m_tileLightRefs; }
+
+    static constexpr int TILE_SIZE = 16;  // Matches TILE_SIZE in lighting.frag
+
+    // G-buffer on GBUFFER_TEXTURE_UNIT .. +3, shadow atlas after it
+    static constexpr int GBUFFER_TEXTURE_UNIT = 0;
+    static constexpr int SHADOW_ATLAS_TEXTURE_UNIT = 4;
+
+private:
+    // Screen tiles a light touches (inclusive); global lights skip binning
+    struct LightBin
+    {
+        bool Global = false;
+        int MinX = 0, MinY = 0, MaxX = -1, MaxY = -1;
+    };
+
+    Shader m_shader;
+    unsigned int m_vao = 0;
+    unsigned int m_tileBuffer = 0;   // Used when the stream buffer is full
+    unsigned int m_indexBuffer = 0;
+
+    std::vector<LightBin> m_lightBins;
+    std::vector<glm::uvec2> m_tiles;       // offset, count into m_indices; last entry = global lights
+    std::vector<uint32_t> m_indices;
+    int m_tileLightRefs = 0;
+
+    void BinLights(const LightBuffer& lights, const Camera& camera, const glm::mat4& view,
+                   const glm::mat4& proj, int width, int height);
 };
@@ -0,0 +1,112 @@
+#include "SkinningPass.h"
+#include "../StreamBuffer.h"
+#include "../Mesh.h"
+#include "../MeshManager.h"
+#include "../../resources/Entity.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+
+// Source streams are bound as storage buffers for the dispatches only. The
+// binding points are borrowed from the lighting pass and forward clusters,
+// which bind their own buffers again before they draw.
+namespace
+{
+    constexpr GLuint POSITION_BINDING = 1;
+    constexpr GLuint SURFACE_BINDING = 2;
+    constexpr GLuint SKIN_BINDING = 3;
+    constexpr GLuint MORPH_BINDING = 4;
+
+    bool IsSkinned(const Mesh& mesh, const BonePalette& palette, size_t entityIndex)
+    {
+        return palette.GetOffset(entityIndex) >= 0 && mesh.SkinVBO != 0;
+    }
+
+    bool IsMorphed(const Mesh& mesh, const BonePalette& palette, size_t entityIndex)
+    {
+        return palette.GetMorphOffset(entityIndex) >= 0 && mesh.MorphBuffer != 0;
+    }
+}
+
+SkinningPass::~SkinningPass()
+{
+    Release();
+}
+
+bool SkinningPass::Initialize()
+{
+    m_shader.InitializeCompute("./shaders/Skinning.comp");
+    if (m_shader.GetProgram() == 0)
+    {
+        std::cerr << "SkinningPass: failed to compile shader.\n";
+        return false;
+    }
+    return true;
+}
+
+void SkinningPass::Release()
+{
+    if (m_buffer != 0) { glDeleteBuffers(1, &m_buffer); m_buffer = 0; }
+    m_offsets.clear();
+    m_vertexCount = 0;
+}
+
+void SkinningPass::Execute(const EntityManager& entityManager, size_t count, const BonePalette& palette)
+{
+    const auto& entities = entityManager.GetAll();
+    count = std::min(count, entities.size());
+
+    // Without the compute shader skinned meshes stay in their bind pose
+    m_offsets.assign(count, -1);
+    m_vertexCount = 0;
+    if (m_shader.GetProgram() != 0)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (palette.GetOffset(i) < 0 && palette.GetMorphOffset(i) < 0)
+                continue;
+
+            Mesh* mesh = MeshManager::Instance().GetMesh(entities[i].MeshHandle);
+            if (!mesh || mesh->Vertices.empty() || (!IsSkinned(*mesh, palette, i) && !IsMorphed(*mesh, palette, i)))
+                continue;
+
+            m_offsets[i] = (int)m_vertexCount;
+            m_vertexCount += mesh->Vertices.size();
+        }
+    }
+
+    StreamBuffer::SpecifyStorage(m_buffer, nullptr, m_vertexCount * sizeof(GPUSkinnedVertex));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, m_buffer);
+    if (m_vertexCount == 0)
+        return;
+
+    m_shader.Use();
+    palette.Bind();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (m_offsets[i] < 0)
+            continue;
+
+        const Mesh* mesh = MeshManager::Instance().GetMesh(entities[i].MeshHandle);
+        int vertexCount = (int)mesh->Vertices.size();
+        bool skinned = IsSkinned(*mesh, palette, i);
+        bool morphed = IsMorphed(*mesh, palette, i);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, POSITION_BINDING, mesh->PositionVBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SURFACE_BINDING, mesh->VBO);
+        if (skinned)
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SKIN_BINDING, mesh->SkinVBO);
+        if (morphed)
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MORPH_BINDING, mesh->MorphBuffer);
+        m_shader.SetInt("u_VertexCount", vertexCount);
+        m_shader.SetBool("u_Skinned", skinned);
+        m_shader.SetInt("u_BoneOffset", palette.GetOffset(i));
+        m_shader.SetBool("u_DualQuat", palette.IsDualQuat(i));
+        m_shader.SetInt("u_MorphWeightOffset", morphed ? palette.GetMorphOffset(i) : -1);
+        m_shader.SetFloat("u_MorphPositionScale", mesh->MorphPositionScale);
+        m_shader.SetInt("u_OutputOffset", m_offsets[i]);
+        glDispatchCompute((vertexCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    // Every later pass reads the output from its vertex shader
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "../Shader.h"
+#include "../BonePalette.h"
+#include "../../resources/EntityManager.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// std430 layout of SkinnedVertex in Skinning.comp and the vertex shaders
+struct GPUSkinnedVertex
+{
+    glm::vec4 Position;  // xyz, w unused
+    glm::uvec4 Frame;    // x = normal.xy, y = normal.z / tangent.x, z = tangent.yz (snorm16 pairs)
+};
+
+// Skin-once pre-pass. Before any view is drawn, a compute shader skins the
+// mesh of every entity with a bone palette into one shared storage buffer,
+// blending in the mesh's morph targets first when the entity has non-zero
+// morph weights (morph-only meshes go through the same path unskinned).
+// Shadow maps, the depth pre-pass and the main / G-buffer pass then read the
+// skinned vertex by gl_VertexID (u_HasSkeleton) instead of blending bones
+// themselves, so a vertex is skinned once per frame however many views see it.
+class SkinningPass
+{
+public:
+    SkinningPass() = default;
+    ~SkinningPass();
+
+    SkinningPass(const SkinningPass&) = delete;
+    SkinningPass& operator=(const SkinningPass&) = delete;
+
+    bool Initialize();
+    void Release();
+
+    // Skins / morphs the first count entities that have a palette or morph
+    // weights and binds the output at BINDING for the passes that follow
+    void Execute(const EntityManager& entityManager, size_t count, const BonePalette& palette);
+
+    // First skinned vertex of an entity, -1 when it is drawn from its mesh streams
+    int GetOffset(size_t entityIndex) const
+    {
+        return entityIndex < m_offsets.size() ? m_offsets[entityIndex] : -1;
+    }
+
+    // Last Execute(): vertices skinned
+    size_t GetVertexCount() const { return m_vertexCount; }
+
+    // Must match SkinnedVertices in the vertex shaders
+    static constexpr unsigned int BINDING = 7;
+    // Must match local_size_x in Skinning.comp
+    static constexpr int WORKGROUP_SIZE = 64;
+
+private:
+    Shader m_shader;
+    unsigned int m_buffer = 0;
+    std::vector<int> m_offsets;
+    size_t m_vertexCount = 0;
+};
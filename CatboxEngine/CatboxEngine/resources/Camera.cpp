@@ -128,11 +128,14 @@ void Camera::ProcessMouseMovement(float xoffset, float yoffset, bool constrainPi
 
 // Frustum culling implementation
 Frustum Camera::GetFrustum() const
+{
+    return Frustum::FromMatrix(GetProjectionMatrix() * GetViewMatrix());
+}
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProj)
 {
     Frustum frustum;
     
-    glm::mat4 viewProj = GetProjectionMatrix() * GetViewMatrix();
-    
     // Extract frustum planes from view-projection matrix
     // Left plane
     frustum.planes[0] = glm::vec4(
@@ -9,6 +9,9 @@ struct Frustum
 {
     glm::vec4 planes[6];  // Left, Right, Bottom, Top, Near, Far
     
+    // Extract normalized planes from a view-projection matrix
+    static Frustum FromMatrix(const glm::mat4& viewProj);
+    
     // Check if AABB (bounding box) intersects frustum
     bool IsBoxVisible(const Vec3& min, const Vec3& max) const;
 };
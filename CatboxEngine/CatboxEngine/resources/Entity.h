@@ -1,6 +1,8 @@
 #pragma once
 #include "Transform.h"
 #include "../graphics/MeshManager.h"
+#include "../graphics/TextureManager.h"
+#include "../graphics/TerrainManager.h"
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
@@ -40,16 +42,17 @@ public:
     // store mesh path for scene persistence
     std::string MeshPath = "";
     
-    // Per-entity texture overrides
-    unsigned int DiffuseTexture = 0;
+    // Per-entity texture overrides; each holds a TextureManager reference,
+    // shared with every other user of the same file and with entity copies
+    TextureRef DiffuseTexture;
     std::string DiffuseTexturePath = "";
     bool HasDiffuseTextureOverride = false;
     
-    unsigned int SpecularTexture = 0;
+    TextureRef SpecularTexture;
     std::string SpecularTexturePath = "";
     bool HasSpecularTextureOverride = false;
     
-    unsigned int NormalTexture = 0;
+    TextureRef NormalTexture;
     std::string NormalTexturePath = "";
     bool HasNormalTextureOverride = false;
     
@@ -77,6 +80,9 @@ public:
     // Collision
     bool CollidesWithPlayer = true;  // When false, the player can walk through this entity
 
+    // Rendering: always rasterized into the occlusion buffer when on screen
+    bool IsOccluder = false;
+
     // Enemy patrol
     bool IsEnemy = false;
     std::vector<Vec3> PatrolWaypoints;
@@ -86,12 +92,17 @@ public:
     // Heightmap terrain (distinct from static meshes)
     bool IsTerrain = false;
     std::string TerrainHeightmapPath = "";  // Optional greyscale PNG; empty = procedural hills
-    int TerrainGridWidth = 64;              // Mesh subdivisions along X
-    int TerrainGridDepth = 64;              // Mesh subdivisions along Z
-    // Runtime: normalised [0,1] height samples rebuilt from heightmap on load — NOT serialised
+    int TerrainGridWidth = 64;              // Full-detail cells along X
+    int TerrainGridDepth = 64;              // Full-detail cells along Z
+    // Runtime: normalised [0,1] source samples while the terrain is generated;
+    // released once resampled into TerrainChunks — NOT serialised
     std::vector<float> TerrainHeightData;
     int TerrainHeightDataWidth  = 0;
     int TerrainHeightDataDepth  = 0;
+    // Runtime: LOD chunks and height texture drawn in place of the mesh, also
+    // sampled for collision. Owned by this entity while it is in the
+    // EntityManager; copies only alias it (see TerrainManager)
+    TerrainHandle TerrainChunks = 0;
 
     // Animation FBX paths per player state (persisted per scene)
     std::string AnimIdlePath;
@@ -100,6 +111,13 @@ public:
     std::string AnimJumpPath;
     std::string AnimFallPath;
 
-    // Runtime: computed bone matrices uploaded by the animation system each frame
+    // Runtime: skinning pose computed by the animation system each frame.
+    // Only one is filled: dual quaternions when the mesh asks for them
+    // (Mesh::DualQuaternionSkinning) and its bones are rigid, else matrices.
     std::vector<glm::mat4> BoneMatrices;
+    std::vector<DualQuat> BoneDualQuats;
+
+    // Morph target weights (0-1), one per Mesh::MorphTargets entry, blended
+    // on the GPU; targets past the end use the mesh's default weights
+    std::vector<float> MorphWeights;
 };
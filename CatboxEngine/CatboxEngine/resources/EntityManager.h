@@ -22,6 +22,7 @@ public:
             std::string name = m_entities[idx].name;
             
             if (h != 0) MeshManager::Instance().Release(h);
+            TerrainManager::Instance().Release(m_entities[idx].TerrainChunks);
             m_entities.erase(m_entities.begin() + idx);
             
             // Post entity destroyed message
@@ -33,7 +34,10 @@ public:
     void Clear()
     {
         for (auto& e : m_entities)
+        {
             if (e.MeshHandle != 0) MeshManager::Instance().Release(e.MeshHandle);
+            TerrainManager::Instance().Release(e.TerrainChunks);
+        }
         m_entities.clear();
     }
     size_t Size() const { return m_entities.size(); }
@@ -2,6 +2,7 @@
 #include "EntityManager.h"
 #include "../graphics/MeshManager.h"
 #include "../graphics/Mesh.h"
+#include "../graphics/TextureManager.h"
 #include "../graphics/LightManager.h"
 #include "../graphics/GraphicsSettings.h"
 #include "../gameplay/TerrainSystem.h"
@@ -118,6 +119,7 @@ void Scene::OnLoad(EntityManager& entityManager)
     gs.SkyboxFilePath = SkyboxFilePath;
     if (!SkyboxProcedural && !SkyboxFilePath.empty())
         gs.SkyboxFileDirty = true;
+    gs.DepthPrepass = DepthPrepass;
 }
 
 void Scene::OnUnload(EntityManager& entityManager)
@@ -161,6 +163,7 @@ void Scene::CaptureFromEntityManager(EntityManager& entityManager)
     SkyColorHorizon[0] = gs.SkyColorHorizon[0]; SkyColorHorizon[1] = gs.SkyColorHorizon[1]; SkyColorHorizon[2] = gs.SkyColorHorizon[2];
     SkyColorBottom[0]  = gs.SkyColorBottom[0];  SkyColorBottom[1]  = gs.SkyColorBottom[1];  SkyColorBottom[2]  = gs.SkyColorBottom[2];
     SkyboxFilePath = gs.SkyboxFilePath;
+    DepthPrepass = gs.DepthPrepass;
     
     // Update modified time
     auto now = std::chrono::system_clock::now();
@@ -257,6 +260,8 @@ bool Scene::SaveToFile(const std::string& path) const
     out << "SkyColorBottom=" << SkyColorBottom[0] << "," << SkyColorBottom[1] << "," << SkyColorBottom[2] << std::endl;
     if (!SkyboxFilePath.empty())
         out << "SkyboxFilePath=" << SkyboxFilePath << std::endl;
+    if (DepthPrepass)
+        out << "DepthPrepass=1" << std::endl;
     
     // Save lights
     out << "\n[Lights]" << std::endl;
@@ -284,6 +289,10 @@ bool Scene::SaveToFile(const std::string& path) const
         out << "ShadowNearPlane=" << light.ShadowNearPlane << std::endl;
         out << "ShadowFarPlane=" << light.ShadowFarPlane << std::endl;
         out << "ShadowFOV=" << light.ShadowFOV << std::endl;
+        out << "CascadeCount=" << light.CascadeCount << std::endl;
+        out << "ShadowDistance=" << light.ShadowDistance << std::endl;
+        out << "CascadeSplitLambda=" << light.CascadeSplitLambda << std::endl;
+        out << "CascadeCasterRange=" << light.CascadeCasterRange << std::endl;
         out << "Enabled=" << light.Enabled << std::endl;
     }
     
@@ -328,6 +337,8 @@ bool Scene::SaveToFile(const std::string& path) const
         }
         if (!e.CollidesWithPlayer)
             out << "CollidesWithPlayer=0" << std::endl;
+        if (e.IsOccluder)
+            out << "IsOccluder=1" << std::endl;
         if (e.IsEnemy)
         {
             out << "IsEnemy=1" << std::endl;
@@ -349,6 +360,13 @@ bool Scene::SaveToFile(const std::string& path) const
             out << "TerrainGridWidth=" << e.TerrainGridWidth << std::endl;
             out << "TerrainGridDepth=" << e.TerrainGridDepth << std::endl;
         }
+        if (!e.MorphWeights.empty())
+        {
+            out << "MorphWeights=";
+            for (size_t w = 0; w < e.MorphWeights.size(); ++w)
+                out << (w > 0 ? "," : "") << e.MorphWeights[w];
+            out << std::endl;
+        }
         // Animation paths (only write non-empty)
         if (!e.AnimIdlePath.empty())
             out << "AnimIdlePath=" << e.AnimIdlePath << std::endl;
@@ -468,6 +486,10 @@ bool Scene::LoadFromFile(const std::string& path)
             else if (key == "ShadowNearPlane") currentLight.ShadowNearPlane = std::stof(value);
             else if (key == "ShadowFarPlane") currentLight.ShadowFarPlane = std::stof(value);
             else if (key == "ShadowFOV") currentLight.ShadowFOV = std::stof(value);
+            else if (key == "CascadeCount") currentLight.CascadeCount = std::stoi(value);
+            else if (key == "ShadowDistance") currentLight.ShadowDistance = std::stof(value);
+            else if (key == "CascadeSplitLambda") currentLight.CascadeSplitLambda = std::stof(value);
+            else if (key == "CascadeCasterRange") currentLight.CascadeCasterRange = std::stof(value);
             else if (key == "Enabled") currentLight.Enabled = parseBool(value);
         }
         else if (currentSection == "[Environment]")
@@ -476,6 +498,7 @@ bool Scene::LoadFromFile(const std::string& path)
             else if (key == "Background") BackgroundColor = parseVec3(value);
             else if (key == "SkyboxEnabled")   SkyboxEnabled   = parseBool(value);
             else if (key == "SkyboxProcedural") SkyboxProcedural = parseBool(value);
+            else if (key == "DepthPrepass")    DepthPrepass    = parseBool(value);
             else if (key == "SkyColorTop")
             {
                 Vec3 v = parseVec3(value);
@@ -522,19 +545,19 @@ bool Scene::LoadFromFile(const std::string& path)
             {
                 currentEntity.DiffuseTexturePath = value;
                 currentEntity.HasDiffuseTextureOverride = true;
-                // TODO: Load texture
+                currentEntity.DiffuseTexture = TextureRef(TextureManager::Instance().Load(value, TextureUsage::Color));
             }
             else if (key == "SpecularTexturePath")
             {
                 currentEntity.SpecularTexturePath = value;
                 currentEntity.HasSpecularTextureOverride = true;
-                // TODO: Load texture
+                currentEntity.SpecularTexture = TextureRef(TextureManager::Instance().Load(value, TextureUsage::Mask));
             }
             else if (key == "NormalTexturePath")
             {
                 currentEntity.NormalTexturePath = value;
                 currentEntity.HasNormalTextureOverride = true;
-                // TODO: Load texture
+                currentEntity.NormalTexture = TextureRef(TextureManager::Instance().Load(value, TextureUsage::Normal));
             }
             // Material properties
             else if (key == "Shininess") currentEntity.Shininess = std::stof(value);
@@ -548,6 +571,7 @@ bool Scene::LoadFromFile(const std::string& path)
             else if (key == "IsGoal") currentEntity.IsGoal = parseBool(value);
             else if (key == "GoalRadius") { /* legacy distance-collision key ignored */ }
             else if (key == "CollidesWithPlayer") currentEntity.CollidesWithPlayer = parseBool(value);
+            else if (key == "IsOccluder") currentEntity.IsOccluder = parseBool(value);
             else if (key == "IsEnemy") currentEntity.IsEnemy = parseBool(value);
             else if (key == "EnemySpeed") currentEntity.EnemySpeed = std::stof(value);
             else if (key == "EnemyCollisionRadius") { /* legacy distance-collision key ignored */ }
@@ -561,6 +585,13 @@ bool Scene::LoadFromFile(const std::string& path)
             else if (key == "TerrainHeightmapPath") currentEntity.TerrainHeightmapPath = value;
             else if (key == "TerrainGridWidth")  currentEntity.TerrainGridWidth  = std::stoi(value);
             else if (key == "TerrainGridDepth")  currentEntity.TerrainGridDepth  = std::stoi(value);
+            else if (key == "MorphWeights")
+            {
+                std::stringstream weights(value);
+                std::string weight;
+                while (std::getline(weights, weight, ','))
+                    currentEntity.MorphWeights.push_back(std::stof(weight));
+            }
             // Animation paths
             else if (key == "AnimIdlePath") currentEntity.AnimIdlePath = value;
             else if (key == "AnimWalkPath") currentEntity.AnimWalkPath = value;
@@ -66,6 +66,9 @@ public:
     float SkyColorHorizon[3] = { 0.50f, 0.70f, 0.90f };
     float SkyColorBottom[3]  = { 0.30f, 0.25f, 0.15f };
     std::string SkyboxFilePath;
+
+    // Per-level rendering choices (mirrored from GraphicsSettings)
+    bool DepthPrepass = false;
     
     // Serialization
     bool SaveToFile(const std::string& path) const;
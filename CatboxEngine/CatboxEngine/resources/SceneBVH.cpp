@@ -0,0 +1,393 @@
+#include "SceneBVH.h"
+#include "EntityManager.h"
+#include "../graphics/FrustumCuller.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    constexpr int SAH_BINS = 8;
+    constexpr uint32_t MAX_LEAF_ITEMS = 2;
+    constexpr float TRAVERSAL_COST = 1.0f;  // relative to one box test
+    // Full rebuild once more than 1/N of the static tree has been promoted
+    constexpr size_t EVICTED_REBUILD_FRACTION = 8;
+
+    float HalfArea(const glm::vec3& mn, const glm::vec3& mx)
+    {
+        glm::vec3 d = glm::max(mx - mn, glm::vec3(0.0f));
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    // Plane classification for an AABB: -1 outside, 1 fully inside, 0 straddling
+    int ClassifyBox(const glm::vec4& plane, const glm::vec3& mn, const glm::vec3& mx)
+    {
+        glm::vec3 c = (mn + mx) * 0.5f;
+        glm::vec3 e = (mx - mn) * 0.5f;
+        float d = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+        float r = std::abs(plane.x) * e.x + std::abs(plane.y) * e.y + std::abs(plane.z) * e.z;
+        if (d + r < 0.0f) return -1;
+        if (d - r >= 0.0f) return 1;
+        return 0;
+    }
+}
+
+void SceneBVH::Update(const EntityManager& entityManager, const FrustumCuller& bounds)
+{
+    const auto& entities = entityManager.GetAll();
+    size_t count = bounds.GetCount();
+
+    // Entity indices shift on add/remove, so any size change starts over
+    if (count != m_bounds.size())
+    {
+        m_bounds.assign(count, AABB{});
+        m_isDynamic.assign(count, 0);
+        m_isUnbounded.assign(count, 0);
+        m_needsRebuild = true;
+    }
+
+    bool dynamicMoved = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Player and enemies move every frame; keep them out of the static tree
+        if (!m_isDynamic[i] && (entities[i].IsPlayer || entities[i].IsEnemy))
+        {
+            m_isDynamic[i] = 1;
+            m_needsRebuild = true;
+        }
+
+        uint8_t unbounded = bounds.IsUnbounded(i) ? 1 : 0;
+        if (unbounded != m_isUnbounded[i])
+        {
+            m_isUnbounded[i] = unbounded;
+            m_needsRebuild = true;
+        }
+        if (unbounded) continue;
+
+        AABB box{ bounds.GetBoundsMin(i), bounds.GetBoundsMax(i) };
+        if (box.Min != m_bounds[i].Min || box.Max != m_bounds[i].Max)
+        {
+            m_bounds[i] = box;
+            if (m_isDynamic[i])
+            {
+                dynamicMoved = true;
+            }
+            else if (!m_needsRebuild)
+            {
+                // A static entity moved: promote it to the dynamic tree. Its
+                // stale static leaf stays (conservative) and is skipped during
+                // culling until enough have left to justify a full SAH rebuild.
+                m_isDynamic[i] = 1;
+                m_rebuildDynamic = true;
+                m_evictedStatic++;
+            }
+        }
+    }
+
+    if (m_evictedStatic * EVICTED_REBUILD_FRACTION > m_static.Items.size())
+        m_needsRebuild = true;
+
+    if (m_needsRebuild)
+    {
+        Rebuild();
+    }
+    else if (m_rebuildDynamic)
+    {
+        std::vector<uint32_t> dynamicItems;
+        for (uint32_t i = 0; i < (uint32_t)m_bounds.size(); ++i)
+            if (m_isDynamic[i] && !m_isUnbounded[i])
+                dynamicItems.push_back(i);
+        m_dynamic.Build(m_bounds, std::move(dynamicItems));
+        m_rebuildDynamic = false;
+    }
+    else if (dynamicMoved)
+    {
+        m_dynamic.Refit(m_bounds);
+    }
+}
+
+void SceneBVH::Rebuild()
+{
+    std::vector<uint32_t> staticItems, dynamicItems;
+    m_unbounded.clear();
+
+    for (uint32_t i = 0; i < (uint32_t)m_bounds.size(); ++i)
+    {
+        if (m_isUnbounded[i])
+            m_unbounded.push_back(i);
+        else if (m_isDynamic[i])
+            dynamicItems.push_back(i);
+        else
+            staticItems.push_back(i);
+    }
+
+    m_static.Build(m_bounds, std::move(staticItems));
+    m_dynamic.Build(m_bounds, std::move(dynamicItems));
+    m_needsRebuild = false;
+    m_rebuildDynamic = false;
+    m_evictedStatic = 0;
+}
+
+void SceneBVH::Cull(const Frustum* frusta, int viewCount, MultiViewVisibility& out) const
+{
+    if (viewCount > MultiViewVisibility::MAX_VIEWS) viewCount = MultiViewVisibility::MAX_VIEWS;
+    out.Resize(m_bounds.size(), viewCount);
+
+    // Promoted entities still sit in the static tree with stale bounds
+    m_static.Cull(frusta, viewCount, m_bounds, m_evictedStatic ? &m_isDynamic : nullptr, out);
+    m_dynamic.Cull(frusta, viewCount, m_bounds, nullptr, out);
+    for (uint32_t i : m_unbounded)
+        for (int v = 0; v < viewCount; ++v)
+            out.Views[v].Set(i);
+}
+
+// ---------------------------------------------------------------------------
+// Tree
+// ---------------------------------------------------------------------------
+
+void SceneBVH::Tree::Build(const std::vector<AABB>& bounds, std::vector<uint32_t> items)
+{
+    Items = std::move(items);
+    Nodes.clear();
+    if (Items.empty()) return;
+
+    Nodes.reserve(Items.size() * 2);
+    Node root;
+    root.First = 0;
+    root.Count = (uint32_t)Items.size();
+    Nodes.push_back(root);
+    Subdivide(0, bounds);
+}
+
+void SceneBVH::Tree::Subdivide(uint32_t nodeIndex, const std::vector<AABB>& bounds)
+{
+    uint32_t first = Nodes[nodeIndex].First;
+    uint32_t count = Nodes[nodeIndex].Count;
+
+    // Node bounds and centroid bounds
+    AABB box{ glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+    glm::vec3 cmin(FLT_MAX), cmax(-FLT_MAX);
+    for (uint32_t i = first; i < first + count; ++i)
+    {
+        const AABB& b = bounds[Items[i]];
+        box.Min = glm::min(box.Min, b.Min);
+        box.Max = glm::max(box.Max, b.Max);
+        glm::vec3 c = (b.Min + b.Max) * 0.5f;
+        cmin = glm::min(cmin, c);
+        cmax = glm::max(cmax, c);
+    }
+    Nodes[nodeIndex].Bounds = box;
+
+    if (count <= MAX_LEAF_ITEMS)
+        return;
+
+    // Binned SAH over all three axes
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = FLT_MAX;
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float extent = cmax[axis] - cmin[axis];
+        if (extent <= 1e-6f) continue;
+        float scale = SAH_BINS / extent;
+
+        AABB binBounds[SAH_BINS];
+        uint32_t binCount[SAH_BINS] = {};
+        for (auto& bb : binBounds) { bb.Min = glm::vec3(FLT_MAX); bb.Max = glm::vec3(-FLT_MAX); }
+
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            const AABB& b = bounds[Items[i]];
+            float c = (b.Min[axis] + b.Max[axis]) * 0.5f;
+            int bin = std::min(SAH_BINS - 1, (int)((c - cmin[axis]) * scale));
+            binCount[bin]++;
+            binBounds[bin].Min = glm::min(binBounds[bin].Min, b.Min);
+            binBounds[bin].Max = glm::max(binBounds[bin].Max, b.Max);
+        }
+
+        // Sweep from both sides to get area * count for every split plane
+        float leftCost[SAH_BINS - 1];
+        glm::vec3 mn(FLT_MAX), mx(-FLT_MAX);
+        uint32_t n = 0;
+        for (int s = 0; s < SAH_BINS - 1; ++s)
+        {
+            n += binCount[s];
+            mn = glm::min(mn, binBounds[s].Min);
+            mx = glm::max(mx, binBounds[s].Max);
+            leftCost[s] = n ? n * HalfArea(mn, mx) : 0.0f;
+        }
+        mn = glm::vec3(FLT_MAX); mx = glm::vec3(-FLT_MAX);
+        n = 0;
+        for (int s = SAH_BINS - 1; s > 0; --s)
+        {
+            n += binCount[s];
+            mn = glm::min(mn, binBounds[s].Min);
+            mx = glm::max(mx, binBounds[s].Max);
+            float cost = leftCost[s - 1] + (n ? n * HalfArea(mn, mx) : 0.0f);
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = s;
+            }
+        }
+    }
+
+    // All centroids coincide, or splitting is no cheaper than testing every item
+    float leafCost = count * HalfArea(box.Min, box.Max);
+    if (bestAxis < 0 || TRAVERSAL_COST * HalfArea(box.Min, box.Max) + bestCost >= leafCost)
+        return;
+
+    float scale = SAH_BINS / (cmax[bestAxis] - cmin[bestAxis]);
+    auto mid = std::partition(Items.begin() + first, Items.begin() + first + count, [&](uint32_t item) {
+        const AABB& b = bounds[item];
+        float c = (b.Min[bestAxis] + b.Max[bestAxis]) * 0.5f;
+        return std::min(SAH_BINS - 1, (int)((c - cmin[bestAxis]) * scale)) < bestSplit;
+    });
+    uint32_t leftCount = (uint32_t)(mid - (Items.begin() + first));
+    if (leftCount == 0 || leftCount == count)
+        return;
+
+    uint32_t left = (uint32_t)Nodes.size();
+    Node l, r;
+    l.First = first;
+    l.Count = leftCount;
+    r.First = first + leftCount;
+    r.Count = count - leftCount;
+    Nodes.push_back(l);
+    Nodes.push_back(r);
+    Nodes[nodeIndex].Left = left;
+
+    Subdivide(left, bounds);
+    Subdivide(left + 1, bounds);
+}
+
+void SceneBVH::Tree::Refit(const std::vector<AABB>& bounds)
+{
+    // Children are always stored after their parent, so a reverse sweep
+    // visits every child before it is needed
+    for (size_t n = Nodes.size(); n-- > 0;)
+    {
+        Node& node = Nodes[n];
+        if (node.Left == 0)
+        {
+            node.Bounds.Min = glm::vec3(FLT_MAX);
+            node.Bounds.Max = glm::vec3(-FLT_MAX);
+            for (uint32_t i = node.First; i < node.First + node.Count; ++i)
+            {
+                node.Bounds.Min = glm::min(node.Bounds.Min, bounds[Items[i]].Min);
+                node.Bounds.Max = glm::max(node.Bounds.Max, bounds[Items[i]].Max);
+            }
+        }
+        else
+        {
+            const Node& l = Nodes[node.Left];
+            const Node& r = Nodes[node.Left + 1];
+            node.Bounds.Min = glm::min(l.Bounds.Min, r.Bounds.Min);
+            node.Bounds.Max = glm::max(l.Bounds.Max, r.Bounds.Max);
+        }
+    }
+}
+
+void SceneBVH::Tree::Cull(const Frustum* frusta, int viewCount, const std::vector<AABB>& bounds,
+                          const std::vector<uint8_t>* skip, MultiViewVisibility& out) const
+{
+    if (Nodes.empty() || viewCount == 0) return;
+
+    // Each entry carries the views that have not rejected its parent and,
+    // per view, the planes the parent still straddled. Planes a node is
+    // fully inside of are dropped for the whole subtree; a view with no
+    // planes left accepts everything below without further tests.
+    struct Entry
+    {
+        uint32_t Node;
+        uint32_t Live;
+        uint8_t Planes[MultiViewVisibility::MAX_VIEWS];
+    };
+
+    auto emit = [&](const Node& node, uint32_t views) {
+        for (uint32_t i = node.First; i < node.First + node.Count; ++i)
+        {
+            uint32_t item = Items[i];
+            if (skip && (*skip)[item]) continue;
+            for (int v = 0; v < viewCount; ++v)
+                if (views & (1u << v)) out.Views[v].Set(item);
+        }
+    };
+
+    Entry stack[64];
+    int top = 0;
+    Entry root;
+    root.Node = 0;
+    root.Live = (viewCount >= 32) ? 0xFFFFFFFFu : ((1u << viewCount) - 1);
+    for (int v = 0; v < MultiViewVisibility::MAX_VIEWS; ++v) root.Planes[v] = 0x3F;
+    stack[top++] = root;
+
+    while (top > 0)
+    {
+        Entry entry = stack[--top];
+        const Node& node = Nodes[entry.Node];
+
+        uint32_t straddling = 0;
+        for (int v = 0; v < viewCount; ++v)
+        {
+            if (!(entry.Live & (1u << v)) || entry.Planes[v] == 0) continue;
+            for (int p = 0; p < 6; ++p)
+            {
+                if (!(entry.Planes[v] & (1u << p))) continue;
+                int side = ClassifyBox(frusta[v].planes[p], node.Bounds.Min, node.Bounds.Max);
+                if (side < 0) { entry.Live &= ~(1u << v); break; }
+                if (side > 0) entry.Planes[v] &= ~(1u << p);
+            }
+            if ((entry.Live & (1u << v)) && entry.Planes[v] != 0)
+                straddling |= (1u << v);
+        }
+        if (entry.Live == 0) continue;
+
+        if (straddling == 0)
+        {
+            // Fully inside every live view: accept the whole subtree
+            emit(node, entry.Live);
+            continue;
+        }
+
+        if (node.Left == 0)
+        {
+            uint32_t inside = entry.Live & ~straddling;
+            for (uint32_t i = node.First; i < node.First + node.Count; ++i)
+            {
+                uint32_t item = Items[i];
+                if (skip && (*skip)[item]) continue;
+                const AABB& b = bounds[item];
+                for (int v = 0; v < viewCount; ++v)
+                {
+                    bool visible = (inside & (1u << v)) != 0;
+                    if (straddling & (1u << v))
+                    {
+                        visible = true;
+                        for (int p = 0; p < 6 && visible; ++p)
+                        {
+                            if (entry.Planes[v] & (1u << p))
+                                visible = ClassifyBox(frusta[v].planes[p], b.Min, b.Max) >= 0;
+                        }
+                    }
+                    if (visible) out.Views[v].Set(item);
+                }
+            }
+            continue;
+        }
+
+        if (top + 2 > 64)
+        {
+            // Pathologically deep tree: fall back to accepting the subtree
+            emit(node, entry.Live);
+            continue;
+        }
+        Entry child = entry;
+        child.Node = node.Left + 1;
+        stack[top++] = child;
+        child.Node = node.Left;
+        stack[top++] = child;
+    }
+}
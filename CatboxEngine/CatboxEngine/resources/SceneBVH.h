@@ -0,0 +1,82 @@
+#pragma once
+#include "Camera.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class EntityManager;
+class FrustumCuller;
+struct MultiViewVisibility;
+
+// Bounding volume hierarchy over the entities in EntityManager.
+//
+// Entities are split into two trees:
+//  - static: built with a binned SAH; entities that start moving are promoted
+//    out of it and it is rebuilt once enough have left
+//  - dynamic: players, enemies and anything whose bounds have moved; refit
+//    in place every frame and rebuilt when membership changes
+// Entities without bounds (meshes still loading) are kept in a flat list and
+// always reported visible.
+//
+// Leaf items are indices into EntityManager::GetAll(), so the same tree
+// serves camera and shadow frusta alike.
+class SceneBVH
+{
+public:
+    // Sync with this frame's world bounds (FrustumCuller::Gather must run first)
+    void Update(const EntityManager& entityManager, const FrustumCuller& bounds);
+
+    // Force a full rebuild on the next Update (scene load, bulk edits)
+    void Invalidate() { m_needsRebuild = true; }
+
+    // Hierarchical test against several frusta in one traversal; whole
+    // subtrees are accepted or rejected per view. Resizes out.
+    void Cull(const Frustum* frusta, int viewCount, MultiViewVisibility& out) const;
+
+    size_t GetStaticCount() const { return m_static.Items.size() - m_evictedStatic; }
+    size_t GetDynamicCount() const { return m_dynamic.Items.size(); }
+    size_t GetNodeCount() const { return m_static.Nodes.size() + m_dynamic.Nodes.size(); }
+
+private:
+    struct AABB
+    {
+        glm::vec3 Min{ 0.0f };
+        glm::vec3 Max{ 0.0f };
+    };
+
+    struct Node
+    {
+        AABB Bounds;
+        uint32_t Left = 0;   // first child (right = Left + 1); 0 for leaves
+        uint32_t First = 0;  // first entry in Items covered by this subtree
+        uint32_t Count = 0;  // number of Items covered by this subtree
+    };
+
+    struct Tree
+    {
+        std::vector<Node> Nodes;
+        std::vector<uint32_t> Items;  // entity indices, contiguous per subtree
+
+        void Build(const std::vector<AABB>& bounds, std::vector<uint32_t> items);
+        void Refit(const std::vector<AABB>& bounds);
+        // skip: optional per-entity flags; flagged items are never emitted
+        void Cull(const Frustum* frusta, int viewCount, const std::vector<AABB>& bounds,
+                  const std::vector<uint8_t>* skip, MultiViewVisibility& out) const;
+
+    private:
+        void Subdivide(uint32_t nodeIndex, const std::vector<AABB>& bounds);
+    };
+
+    Tree m_static;
+    Tree m_dynamic;
+    std::vector<uint32_t> m_unbounded;
+
+    std::vector<AABB> m_bounds;          // per entity, last synced
+    std::vector<uint8_t> m_isDynamic;    // sticky once an entity has moved
+    std::vector<uint8_t> m_isUnbounded;
+    bool m_needsRebuild = true;
+    bool m_rebuildDynamic = false;
+    size_t m_evictedStatic = 0;          // promoted entities still in the static tree
+
+    void Rebuild();
+};
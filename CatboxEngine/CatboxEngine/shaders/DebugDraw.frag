@@ -0,0 +1,8 @@
+#version 440 core
+in vec4 v_Color;
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = v_Color;
+}
@@ -0,0 +1,26 @@
+#version 440 core
+// Debug shapes (graphics/DebugDraw.h): world-space lines, or instances of a
+// unit shape placed by a per-instance transform
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;           // lines
+layout(location = 2) in mat4 a_Transform;       // instances, locations 2-5
+layout(location = 6) in vec4 a_InstanceColor;   // instances
+
+uniform mat4 u_ViewProj;
+uniform bool u_Instanced;
+
+out vec4 v_Color;
+
+void main()
+{
+    vec3 world = a_Position;
+    v_Color = a_Color;
+    if (u_Instanced)
+    {
+        // w != 1 for frusta (inverse view-projection)
+        vec4 placed = a_Transform * vec4(a_Position, 1.0);
+        world = placed.xyz / placed.w;
+        v_Color = a_InstanceColor;
+    }
+    gl_Position = u_ViewProj * vec4(world, 1.0);
+}
@@ -0,0 +1,38 @@
+#version 440 core
+// Depth pre-pass: positions only. Must compute gl_Position exactly like
+// VertexShader.vert (both are invariant) so the main pass can test GL_LEQUAL.
+layout (location = 0) in vec3 aPos;
+
+invariant gl_Position;
+
+uniform mat4 u_MVP;
+uniform mat4 transform;
+
+#include "MeshInput.glsl"
+
+void main()
+{
+    // Batched skinned instances replace transform and the skinned vertex offset
+    mat4 model = transform;
+    int skinnedOffset = u_SkinnedVertexOffset;
+    if (u_Instanced)
+    {
+        SkinnedInstance instance = u_Instances[u_FirstInstance + gl_InstanceID];
+        model = instance.model;
+        skinnedOffset = instance.params.x;
+    }
+
+    vec3 localPos = aPos;
+
+    if (u_IsTerrain)
+    {
+        localPos = TerrainPosition(TerrainGridVertex());
+    }
+    else if (u_HasSkeleton)
+    {
+        localPos = u_SkinnedVertices[skinnedOffset + gl_VertexID].position.xyz;
+    }
+
+    vec4 worldPos = model * vec4(localPos, 1.0);
+    gl_Position = u_MVP * worldPos;
+}
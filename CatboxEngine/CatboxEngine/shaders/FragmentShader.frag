@@ -1,13 +1,18 @@
 #version 440 core
 
-// Maximum number of lights
-#define MAX_LIGHTS 8
+// Cluster grid (ForwardPass::CLUSTER_X/Y/Z)
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+
+// Shadow atlas tiles per frame (ShadowTileTable::MAX_TILES)
+#define MAX_SHADOW_TILES 32
 
 in vec2 TexCoord;
 in vec3 FragNormal;
 in vec3 FragTangent;
 in vec3 FragPos;  // World position
-in vec4 FragPosLightSpace[8];  // Light space position for each light
+in float ViewDepth;
 out vec4 FragColor;
 
 // Material properties
@@ -31,43 +36,35 @@ uniform bool u_HasNormalMap;
 // Camera
 uniform vec3 u_CameraPos;
 
-// Light structure
-struct Light {
-    int type;              // 0=Directional, 1=Point, 2=Spot
-    vec3 position;
-    vec3 direction;
-    vec3 color;
-    float intensity;
-    
-    // Attenuation (Point and Spot)
-    float constant;
-    float linear;
-    float quadratic;
-    
-    // Spot light
-    float innerCutoff;
-    float outerCutoff;
-    
-    // Shadow properties
-    bool castsShadows;
-    sampler2D shadowMap;
-    mat4 lightSpaceMatrix;
-    float shadowBias;
-    
-    bool enabled;
+// Light data (graphics/LightBuffer.h), no fixed limit on the count
+struct GPULight {
+    vec4 positionRange;    // xyz position, w = range
+    vec4 directionType;    // xyz direction, w = 0 Directional, 1 Point, 2 Spot
+    vec4 colorIntensity;   // rgb color, w = intensity
+    vec4 attenuation;      // constant, linear, quadratic, shadow bias
+    vec4 spot;             // cos inner, cos outer, first shadow tile (-1 = none), cascade count
+    vec4 cascadeSplits;    // Far view depth of each cascade
 };
 
-// Lights
-uniform int u_NumLights;
-uniform Light u_Lights[MAX_LIGHTS];
+layout(std430, binding = 0) readonly buffer LightBuffer { GPULight u_LightData[]; };
 
-// Shadow calculation with PCF
-float CalculateShadow(int lightIndex, Light light, vec3 normal, vec3 lightDir)
+// Per-cluster light lists built by ForwardPass; the entry after the last
+// cluster lists the lights that reach everywhere
+layout(std430, binding = 3) readonly buffer ClusterBuffer { uvec2 u_Clusters[]; };  // offset, count
+layout(std430, binding = 4) readonly buffer ClusterIndexBuffer { uint u_ClusterLightIndices[]; };
+
+// xy = cluster tile size in pixels, z/w = depth slice scale/bias
+uniform vec4 u_ClusterParams;
+
+// Shadow atlas: every light's maps are tiles of one depth texture
+uniform sampler2D u_ShadowAtlas;
+uniform mat4 u_ShadowMatrices[MAX_SHADOW_TILES];
+uniform vec4 u_ShadowRects[MAX_SHADOW_TILES];  // xy = offset, zw = scale in atlas UVs
+
+// 2x2 PCF inside one atlas tile
+float SampleShadowTile(int tile, float bias)
 {
-    if (!light.castsShadows)
-        return 0.0;
-    
-    vec4 fragPosLightSpace = FragPosLightSpace[lightIndex];
+    vec4 fragPosLightSpace = u_ShadowMatrices[tile] * vec4(FragPos, 1.0);
     
     // Perspective divide
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
@@ -76,25 +73,28 @@ float CalculateShadow(int lightIndex, Light light, vec3 normal, vec3 lightDir)
     projCoords = projCoords * 0.5 + 0.5;
     
     // Outside shadow map frustum
-    if (projCoords.z > 1.0)
+    if (projCoords.z > 1.0 || any(lessThan(projCoords.xy, vec2(0.0))) || any(greaterThan(projCoords.xy, vec2(1.0))))
         return 0.0;
     
     // Current depth
     float currentDepth = projCoords.z;
     
-    // Calculate bias based on slope
-    float bias = max(light.shadowBias * (1.0 - dot(normal, lightDir)), light.shadowBias * 0.1);
+    vec4 rect = u_ShadowRects[tile];
+    vec2 texelSize = 1.0 / vec2(textureSize(u_ShadowAtlas, 0));
+    vec2 uv = rect.xy + projCoords.xy * rect.zw;
+    
+    // Keep the filter footprint inside the tile so neighbours never bleed in
+    vec2 uvMin = rect.xy + 0.5 * texelSize;
+    vec2 uvMax = rect.xy + rect.zw - 0.5 * texelSize;
     
     // PCF (Percentage Closer Filtering) - 2x2 for sharper shadows
     float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(light.shadowMap, 0);
-    
-    // Sample 2x2 grid for balance between soft and sharp
     for(int x = 0; x <= 1; ++x)
     {
         for(int y = 0; y <= 1; ++y)
         {
-            float pcfDepth = texture(light.shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+            vec2 sampleUV = clamp(uv + vec2(x, y) * texelSize, uvMin, uvMax);
+            float pcfDepth = texture(u_ShadowAtlas, sampleUV).r;
             shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
         }
     }
@@ -103,67 +103,108 @@ float CalculateShadow(int lightIndex, Light light, vec3 normal, vec3 lightDir)
     return shadow;
 }
 
-// Calculate lighting for one light
-vec3 CalculateLight(int lightIndex, Light light, vec3 normal, vec3 viewDir, vec3 albedo, vec3 specular)
+// Shadow calculation with PCF
+float CalculateShadow(GPULight light, vec3 normal, vec3 lightDir)
 {
-    if (!light.enabled)
-        return vec3(0.0);
+    int firstTile = int(light.spot.z);
+    if (firstTile < 0)
+        return 0.0;
+    
+    // Calculate bias based on slope
+    float shadowBias = light.attenuation.w;
+    float bias = max(shadowBias * (1.0 - dot(normal, lightDir)), shadowBias * 0.1);
+    
+    int cascadeCount = int(light.spot.w);
+    if (cascadeCount == 0)
+        return SampleShadowTile(firstTile, bias);
+    
+    // Cascaded: pick the slice by view depth
+    int cascade = 0;
+    while (cascade < cascadeCount - 1 && ViewDepth > light.cascadeSplits[cascade])
+        ++cascade;
+    
+    // Beyond the shadow distance
+    if (ViewDepth > light.cascadeSplits[cascadeCount - 1])
+        return 0.0;
     
+    // Texels get larger with each cascade, so does the bias they need
+    bias *= float(cascade + 1);
+    return SampleShadowTile(firstTile + cascade, bias);
+}
+
+// Tangent-space normal from x and y: BC5 normal maps carry no z
+vec3 SampleNormalMap()
+{
+    vec2 xy = texture(u_NormalMap, TexCoord).rg * 2.0 - 1.0;  // [0,1] -> [-1,1]
+    return vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+}
+
+// Calculate lighting for one light
+vec3 CalculateLight(GPULight light, vec3 normal, vec3 viewDir, vec3 albedo, vec3 specular)
+{
+    int type = int(light.directionType.w);
     vec3 lightDir;
     float attenuation = 1.0;
     
     // Calculate light direction and attenuation based on type
-    if (light.type == 0) // Directional
+    if (type == 0) // Directional
     {
-        lightDir = normalize(-light.direction);
+        lightDir = normalize(-light.directionType.xyz);
     }
-    else if (light.type == 1) // Point
+    else // Point / Spot
     {
-        vec3 lightVec = light.position - FragPos;
+        vec3 lightVec = light.positionRange.xyz - FragPos;
         float distance = length(lightVec);
-        lightDir = normalize(lightVec);
         
-        // Attenuation
-        attenuation = 1.0 / (light.constant + light.linear * distance + 
-                            light.quadratic * distance * distance);
-    }
-    else if (light.type == 2) // Spot
-    {
-        vec3 lightVec = light.position - FragPos;
-        float distance = length(lightVec);
-        lightDir = normalize(lightVec);
+        // Beyond the range the light was clustered with
+        if (light.positionRange.w > 0.0 && distance > light.positionRange.w)
+            return vec3(0.0);
+        
+        lightDir = lightVec / max(distance, 1e-4);
         
         // Attenuation
-        attenuation = 1.0 / (light.constant + light.linear * distance + 
-                            light.quadratic * distance * distance);
+        attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance + 
+                             light.attenuation.z * distance * distance);
         
-        // Spotlight cone
-        float theta = dot(lightDir, normalize(-light.direction));
-        float epsilon = light.innerCutoff - light.outerCutoff;
-        float intensity = clamp((theta - light.outerCutoff) / epsilon, 0.0, 1.0);
-        attenuation *= intensity;
+        if (type == 2) // Spotlight cone
+        {
+            float theta = dot(lightDir, normalize(-light.directionType.xyz));
+            float epsilon = light.spot.x - light.spot.y;
+            attenuation *= clamp((theta - light.spot.y) / epsilon, 0.0, 1.0);
+        }
     }
     
+    if (attenuation <= 0.0)
+        return vec3(0.0);
+    
     // Calculate shadow
-    float shadow = CalculateShadow(lightIndex, light, normal, lightDir);
+    float shadow = CalculateShadow(light, normal, lightDir);
     
     // Soften shadows for stylized look (matching reference image)
     shadow = clamp(shadow * 0.4, 0.0, 1.0);  // Reduced from 1.2 to 0.4 for softer shadows
     
+    vec3 radiance = light.colorIntensity.rgb * light.colorIntensity.w * attenuation;
+    
     // Diffuse
     float diff = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse = light.color * light.intensity * diff * albedo * attenuation;
+    vec3 diffuse = radiance * diff * albedo;
     
     // Specular (Blinn-Phong)
     vec3 halfwayDir = normalize(lightDir + viewDir);
     float spec = pow(max(dot(normal, halfwayDir), 0.0), u_Shininess);
-    vec3 specularContrib = light.color * light.intensity * spec * specular * attenuation;
+    vec3 specularContrib = radiance * spec * specular;
     
     // Apply shadow (reduces both diffuse and specular)
-    diffuse *= (1.0 - shadow);
-    specularContrib *= (1.0 - shadow);
-    
-    return diffuse + specularContrib;
+    return (diffuse + specularContrib) * (1.0 - shadow);
+}
+
+// Cluster of this fragment: screen tile + exponential depth slice
+int ClusterIndex()
+{
+    ivec2 tile = min(ivec2(gl_FragCoord.xy / u_ClusterParams.xy), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+    int slice = int(floor(log(max(ViewDepth, 1e-4)) * u_ClusterParams.z + u_ClusterParams.w));
+    slice = clamp(slice, 0, CLUSTER_Z - 1);
+    return (slice * CLUSTER_Y + tile.y) * CLUSTER_X + tile.x;
 }
 
 void main()
@@ -217,16 +258,14 @@ void main()
             vec3 B = cross(N, T);
             mat3 TBN = mat3(T, B, N);
             
-            vec3 normalMap = texture(u_NormalMap, TexCoord).rgb;
-            normalMap = normalMap * 2.0 - 1.0;  // [0,1] -> [-1,1]
+            vec3 normalMap = SampleNormalMap();
             N = normalize(TBN * normalMap);
         }
         else
         {
             // Fallback: Generate tangent space from normal and apply normal map
             // This is less accurate but works for meshes without tangent data
-            vec3 normalMap = texture(u_NormalMap, TexCoord).rgb;
-            normalMap = normalMap * 2.0 - 1.0;  // [0,1] -> [-1,1]
+            vec3 normalMap = SampleNormalMap();
             
             // Create arbitrary tangent space
             vec3 up = abs(N.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
@@ -246,11 +285,16 @@ void main()
     // Low value for realistic darkness when no lights are present
     vec3 ambient = 0.05 * albedo;  // Reduced to 0.05 for darker models without light
     
-    // Calculate all lights
+    // Lights clustered here, then the ones that reach everywhere
     vec3 lighting = ambient;
-    for (int i = 0; i < u_NumLights && i < MAX_LIGHTS; ++i)
+    uvec2 lists[2] = uvec2[2](u_Clusters[ClusterIndex()], u_Clusters[CLUSTER_X * CLUSTER_Y * CLUSTER_Z]);
+    for (int l = 0; l < 2; ++l)
     {
-        lighting += CalculateLight(i, u_Lights[i], N, V, albedo, specularColor);
+        for (uint i = 0u; i < lists[l].y; ++i)
+        {
+            uint lightIndex = u_ClusterLightIndices[lists[l].x + i];
+            lighting += CalculateLight(u_LightData[lightIndex], N, V, albedo, specularColor);
+        }
     }
     
     // Final color
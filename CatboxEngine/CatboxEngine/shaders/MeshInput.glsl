@@ -0,0 +1,55 @@
+// Shared by VertexShader.vert, DepthPrepass.vert and ShadowMap.vert, spliced
+// in by Shader::LoadShaderSource. The including shader declares aPos first.
+
+// Skeletal animation: skinned meshes were skinned once this frame by
+// Skinning.comp (graphics/passes/SkinningPass.h); their vertices are read
+// from u_SkinnedVertices by gl_VertexID, starting at u_SkinnedVertexOffset
+uniform bool u_HasSkeleton;
+uniform int u_SkinnedVertexOffset;
+struct SkinnedVertex
+{
+    vec4 position;
+    uvec4 frame;    // snorm16 pairs: normal.xy, (normal.z, tangent.x), tangent.yz
+};
+layout(std430, binding = 7) readonly buffer SkinnedVertices
+{
+    SkinnedVertex u_SkinnedVertices[];
+};
+
+// Skinned batches (RenderPipeline::BuildSkinnedBatches): each instance
+// brings its own world matrix and first skinned vertex
+struct SkinnedInstance
+{
+    mat4 model;
+    ivec4 params;   // x = first skinned vertex
+};
+layout(std430, binding = 6) readonly buffer SkinnedInstances
+{
+    SkinnedInstance u_Instances[];
+};
+uniform bool u_Instanced;
+uniform int u_FirstInstance;
+
+// Heightmap terrain (graphics/TerrainQuadtree.h): aPos.xz is a vertex of the
+// shared chunk grid, placed by the chunk's first grid vertex and step and
+// lifted by one texel of the height texture per grid vertex
+uniform bool u_IsTerrain;
+uniform sampler2D u_TerrainHeight;
+uniform vec4 u_TerrainPatch;    // xy = first grid vertex, z = step
+uniform vec4 u_TerrainCells;    // xy = grid cells
+
+ivec2 TerrainGridVertex()
+{
+    return min(ivec2(u_TerrainPatch.xy) + ivec2(aPos.xz) * int(u_TerrainPatch.z), ivec2(u_TerrainCells.xy));
+}
+
+float TerrainHeight(ivec2 g)
+{
+    return texelFetch(u_TerrainHeight, clamp(g, ivec2(0), ivec2(u_TerrainCells.xy)), 0).r;
+}
+
+vec3 TerrainPosition(ivec2 g)
+{
+    vec2 uv = vec2(g) / u_TerrainCells.xy;
+    return vec3(uv.x - 0.5, TerrainHeight(g), uv.y - 0.5);
+}
@@ -1,10 +1,20 @@
 #version 440 core
+// Bound to Mesh::DepthVAO (or a terrain's patch grid): only the tightly
+// packed float3 position stream
 layout (location = 0) in vec3 aPos;
 
 uniform mat4 u_LightSpaceMatrix;
 uniform mat4 u_Model;
 
+#include "MeshInput.glsl"
+
 void main()
 {
-    gl_Position = u_LightSpaceMatrix * u_Model * vec4(aPos, 1.0);
+    vec3 localPos = aPos;
+    if (u_IsTerrain)
+        localPos = TerrainPosition(TerrainGridVertex());
+    else if (u_HasSkeleton)
+        localPos = u_SkinnedVertices[u_SkinnedVertexOffset + gl_VertexID].position.xyz;
+
+    gl_Position = u_LightSpaceMatrix * u_Model * vec4(localPos, 1.0);
 }
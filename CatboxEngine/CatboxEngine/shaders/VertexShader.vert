@@ -1,63 +1,89 @@
 #version 440 core
+// Packed vertex streams (see graphics/VertexFormat.h):
+//   normal/tangent are snorm 10:10:10:2, uv is half float,
+//   skinned meshes come pre-skinned from u_SkinnedVertices instead.
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
+layout (location = 1) in vec4 aNormal;
 layout (location = 2) in vec2 aTexCoord;
-layout (location = 3) in vec3 aTangent;
-layout (location = 4) in ivec4 aBoneIndices;
-layout (location = 5) in vec4 aBoneWeights;
+layout (location = 3) in vec4 aTangent;
 
 out vec2 TexCoord;
 out vec3 FragNormal;
 out vec3 FragTangent;
 out vec3 FragPos;
-out vec4 FragPosLightSpace[8];  // Light space position for each light
+out float ViewDepth;            // Distance along the camera axis, selects the shadow cascade
+
+// Matches DepthPrepass.vert bit for bit, so the pre-pass depth can be tested with GL_LEQUAL
+invariant gl_Position;
 
 uniform mat4 u_MVP;
+uniform mat4 u_View;
 uniform mat4 transform;
 
-// Skeletal animation
-uniform bool u_HasSkeleton;
-uniform mat4 u_BoneMatrices[128];
+#include "MeshInput.glsl"
+
+// TerrainQuadtree.cpp UV_TILING
+#define TERRAIN_UV_TILING 8.0
 
-// Light space matrices for shadow mapping (separate from Light struct)
-uniform mat4 u_LightSpaceMatrices[8];
-uniform int u_NumLights;
+// Central differences over the full-resolution grid, whatever the chunk's step
+vec3 TerrainNormal(ivec2 g)
+{
+    ivec2 lo = max(g - 1, ivec2(0));
+    ivec2 hi = min(g + 1, ivec2(u_TerrainCells.xy));
+    float slopeX = (TerrainHeight(ivec2(hi.x, g.y)) - TerrainHeight(ivec2(lo.x, g.y))) * u_TerrainCells.x / float(hi.x - lo.x);
+    float slopeZ = (TerrainHeight(ivec2(g.x, hi.y)) - TerrainHeight(ivec2(g.x, lo.y))) * u_TerrainCells.y / float(hi.y - lo.y);
+    return normalize(vec3(-slopeX, 1.0, -slopeZ));
+}
 
 void main()
 {
+    // Batched skinned instances replace transform and the skinned vertex offset
+    mat4 model = transform;
+    int skinnedOffset = u_SkinnedVertexOffset;
+    if (u_Instanced)
+    {
+        SkinnedInstance instance = u_Instances[u_FirstInstance + gl_InstanceID];
+        model = instance.model;
+        skinnedOffset = instance.params.x;
+    }
+
     vec3 localPos    = aPos;
-    vec3 localNormal = aNormal;
-    vec3 localTangent = aTangent;
+    vec3 localNormal = normalize(aNormal.xyz);
+    vec3 localTangent = normalize(aTangent.xyz);
+    vec2 texCoord = aTexCoord;
 
-    // Apply skeletal animation if bones are present
-    if (u_HasSkeleton)
+    // Terrain chunks are displaced from the height texture; skinned meshes
+    // take the pre-skinned vertex
+    if (u_IsTerrain)
     {
-        mat4 boneTransform = u_BoneMatrices[aBoneIndices[0]] * aBoneWeights[0]
-                           + u_BoneMatrices[aBoneIndices[1]] * aBoneWeights[1]
-                           + u_BoneMatrices[aBoneIndices[2]] * aBoneWeights[2]
-                           + u_BoneMatrices[aBoneIndices[3]] * aBoneWeights[3];
-
-        localPos    = (boneTransform * vec4(aPos, 1.0)).xyz;
-        localNormal = (boneTransform * vec4(aNormal, 0.0)).xyz;
-        localTangent = (boneTransform * vec4(aTangent, 0.0)).xyz;
+        ivec2 g = TerrainGridVertex();
+        localPos = TerrainPosition(g);
+        localNormal = TerrainNormal(g);
+        localTangent = vec3(1.0, 0.0, 0.0);
+        texCoord = vec2(g) / u_TerrainCells.xy * TERRAIN_UV_TILING;
+    }
+    else if (u_HasSkeleton)
+    {
+        SkinnedVertex skinned = u_SkinnedVertices[skinnedOffset + gl_VertexID];
+        vec2 normalXY = unpackSnorm2x16(skinned.frame.x);
+        vec2 normalZTangentX = unpackSnorm2x16(skinned.frame.y);
+
+        localPos    = skinned.position.xyz;
+        localNormal = vec3(normalXY, normalZTangentX.x);
+        localTangent = vec3(normalZTangentX.y, unpackSnorm2x16(skinned.frame.z));
     }
 
     // World position
-    vec4 worldPos = transform * vec4(localPos, 1.0);
+    vec4 worldPos = model * vec4(localPos, 1.0);
     FragPos = worldPos.xyz;
+    ViewDepth = -(u_View * worldPos).z;
 
-    TexCoord = aTexCoord;
+    TexCoord = texCoord;
 
     // Transform normal and tangent to world space
-    mat3 normalMat = transpose(inverse(mat3(transform)));
+    mat3 normalMat = transpose(inverse(mat3(model)));
     FragNormal = normalize(normalMat * localNormal);
-    FragTangent = normalize(mat3(transform) * localTangent);
-
-    // Calculate light space positions for shadow mapping
-    for (int i = 0; i < u_NumLights && i < 8; ++i)
-    {
-        FragPosLightSpace[i] = u_LightSpaceMatrices[i] * worldPos;
-    }
+    FragTangent = normalize(mat3(model) * localTangent);
 
     gl_Position = u_MVP * worldPos;
 }
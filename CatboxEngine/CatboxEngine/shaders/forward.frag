@@ -1,5 +0,0 @@
-#version 120
-
-void main() {
-    gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);
-}
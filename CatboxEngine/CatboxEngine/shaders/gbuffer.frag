@@ -1,5 +1,87 @@
-#version 120
+#version 440 core
+// Deferred geometry pass: writes surface inputs for lighting.frag
+// (layout documented in graphics/passes/GBufferPass.h)
 
-void main() {
-    gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);
+in vec2 TexCoord;
+in vec3 FragNormal;
+in vec3 FragTangent;
+in vec3 FragPos;
+in float ViewDepth;
+
+layout (location = 0) out vec4 GAlbedo;
+layout (location = 1) out vec4 GNormal;
+layout (location = 2) out vec4 GMaterial;
+
+// Material properties (same uniforms as FragmentShader.frag)
+uniform vec3 u_DiffuseColor;
+uniform sampler2D u_DiffuseMap;
+uniform bool u_HasDiffuseMap;
+
+uniform vec3 u_SpecularColor;
+uniform sampler2D u_SpecularMap;
+uniform bool u_HasSpecularMap;
+
+uniform float u_Shininess;
+
+uniform sampler2D u_NormalMap;
+uniform bool u_HasNormalMap;
+
+// GBufferPass::SHININESS_SCALE
+#define SHININESS_SCALE 256.0
+
+void main()
+{
+    // Sample albedo/diffuse color
+    vec3 albedo = u_DiffuseColor;
+    if (u_HasDiffuseMap)
+    {
+        vec4 texColor = texture(u_DiffuseMap, TexCoord);
+        // Black material colour means "texture only", otherwise tint
+        if (length(u_DiffuseColor) < 0.1)
+        {
+            albedo = texColor.rgb;
+        }
+        else
+        {
+            albedo *= texColor.rgb;
+        }
+    }
+    
+    // Sample specular
+    vec3 specularColor = u_SpecularColor;
+    if (u_HasSpecularMap)
+    {
+        specularColor *= texture(u_SpecularMap, TexCoord).r;
+    }
+    
+    // Normal mapping
+    vec3 N = normalize(FragNormal);
+    if (u_HasNormalMap)
+    {
+        // x and y only (BC5 normal maps carry no z), z rebuilt from them
+        vec2 xy = texture(u_NormalMap, TexCoord).rg * 2.0 - 1.0;  // [0,1] -> [-1,1]
+        vec3 normalMap = vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+        
+        vec3 T = FragTangent;
+        if (length(T) > 0.001)
+        {
+            // Re-orthogonalize TBN matrix using Gram-Schmidt process
+            T = normalize(T);
+            T = normalize(T - dot(T, N) * N);
+            vec3 B = cross(N, T);
+            N = normalize(mat3(T, B, N) * normalMap);
+        }
+        else
+        {
+            // No tangent data: arbitrary tangent space, reduced strength (as forward)
+            vec3 up = abs(N.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+            vec3 T_gen = normalize(cross(up, N));
+            vec3 B_gen = cross(N, T_gen);
+            N = normalize(N + mat3(T_gen, B_gen, N) * normalMap * 0.5);
+        }
+    }
+    
+    GAlbedo = vec4(albedo, 1.0);
+    GNormal = vec4(N, 1.0);
+    GMaterial = vec4(clamp(specularColor, 0.0, 1.0), clamp(u_Shininess / SHININESS_SCALE, 0.0, 1.0));
 }
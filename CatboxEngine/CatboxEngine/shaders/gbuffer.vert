@@ -1,5 +0,0 @@
-#version 120
-
-void main() {
-    gl_Position = vec4(vec3(0.0), 1.0);
-}
@@ -1,5 +1,197 @@
-#version 120
+#version 440 core
+// Deferred lighting pass: shades each G-buffer pixel once. Lights are read
+// from storage buffers, pre-binned per screen tile by LightingPass.
 
-void main() {
-    gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);
+// Screen tile size in pixels (LightingPass::TILE_SIZE)
+#define TILE_SIZE 16
+
+// Shadow atlas tiles per frame (ShadowTileTable::MAX_TILES)
+#define MAX_SHADOW_TILES 32
+
+// GBufferPass::SHININESS_SCALE
+#define SHININESS_SCALE 256.0
+
+in vec2 ScreenUV;
+out vec4 FragColor;
+
+// G-buffer
+uniform sampler2D u_GAlbedo;
+uniform sampler2D u_GNormal;
+uniform sampler2D u_GMaterial;
+uniform sampler2D u_GDepth;
+
+// Camera
+uniform mat4 u_View;
+uniform mat4 u_InvViewProj;
+uniform vec3 u_CameraPos;
+
+// Tiles per row; index of the list holding lights that reach every pixel
+uniform int u_TilesX;
+uniform int u_GlobalTile;
+
+struct GPULight {
+    vec4 positionRange;    // xyz position, w = range
+    vec4 directionType;    // xyz direction, w = 0 Directional, 1 Point, 2 Spot
+    vec4 colorIntensity;   // rgb color, w = intensity
+    vec4 attenuation;      // constant, linear, quadratic, shadow bias
+    vec4 spot;             // cos inner, cos outer, first shadow tile (-1 = none), cascade count
+    vec4 cascadeSplits;    // Far view depth of each cascade
+};
+
+layout(std430, binding = 0) readonly buffer LightBuffer { GPULight u_LightData[]; };
+layout(std430, binding = 1) readonly buffer TileBuffer { uvec2 u_TileLists[]; };  // offset, count
+layout(std430, binding = 2) readonly buffer LightIndexBuffer { uint u_LightIndices[]; };
+
+// Shadow atlas: every light's maps are tiles of one depth texture
+uniform sampler2D u_ShadowAtlas;
+uniform mat4 u_ShadowMatrices[MAX_SHADOW_TILES];
+uniform vec4 u_ShadowRects[MAX_SHADOW_TILES];  // xy = offset, zw = scale in atlas UVs
+
+// Rebuilt from depth in main()
+vec3 FragPos;
+float ViewDepth;
+
+// 2x2 PCF inside one atlas tile (as FragmentShader.frag)
+float SampleShadowTile(int tile, float bias)
+{
+    vec4 fragPosLightSpace = u_ShadowMatrices[tile] * vec4(FragPos, 1.0);
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+    projCoords = projCoords * 0.5 + 0.5;
+
+    // Outside shadow map frustum
+    if (projCoords.z > 1.0 || any(lessThan(projCoords.xy, vec2(0.0))) || any(greaterThan(projCoords.xy, vec2(1.0))))
+        return 0.0;
+
+    float currentDepth = projCoords.z;
+
+    vec4 rect = u_ShadowRects[tile];
+    vec2 texelSize = 1.0 / vec2(textureSize(u_ShadowAtlas, 0));
+    vec2 uv = rect.xy + projCoords.xy * rect.zw;
+
+    // Keep the filter footprint inside the tile so neighbours never bleed in
+    vec2 uvMin = rect.xy + 0.5 * texelSize;
+    vec2 uvMax = rect.xy + rect.zw - 0.5 * texelSize;
+
+    float shadow = 0.0;
+    for(int x = 0; x <= 1; ++x)
+    {
+        for(int y = 0; y <= 1; ++y)
+        {
+            vec2 sampleUV = clamp(uv + vec2(x, y) * texelSize, uvMin, uvMax);
+            float pcfDepth = texture(u_ShadowAtlas, sampleUV).r;
+            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
+        }
+    }
+    return shadow / 4.0;
+}
+
+float CalculateShadow(GPULight light, vec3 normal, vec3 lightDir)
+{
+    int firstTile = int(light.spot.z);
+    if (firstTile < 0)
+        return 0.0;
+
+    float shadowBias = light.attenuation.w;
+    float bias = max(shadowBias * (1.0 - dot(normal, lightDir)), shadowBias * 0.1);
+
+    int cascadeCount = int(light.spot.w);
+    if (cascadeCount == 0)
+        return SampleShadowTile(firstTile, bias);
+
+    // Cascaded: pick the slice by view depth
+    int cascade = 0;
+    while (cascade < cascadeCount - 1 && ViewDepth > light.cascadeSplits[cascade])
+        ++cascade;
+
+    // Beyond the shadow distance
+    if (ViewDepth > light.cascadeSplits[cascadeCount - 1])
+        return 0.0;
+
+    bias *= float(cascade + 1);
+    return SampleShadowTile(firstTile + cascade, bias);
+}
+
+// Blinn-Phong, matching CalculateLight in FragmentShader.frag
+vec3 CalculateLight(GPULight light, vec3 normal, vec3 viewDir, vec3 albedo, vec3 specular, float shininess)
+{
+    int type = int(light.directionType.w);
+    vec3 lightDir;
+    float attenuation = 1.0;
+
+    if (type == 0) // Directional
+    {
+        lightDir = normalize(-light.directionType.xyz);
+    }
+    else
+    {
+        vec3 lightVec = light.positionRange.xyz - FragPos;
+        float distance = length(lightVec);
+
+        // Beyond the range the light was binned with
+        if (light.positionRange.w > 0.0 && distance > light.positionRange.w)
+            return vec3(0.0);
+
+        lightDir = lightVec / max(distance, 1e-4);
+        attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance +
+                             light.attenuation.z * distance * distance);
+
+        if (type == 2) // Spot cone
+        {
+            float theta = dot(lightDir, normalize(-light.directionType.xyz));
+            float epsilon = light.spot.x - light.spot.y;
+            attenuation *= clamp((theta - light.spot.y) / epsilon, 0.0, 1.0);
+        }
+    }
+
+    if (attenuation <= 0.0)
+        return vec3(0.0);
+
+    // Same softened shadows as the forward path
+    float shadow = clamp(CalculateShadow(light, normal, lightDir) * 0.4, 0.0, 1.0);
+
+    vec3 radiance = light.colorIntensity.rgb * light.colorIntensity.w * attenuation;
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
+
+    return (radiance * diff * albedo + radiance * spec * specular) * (1.0 - shadow);
+}
+
+void main()
+{
+    vec4 normalSample = texture(u_GNormal, ScreenUV);
+    float depth = texture(u_GDepth, ScreenUV).r;
+
+    // Nothing was drawn here; leave it for the skybox
+    if (normalSample.w == 0.0)
+        discard;
+
+    vec4 clipPos = vec4(ScreenUV * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 worldPos = u_InvViewProj * clipPos;
+    FragPos = worldPos.xyz / worldPos.w;
+    ViewDepth = -(u_View * vec4(FragPos, 1.0)).z;
+
+    vec3 N = normalize(normalSample.xyz);
+    vec3 albedo = texture(u_GAlbedo, ScreenUV).rgb;
+    vec4 material = texture(u_GMaterial, ScreenUV);
+    float shininess = material.a * SHININESS_SCALE;
+    vec3 V = normalize(u_CameraPos - FragPos);
+
+    // Same ambient term as FragmentShader.frag
+    vec3 lighting = 0.05 * albedo;
+
+    // Lights binned to this tile, then the ones that reach everywhere
+    ivec2 tile = ivec2(gl_FragCoord.xy) / TILE_SIZE;
+    uvec2 lists[2] = uvec2[2](u_TileLists[tile.y * u_TilesX + tile.x], u_TileLists[u_GlobalTile]);
+    for (int l = 0; l < 2; ++l)
+    {
+        for (uint i = 0u; i < lists[l].y; ++i)
+        {
+            uint lightIndex = u_LightIndices[lists[l].x + i];
+            lighting += CalculateLight(u_LightData[lightIndex], N, V, albedo, material.rgb, shininess);
+        }
+    }
+
+    FragColor = vec4(lighting, 1.0);
+    gl_FragDepth = depth;
 }
@@ -1,5 +1,12 @@
-#version 120
+#version 440 core
+// Full-screen triangle for the deferred lighting pass; no vertex buffer,
+// corners come from gl_VertexID: (-1,-1), (3,-1), (-1,3)
 
-void main() {
-    gl_Position = vec4(vec3(0.0), 1.0);
+out vec2 ScreenUV;
+
+void main()
+{
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    ScreenUV = pos * 0.5 + 0.5;
+    gl_Position = vec4(pos, 0.0, 1.0);
 }
@@ -4,7 +4,7 @@
 #include "../../resources/Entity.h"
 #include "../../graphics/MeshManager.h"
 #include "../../graphics/Mesh.h"
-#include "../../graphics/GraphicsSettings.h"
+#include "../../graphics/TextureManager.h"
 #include "../../gameplay/TerrainSystem.h"
 #include "../../Dependencies/stb_image.h"
 #include "imgui.h"
@@ -18,9 +18,6 @@ namespace
 {
     constexpr int ENTITY_LIST_HEIGHT = 200;
     constexpr float DELETE_BUTTON_WIDTH = 90.0f;
-    constexpr int DIFFUSE_CHANNELS = 4;
-    constexpr int SPECULAR_CHANNELS = 1;
-    constexpr int NORMAL_CHANNELS = 4;
 }
 
 void EntityManagerInspector::Draw(EntityManager& entityManager, Vec3& spawnPosition, Vec3& spawnScale,
@@ -435,13 +432,40 @@ void EntityManagerInspector::DrawEntityInfo(Entity& entity)
         }
         ImGui::SetItemTooltip("Greyscale PNG used as heightmap. Leave empty for procedural rolling hills.");
 
-        ImGui::SliderInt("Grid Width",  &entity.TerrainGridWidth,  4, 256);
-        ImGui::SliderInt("Grid Depth",  &entity.TerrainGridDepth,  4, 256);
-        ImGui::SetItemTooltip("Mesh subdivision count. Higher = more detail but more vertices.");
+        ImGui::SliderInt("Grid Width",  &entity.TerrainGridWidth,  4, 2048);
+        ImGui::SliderInt("Grid Depth",  &entity.TerrainGridDepth,  4, 2048);
+        ImGui::SetItemTooltip("Full-detail cell count. Distant chunks are drawn coarser, so large grids stay cheap.");
+        if (entity.TerrainHeightDataWidth > 1 && !entity.TerrainHeightmapPath.empty())
+        {
+            if (ImGui::Button("Match Heightmap"))
+            {
+                entity.TerrainGridWidth = entity.TerrainHeightDataWidth - 1;
+                entity.TerrainGridDepth = entity.TerrainHeightDataDepth - 1;
+            }
+            ImGui::SetItemTooltip("One cell per heightmap texel.");
+        }
 
         if (ImGui::Button("Regenerate Terrain"))
             TerrainSystem::GenerateTerrainMesh(entity);
         ImGui::SetItemTooltip("Rebuild the terrain mesh from the current heightmap / settings.");
+
+        // Height brush: edits the live terrain in place
+        static float s_brushU = 0.5f;
+        static float s_brushV = 0.5f;
+        static int   s_brushRadius = 4;
+        static float s_brushStrength = 0.02f;
+        ImGui::Text("Height Brush");
+        ImGui::SliderFloat("Brush X", &s_brushU, 0.0f, 1.0f);
+        ImGui::SliderFloat("Brush Z", &s_brushV, 0.0f, 1.0f);
+        ImGui::SliderInt("Brush Radius", &s_brushRadius, 1, 64);
+        ImGui::SetItemTooltip("In grid cells.");
+        ImGui::SliderFloat("Brush Strength", &s_brushStrength, 0.001f, 0.1f);
+        if (ImGui::Button("Raise"))
+            TerrainSystem::SculptHeights(entity, s_brushU, s_brushV, s_brushRadius, s_brushStrength);
+        ImGui::SameLine();
+        if (ImGui::Button("Lower"))
+            TerrainSystem::SculptHeights(entity, s_brushU, s_brushV, s_brushRadius, -s_brushStrength);
+        ImGui::SetItemTooltip("Brush edits are not saved with the scene; Regenerate Terrain discards them.");
     }
 
     // Collision
@@ -449,6 +473,9 @@ void EntityManagerInspector::DrawEntityInfo(Entity& entity)
     ImGui::Separator();
     ImGui::Checkbox("Collides With Player", &entity.CollidesWithPlayer);
     ImGui::SetItemTooltip("When unchecked, the player passes through this entity. Disable for spawn points, teleporters, and goals.");
+
+    ImGui::Checkbox("Occluder", &entity.IsOccluder);
+    ImGui::SetItemTooltip("Always used for occlusion culling when on screen. Tag large solid walls and islands\nthat hide other geometry; big meshes are also picked automatically.");
 }
 
 void EntityManagerInspector::DrawEntityTransform(Entity& entity)
@@ -480,6 +507,20 @@ void EntityManagerInspector::DrawEntityMesh(Entity& entity)
     ImGui::TextColored(ImVec4(0.2f, 1.0f, 0.2f, 1.0f), "Loaded: [%s]", meshDisplayName.c_str());
     ImGui::Text("Vertices: %zu", mesh->Vertices.size());
 
+    // Per-entity blend shape weights, starting from the mesh's defaults
+    if (!mesh->MorphTargets.empty() && ImGui::TreeNode("Morph Targets"))
+    {
+        for (size_t t = entity.MorphWeights.size(); t < mesh->MorphTargets.size(); ++t)
+            entity.MorphWeights.push_back(mesh->MorphTargets[t].Weight);
+        for (size_t t = 0; t < mesh->MorphTargets.size(); ++t)
+        {
+            ImGui::PushID((int)t);
+            ImGui::SliderFloat(mesh->MorphTargets[t].Name.c_str(), &entity.MorphWeights[t], 0.0f, 1.0f);
+            ImGui::PopID();
+        }
+        ImGui::TreePop();
+    }
+
     if (ImGui::Button("Change Mesh"))
     {
         char buf[1024] = {0};
@@ -535,10 +576,9 @@ void EntityManagerInspector::DrawTextureOverride(Entity& entity, TextureType typ
         const char* label;
         const char* tag;
         bool& hasOverride;
-        unsigned int& texture;
+        TextureRef& texture;
         std::string& path;
-        int channels;
-        GLenum format;
+        TextureUsage usage;
     };
 
     TextureInfo info = [&]() -> TextureInfo
@@ -548,19 +588,19 @@ void EntityManagerInspector::DrawTextureOverride(Entity& entity, TextureType typ
             case TextureType::Diffuse:
                 return {"Diffuse", "##Diffuse", entity.HasDiffuseTextureOverride, 
                         entity.DiffuseTexture, entity.DiffuseTexturePath, 
-                        DIFFUSE_CHANNELS, GL_RGBA};
+                        TextureUsage::Color};
             case TextureType::Specular:
                 return {"Specular", "##Specular", entity.HasSpecularTextureOverride,
                         entity.SpecularTexture, entity.SpecularTexturePath,
-                        SPECULAR_CHANNELS, GL_RED};
+                        TextureUsage::Mask};
             case TextureType::Normal:
                 return {"Normal", "##Normal", entity.HasNormalTextureOverride,
                         entity.NormalTexture, entity.NormalTexturePath,
-                        NORMAL_CHANNELS, GL_RGBA};
+                        TextureUsage::Normal};
             default:
                 return {"Unknown", "##Unknown", entity.HasDiffuseTextureOverride,
                         entity.DiffuseTexture, entity.DiffuseTexturePath,
-                        DIFFUSE_CHANNELS, GL_RGBA};
+                        TextureUsage::Color};
         }
     }();
 
@@ -572,11 +612,7 @@ void EntityManagerInspector::DrawTextureOverride(Entity& entity, TextureType typ
         std::string buttonLabel = std::string("Remove Override") + info.tag;
         if (ImGui::Button(buttonLabel.c_str()))
         {
-            if (info.texture != 0)
-            {
-                glDeleteTextures(1, &info.texture);
-                info.texture = 0;
-            }
+            info.texture.Reset();
             info.hasOverride = false;
             info.path = "";
         }
@@ -592,12 +628,11 @@ void EntityManagerInspector::DrawTextureOverride(Entity& entity, TextureType typ
             if (Platform::OpenFileDialog(buf, sizeof(buf),
                 "Image Files\0*.png;*.jpg;*.jpeg;*.bmp;*.tga\0All\0*.*\0"))
             {
-                int width, height;
-                unsigned int tex = LoadTextureWithSettings(buf, width, height, info.channels);
+                unsigned int tex = LoadTextureWithSettings(buf, info.usage);
                 
                 if (tex != 0)
                 {
-                    info.texture = tex;
+                    info.texture = TextureRef(tex);
                     info.path = buf;
                     info.hasOverride = true;
                 }
@@ -606,35 +641,14 @@ void EntityManagerInspector::DrawTextureOverride(Entity& entity, TextureType typ
     }
 }
 
-unsigned int EntityManagerInspector::LoadTextureWithSettings(const char* path, int& width, int& height, int channels)
+unsigned int EntityManagerInspector::LoadTextureWithSettings(const char* path, TextureUsage usage)
 {
     // Match OBJ loader behavior - don't flip for manually loaded textures
     // This ensures consistency with how the model's UVs were exported
     stbi_set_flip_vertically_on_load(false);
-    
-    int actualChannels;
-    unsigned char* data = stbi_load(path, &width, &height, &actualChannels, channels);
-    
-    if (!data)
-        return 0;
-
-    unsigned int tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
-
-    GLenum format = (channels == 1) ? GL_RED : GL_RGBA;
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-
-    // Apply graphics settings
-    auto& settings = GraphicsSettings::Instance();
-    if (settings.EnableMipmaps)
-    {
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    settings.ApplyToTexture(tex);
 
-    stbi_image_free(data);
-    return tex;
+    // Shared with every entity and mesh already using this file
+    return TextureManager::Instance().Load(path, usage);
 }
 
 void EntityManagerInspector::DrawTextureAssignmentPopup(EntityManager& entityManager, int selectedIndex)
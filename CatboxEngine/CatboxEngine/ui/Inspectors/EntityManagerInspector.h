@@ -5,6 +5,7 @@
 class EntityManager;
 class Camera;
 class Entity;
+enum class TextureUsage;
 
 class EntityManagerInspector
 {
@@ -43,7 +44,7 @@ private:
     // Texture management helpers
     enum class TextureType { Diffuse, Specular, Normal };
     void DrawTextureOverride(Entity& entity, TextureType type);
-    unsigned int LoadTextureWithSettings(const char* path, int& width, int& height, int channels);
+    unsigned int LoadTextureWithSettings(const char* path, TextureUsage usage);
     
     // Popups
     void DrawTextureAssignmentPopup(EntityManager& entityManager, int selectedIndex);
@@ -75,6 +75,26 @@ void GraphicsSettingsInspector::Draw()
         ImGui::SetTooltip("Limits how many mipmap levels to use.\nLower = better performance, higher = better quality at distance.");
     }
     
+    ImGui::Spacing();
+    
+    // Block compression (TextureCooker)
+    if (ImGui::Checkbox("Compress Textures", &settings.CompressTextures))
+    {
+        mipmapsChanged = true;
+    }
+    if (ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("Use BCn textures cooked in the background and cached in cache/textures.\n4-8x less texture memory. The first load of a new texture is uncompressed.");
+    }
+    if (settings.CompressTextures && ImGui::Checkbox("High Quality Compression", &settings.HighQualityCompression))
+    {
+        mipmapsChanged = true;
+    }
+    if (settings.CompressTextures && ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("Colour textures as BC7 instead of BC1/BC3.\nSharper colour gradients, twice the memory of BC1.");
+    }
+    
     ImGui::Spacing();
     ImGui::Separator();
     
@@ -95,6 +115,7 @@ void GraphicsSettingsInspector::Draw()
         ImGui::Text("Mag Filter: %s", GetFilterModeName(settings.MagFilter));
         ImGui::Text("Anisotropic: %.0fx", settings.AnisotropicFiltering);
         ImGui::Text("Max Mip Level: %d", settings.MaxMipmapLevel);
+        ImGui::Text("Compression: %s", !settings.CompressTextures ? "Off" : (settings.HighQualityCompression ? "BC7" : "BC1/BC3"));
     }
 
     ImGui::Spacing();
@@ -153,6 +174,81 @@ void GraphicsSettingsInspector::Draw()
         }
     }
 
+    // ---- Rendering ----
+    if (ImGui::CollapsingHeader("Rendering", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        const char* renderPaths[] = { "Forward", "Deferred (Tiled)" };
+        int currentPath = static_cast<int>(settings.Path);
+        if (ImGui::Combo("Render Path", &currentPath, renderPaths, 2))
+        {
+            settings.Path = static_cast<RenderPath>(currentPath);
+        }
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Forward shades while drawing, each fragment against the lights of its 3D cluster.\nDeferred writes a G-buffer and lights every pixel once,\nwith lights binned into 16x16 pixel screen tiles.");
+        }
+
+        if (settings.Path == RenderPath::Forward)
+        {
+            ImGui::Checkbox("Depth Pre-pass", &settings.DepthPrepass);
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Draw depth only first, then shade just the visible surface of each pixel.\nHelps levels with lots of overlapping geometry; compare the opaque GPU times under Statistics.");
+            }
+        }
+
+        ImGui::Checkbox("Render Thread", &settings.ThreadedRendering);
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Draw on a separate thread while the next frame is simulated (one frame of latency).\nTurn off to update and render one after the other, e.g. when debugging GL calls.");
+        }
+
+        ImGui::Checkbox("Occlusion Culling", &settings.OcclusionCulling);
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Rasterize the largest on-screen meshes (and entities tagged Occluder)\ninto a small CPU depth buffer and skip entities hidden behind them.");
+        }
+
+        ImGui::Checkbox("Mesh LOD", &settings.MeshLOD);
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Draw simplified versions of imported meshes as they get smaller on screen.");
+        }
+        if (settings.MeshLOD)
+        {
+            ImGui::SliderFloat("LOD Bias", &settings.LODBias, 0.25f, 4.0f, "%.2f");
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Higher keeps full detail further away; lower switches to simpler levels sooner.");
+            }
+        }
+
+        ImGui::Checkbox("Show Bounds", &settings.DebugDrawBounds);
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Draw each entity's bounding box: green when the camera sees it,\nred when frustum or occlusion culling skipped it.");
+        }
+    }
+
+    // ---- Shadows ----
+    if (ImGui::CollapsingHeader("Shadows"))
+    {
+        ImGui::Checkbox("Cache Shadow Maps", &settings.ShadowCaching);
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Only redraw a shadow map when its light or a caster inside it changes.\nStatic casters are kept in a separate copy; moving ones are drawn on top.");
+        }
+
+        if (settings.ShadowCaching)
+        {
+            ImGui::SliderInt("Distant Updates / Frame", &settings.ShadowUpdateBudget, 1, 16);
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Distant lights and far cascades take turns updating,\nthis many per frame.");
+            }
+        }
+    }
+
     ImGui::End();
 }
 
@@ -239,55 +239,8 @@ void LightInspector::DrawLightProperties()
     // Shadows
     if (ImGui::TreeNode("Shadows"))
     {
-        bool castsShadows = light.CastsShadows;
-        if (ImGui::Checkbox("Cast Shadows", &castsShadows))
-        {
-            light.CastsShadows = castsShadows;
-            
-            if (castsShadows && light.ShadowMapFBO == 0)
-            {
-                // Create shadow map
-                glGenFramebuffers(1, &light.ShadowMapFBO);
-                glGenTextures(1, &light.ShadowMapTexture);
-                
-                glBindTexture(GL_TEXTURE_2D, light.ShadowMapTexture);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
-                            light.ShadowMapSize, light.ShadowMapSize, 0,
-                            GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-                
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-                float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-                glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-                
-                glBindFramebuffer(GL_FRAMEBUFFER, light.ShadowMapFBO);
-                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                                      GL_TEXTURE_2D, light.ShadowMapTexture, 0);
-                
-                glDrawBuffer(GL_NONE);
-                glReadBuffer(GL_NONE);
-                
-                if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-                {
-                    std::cerr << "ERROR: Shadow framebuffer incomplete!" << std::endl;
-                }
-                
-                glBindFramebuffer(GL_FRAMEBUFFER, 0);
-                
-                std::cout << "Shadow map created for " << light.Name << std::endl;
-            }
-            else if (!castsShadows && light.ShadowMapFBO != 0)
-            {
-                glDeleteFramebuffers(1, &light.ShadowMapFBO);
-                glDeleteTextures(1, &light.ShadowMapTexture);
-                light.ShadowMapFBO = 0;
-                light.ShadowMapTexture = 0;
-                
-                std::cout << "Shadow map destroyed for " << light.Name << std::endl;
-            }
-        }
+        // Atlas tiles are assigned by LightManager::UpdateShadowResources
+        ImGui::Checkbox("Cast Shadows", &light.CastsShadows);
         
         if (light.CastsShadows)
         {
@@ -306,11 +259,30 @@ void LightInspector::DrawLightProperties()
             
             ImGui::SliderFloat("Shadow Bias", &light.ShadowBias, 0.0001f, 0.01f, "%.4f");
             
+            // Tiles are sized from screen coverage, up to the resolution above
+            if (light.ShadowTileCount > 0)
+                ImGui::Text("Atlas tile: %d px (importance %.2f)", light.ShadowTiles[0].Size, light.ShadowImportance);
+            else
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "No atlas tile (off screen or atlas full)");
+            
             if (light.Type == LightType::Directional)
             {
-                ImGui::SliderFloat("Ortho Size", &light.ShadowOrthoSize, 1.0f, 100.0f);
-                ImGui::SliderFloat("Near Plane", &light.ShadowNearPlane, 0.1f, 10.0f);
-                ImGui::SliderFloat("Far Plane", &light.ShadowFarPlane, 10.0f, 200.0f);
+                ImGui::SliderInt("Cascades", &light.CascadeCount, 0, MAX_SHADOW_CASCADES);
+                if (light.UsesCascades())
+                {
+                    ImGui::SliderFloat("Shadow Distance", &light.ShadowDistance, 5.0f, 500.0f);
+                    ImGui::SliderFloat("Split Lambda", &light.CascadeSplitLambda, 0.0f, 1.0f);
+                    ImGui::SliderFloat("Caster Range", &light.CascadeCasterRange, 0.0f, 200.0f);
+                    
+                    for (int c = 0; c < light.ShadowTileCount; ++c)
+                        ImGui::Text("Cascade %d: up to %.1f units", c, light.CascadeSplits[c]);
+                }
+                else
+                {
+                    ImGui::SliderFloat("Ortho Size", &light.ShadowOrthoSize, 1.0f, 100.0f);
+                    ImGui::SliderFloat("Near Plane", &light.ShadowNearPlane, 0.1f, 10.0f);
+                    ImGui::SliderFloat("Far Plane", &light.ShadowFarPlane, 10.0f, 200.0f);
+                }
             }
             else
             {
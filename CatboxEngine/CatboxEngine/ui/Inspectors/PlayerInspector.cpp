@@ -254,6 +254,12 @@ void PlayerInspector::DrawAnimationSettings(PlayerController& playerController,
     ImGui::TextColored(ImVec4(0.3f, 1.0f, 0.3f, 1.0f),
         "Skeleton: %zu bones", mesh->MeshSkeleton.Bones.size());
 
+    ImGui::Checkbox("Dual Quaternion Skinning", &mesh->DualQuaternionSkinning);
+    ImGui::SetItemTooltip("Blend bones as dual quaternions: half the palette size and no\n"
+                          "collapsing joints. Poses with scaled bones use matrices.");
+    if (mesh->DualQuaternionSkinning && player->BoneDualQuats.empty() && !player->BoneMatrices.empty())
+        ImGui::TextDisabled("Bones are scaled: using matrix skinning");
+
     ImGui::Text("Assign .fbx animation files for each state:");
     ImGui::Spacing();
 
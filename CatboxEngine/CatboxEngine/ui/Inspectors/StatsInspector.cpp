@@ -2,6 +2,8 @@
 #include "../../resources/EntityManager.h"
 #include "../../resources/SceneManager.h"
 #include "../../graphics/MeshManager.h"
+#include "../../graphics/TextureManager.h"
+#include "../../graphics/RenderPipeline.h"
 #include "../../core/MemoryTracker.h"
 #include "imgui.h"
 #include <iostream>
@@ -17,13 +19,19 @@ namespace
     constexpr int DECIMAL_PRECISION = 2;
 }
 
-void StatsInspector::Draw(float deltaTime, EntityManager& entityManager)
+void StatsInspector::Draw(float deltaTime, EntityManager& entityManager, const RenderStats* renderStats)
 {
     ImGui::Begin("Statistics");
 
     DrawTimingStats(deltaTime);
     
     ImGui::Separator();
+
+    if (renderStats)
+    {
+        DrawGPUTimings(*renderStats);
+        ImGui::Separator();
+    }
     
     DrawMemoryStats(entityManager);
 
@@ -39,6 +47,24 @@ void StatsInspector::DrawTimingStats(float deltaTime)
     ImGui::Text("FPS: %.1f", 1.0f / deltaTime);
 }
 
+void StatsInspector::DrawGPUTimings(const RenderStats& renderStats)
+{
+    ImGui::Text("GPU Passes");
+    ImGui::Spacing();
+
+    ImGui::Text("Shadows: %.3f ms", renderStats.ShadowPassTime);
+    ImGui::Text("Depth Pre-pass: %.3f ms", renderStats.DepthPrepassTime);
+    ImGui::Text("Opaque: %.3f ms", renderStats.MainPassTime);
+    ImGui::Text("Lighting: %.3f ms", renderStats.LightPassTime);
+
+    ImGui::Spacing();
+
+    // Forward path: the last opaque cost measured in each pre-pass mode
+    ImGui::Text("Opaque without pre-pass: %.3f ms", renderStats.OpaqueTimeWithoutPrepass);
+    ImGui::Text("Opaque with pre-pass: %.3f ms", renderStats.OpaqueTimeWithPrepass);
+    ImGui::SetItemTooltip("Pre-pass plus opaque pass. Toggle Depth Pre-pass in Graphics Settings to measure both; 0 = not measured yet.");
+}
+
 void StatsInspector::DrawMemoryStats(EntityManager& entityManager)
 {
     ImGui::Text("Memory");
@@ -55,6 +81,13 @@ void StatsInspector::DrawMemoryStats(EntityManager& entityManager)
 
     ImGui::Spacing();
 
+    // Texture memory (each shared texture counted once)
+    auto& texMgr = TextureManager::Instance();
+    ImGui::Text("Textures: %zu (%zu references)", texMgr.GetTextureCount(), texMgr.GetReferenceCount());
+    ImGui::Text("GPU: %.2f MB", texMgr.GetTotalGPUMemory() * BYTES_TO_MB);
+
+    ImGui::Spacing();
+
 #if TRACK_MEMORY
     auto& memTracker = MemoryTracker::Instance();
     ImGui::Text("Tracked: %.2f MB", memTracker.GetCurrentUsage() * BYTES_TO_MB);
@@ -105,6 +138,14 @@ void StatsInspector::PrintMemoryReport(EntityManager& entityManager)
     std::cout << "Total Memory:   " << std::fixed << std::setprecision(DECIMAL_PRECISION) << (meshCPU + meshGPU) << " MB" << std::endl;
     std::cout << "===================\n" << std::endl;
 
+    // Texture memory
+    auto& texMgr = TextureManager::Instance();
+    std::cout << "=== TEXTURE MEMORY ===" << std::endl;
+    std::cout << "Texture Count:  " << texMgr.GetTextureCount() << std::endl;
+    std::cout << "References:     " << texMgr.GetReferenceCount() << std::endl;
+    std::cout << "GPU Memory:     " << std::fixed << std::setprecision(DECIMAL_PRECISION) << texMgr.GetTotalGPUMemory() * BYTES_TO_MB << " MB" << std::endl;
+    std::cout << "======================\n" << std::endl;
+
     // Scene memory
     auto& sceneMgr = SceneManager::Instance();
     std::cout << "=== SCENE MEMORY ===" << std::endl;
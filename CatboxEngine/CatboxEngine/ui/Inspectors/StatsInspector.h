@@ -1,6 +1,7 @@
 #pragma once
 
 class EntityManager;
+struct RenderStats;
 
 class StatsInspector
 {
@@ -14,10 +15,12 @@ public:
     StatsInspector(StatsInspector&&) noexcept = default;
     StatsInspector& operator=(StatsInspector&&) noexcept = default;
 
-    void Draw(float deltaTime, EntityManager& entityManager);
+    // renderStats: the last frame drawn, or nullptr to skip the GPU timings
+    void Draw(float deltaTime, EntityManager& entityManager, const RenderStats* renderStats);
 
 private:
     void DrawTimingStats(float deltaTime);
+    void DrawGPUTimings(const RenderStats& renderStats);
     void DrawMemoryStats(EntityManager& entityManager);
     void PrintMemoryReport(EntityManager& entityManager);
 };